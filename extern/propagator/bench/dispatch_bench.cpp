@@ -0,0 +1,193 @@
+/**
+ * @file dispatch_bench.cpp
+ * @brief Microbenchmark of the propagation engine advisor dispatch
+ *
+ * Builds a random pure binary problem (cardinality, knapsack and general linear rows),
+ * then repeatedly rounds all variables in random order with propagation, as the
+ * propagation-based rounding of the feasibility pump does, once with the flattened
+ * dispatch and once calling the advisor objects. Both runs must produce the same fixings.
+ *
+ * Usage: dispatch_bench [ncols] [nrows] [rounds] [seed]
+ *
+ * @author Domenico Salvagnin dominiqs@gmail.com
+ * 2023
+ */
+
+#include <cstdlib>
+#include <cmath>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <utils/maths.h>
+#include <utils/randgen.h>
+#include <utils/timer.h>
+
+#include "propagator/domain.h"
+#include "propagator/prop_engine.h"
+
+using namespace dominiqs;
+
+static void makeRows(int n, int m, RandGen &rnd, std::vector<Constraint> &rows)
+{
+	rows.resize(m);
+	for (int i = 0; i < m; i++)
+	{
+		Constraint &c = rows[i];
+		c.name = fmt::format("r{}", i);
+		int len = 2 + (int)(rnd.getFloat() * 30);
+		std::vector<int> idx;
+		for (int k = 0; k < len; k++)
+			idx.push_back((int)(rnd.getFloat() * n) % n);
+		std::sort(idx.begin(), idx.end());
+		idx.erase(std::unique(idx.begin(), idx.end()), idx.end());
+		double sum = 0.0;
+		switch (i % 3)
+		{
+		case 0:
+			// set packing / covering
+			for (int j : idx)
+				c.row.push(j, 1.0);
+			c.sense = (rnd.getFloat() < 0.7) ? 'L' : 'G';
+			c.rhs = 1.0;
+			break;
+		case 1:
+			// knapsack
+			for (int j : idx)
+			{
+				double a = 1.0 + (int)(rnd.getFloat() * 20);
+				c.row.push(j, a);
+				sum += a;
+			}
+			c.sense = 'L';
+			c.rhs = std::floor(0.4 * sum);
+			break;
+		default:
+			// general linear
+			for (int j : idx)
+			{
+				double a = 1.0 + (int)(rnd.getFloat() * 10);
+				if (rnd.getFloat() < 0.4)
+					a = -a;
+				c.row.push(j, a);
+				sum += std::fabs(a);
+			}
+			c.sense = 'L';
+			c.rhs = std::floor(0.2 * sum);
+		}
+	}
+}
+
+struct Engine
+{
+	DomainPtr domain;
+	PropagationEngine prop;
+	StatePtr state;
+
+	void build(int n, const std::vector<Constraint> &rows)
+	{
+		domain = std::make_shared<Domain>();
+		for (int j = 0; j < n; j++)
+			domain->pushVar(fmt::format("x{}", j), 'B', 0.0, 1.0);
+		prop.setDomain(domain);
+		std::list<std::string> names;
+		PropagatorFactories::getInstance().getIDs(std::back_insert_iterator<std::list<std::string>>(names));
+		std::map<int, PropagatorFactoryPtr> factories;
+		for (const std::string &name : names)
+		{
+			PropagatorFactoryPtr f(PropagatorFactories::getInstance().create(name));
+			factories[f->getPriority()] = f;
+		}
+		for (const Constraint &c : rows)
+		{
+			for (auto &kv : factories)
+			{
+				PropagatorPtr p = kv.second->analyze(*domain, &c);
+				if (p)
+				{
+					prop.pushPropagator(p);
+					break;
+				}
+			}
+		}
+		state = prop.getStateMgr();
+		state->dump();
+	}
+};
+
+/** round all variables in the given orders, return the elapsed time and a checksum of the fixings */
+static double run(Engine &e, const std::vector<std::vector<int>> &orders, const std::vector<std::vector<char>> &values, uint64_t &checksum)
+{
+	StopWatch watch(true);
+	checksum = 0;
+	for (unsigned int r = 0; r < orders.size(); r++)
+	{
+		e.state->restore();
+		for (int j : orders[r])
+		{
+			if (e.domain->isVarFixed(j))
+				continue;
+			e.prop.propagate(j, values[r][j]);
+		}
+		for (unsigned int j = 0; j < e.domain->size(); j++)
+			checksum = checksum * 31 + (uint64_t)(e.domain->varLb(j) + 2.0 * e.domain->varUb(j));
+		checksum = checksum * 31 + e.prop.failed();
+	}
+	return watch.getElapsed();
+}
+
+int main(int argc, char *argv[])
+{
+	int n = (argc > 1) ? std::atoi(argv[1]) : 100000;
+	int m = (argc > 2) ? std::atoi(argv[2]) : 50000;
+	int rounds = (argc > 3) ? std::atoi(argv[3]) : 20;
+	uint64_t seed = (argc > 4) ? std::atoi(argv[4]) : 1;
+
+	RandGen rnd(seed);
+	std::vector<Constraint> rows;
+	makeRows(n, m, rnd, rows);
+	std::vector<std::vector<int>> orders(rounds);
+	std::vector<std::vector<char>> values(rounds);
+	for (int r = 0; r < rounds; r++)
+	{
+		orders[r].resize(n);
+		values[r].resize(n);
+		for (int j = 0; j < n; j++)
+		{
+			orders[r][j] = j;
+			values[r][j] = (rnd.getFloat() < 0.5);
+		}
+		for (int j = n - 1; j > 0; j--)
+			std::swap(orders[r][j], orders[r][(int)(rnd.getFloat() * (j + 1)) % (j + 1)]);
+	}
+
+	Engine flat;
+	flat.build(n, rows);
+	Engine objects;
+	objects.build(n, rows);
+	objects.prop.flatDispatch = false;
+
+	uint64_t flatSum = 0;
+	uint64_t objSum = 0;
+	// warm up (caches, first propagation of the initially pending rows)
+	run(flat, {orders[0]}, {values[0]}, flatSum);
+	run(objects, {orders[0]}, {values[0]}, objSum);
+	double objTime = run(objects, orders, values, objSum);
+	double flatTime = run(flat, orders, values, flatSum);
+
+	fmt::print("cols = {} rows = {} rounds = {}\n", n, m, rounds);
+	fmt::print("advisor objects: {:.3f}s\n", objTime);
+	fmt::print("flat dispatch:   {:.3f}s\n", flatTime);
+	fmt::print("speedup:         {:.2f}x\n", (flatTime > 0.0) ? objTime / flatTime : 0.0);
+	if (flatSum != objSum)
+	{
+		fmt::print("ERROR: the two dispatch modes produced different fixings\n");
+		return EXIT_FAILURE;
+	}
+	fmt::print("fixings match\n");
+	return EXIT_SUCCESS;
+}
@@ -16,6 +16,22 @@
 class Propagator;
 class PropagationEngine;
 
+/**
+ * Advisor kinds the propagation engine knows how to dispatch without a virtual call
+ * (see PropagationEngine::buildDispatch). Any other advisor is GENERIC.
+ */
+
+enum AdvisorKind
+{
+	ADVISOR_GENERIC = 0,
+	ADVISOR_LINEAR_POS = 1,
+	ADVISOR_LINEAR_NEG = 2,
+	ADVISOR_KNAPSACK = 3,
+	ADVISOR_CARDINALITY = 4,
+	ADVISOR_CLIQUE = 5,
+	ADVISOR_IMPLICATION = 6
+};
+
 /**
  * @brief Propagator Advisor interface
  *
@@ -33,6 +49,13 @@ public:
 	//@{
 	inline Propagator& getPropagator() const { return prop; }
 	inline int getVar() const { return var; }
+	/**
+	 * kind and coefficient used by the engine flattened dispatch:
+	 * a non generic kind promises that the events are handled exactly by the
+	 * corresponding inline handlers of the propagator
+	 */
+	virtual AdvisorKind getKind() const { return ADVISOR_GENERIC; }
+	virtual double getCoef() const { return 0.0; }
 	//@}
 
 	//@{
@@ -0,0 +1,110 @@
+/**
+ * @file clique_propagator.h
+ * @brief Clique table propagator
+ *
+ * @author Domenico Salvagnin dominiqs@gmail.com
+ * 2023
+ */
+
+#ifndef CLIQUE_PROPAGATOR_H
+#define CLIQUE_PROPAGATOR_H
+
+#include <vector>
+
+#include "propagator.h"
+#include "advisors.h"
+
+/**
+ * @brief Propagator for a table of cliques of binary variables
+ *
+ * Each clique is a set packing (sum x_j <= 1) or set partitioning (sum x_j = 1)
+ * constraint. All the cliques of a domain live in a single propagator, so a variable
+ * has one advisor no matter how many cliques it belongs to:
+ * - fixing x_j to 1 fixes all its clique neighbors to 0, in time linear in the
+ *   number of neighbors;
+ * - fixing x_j to 0 is a no-op, unless x_j belongs to a partitioning clique, which is
+ *   then scanned to fix its last free variable to 1.
+ * Cliques are added by the CliqueFactory while analyzing the rows: the table is
+ * returned (and thus pushed to the engine) again after each new clique, and
+ * createAdvisors() only returns the advisors of the variables not seen before.
+ */
+
+class CliqueTableProp : public Propagator
+{
+public:
+	CliqueTableProp(Domain &d);
+	/**
+	 * Add the clique sum_{j in vars} x_j <= 1 (or = 1 if isEq)
+	 * Variables already fixed to 0 must still be listed for partitioning cliques.
+	 */
+	void addClique(const std::vector<int> &vars, bool isEq);
+	void createAdvisors(std::vector<AdvisorPtr> &advisors);
+	void propagate();
+	StatePtr getStateMgr();
+	// info
+	inline int numCliques() const { return (int)cliqueEq.size(); }
+	// output
+	std::ostream &print(std::ostream &out) const;
+	//@{
+	/**
+	 * advisor events (shared by the advisor objects and the engine flattened dispatch)
+	 */
+	inline void fixedUp(int j)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		pendingOnes.push_back(j);
+		dirty |= !propagating; //< our own fixings are processed in the running pass
+	}
+	inline void fixedDown(int j)
+	{
+		if ((state != CSTATE_UNKNOWN) || !inEqClique[j])
+			return;
+		pendingZeros.push_back(j);
+		dirty |= !propagating;
+	}
+	//@}
+
+protected:
+	friend class CliqueTablePropState;
+	// cliques (CSR)
+	std::vector<int> cliqueBeg;
+	std::vector<int> cliqueVars;
+	std::vector<char> cliqueEq;
+	// cliques of each variable (CSR, rebuilt lazily after new cliques are added)
+	std::vector<int> varBeg;
+	std::vector<int> varCliques;
+	bool indexDirty;
+	std::vector<char> inEqClique;
+	std::vector<char> advised;
+	int advisedUpTo; //< position in cliqueVars up to which advisors were created
+	bool propagating;
+	// variables fixed since the last propagation
+	std::vector<int> pendingOnes;
+	std::vector<int> pendingZeros;
+	// helpers
+	void buildIndex();
+	void fail();
+};
+
+/**
+ * Factory extracting cliques from set packing/partitioning rows, and from knapsack
+ * rows in which any two variables cannot be both at 1 (and each of them can).
+ * It keeps one table per domain: see CliqueTableProp.
+ */
+
+class CliqueFactory : public PropagatorFactory
+{
+public:
+	PropagatorFactoryPtr clone() const;
+	int getPriority() const;
+	const char *getName() const;
+	PropagatorPtr analyze(Domain &d, const dominiqs::Constraint *c);
+
+protected:
+	std::shared_ptr<CliqueTableProp> table;
+	const Domain *tableDomain = nullptr;
+	std::vector<int> vars;
+};
+
+#endif /* CLIQUE_PROPAGATOR_H */
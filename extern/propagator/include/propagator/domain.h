@@ -11,16 +11,33 @@
 
 #include <vector>
 #include <string>
-#include <functional>
+#include <memory>
 
 #include <utils/floats.h>
 #include <utils/asserter.h>
+#include <utils/trail.h>
 
 #include "history.h"
 
 // forward declaration
 class DomainState;
 
+/**
+ * Receives the domain change events (typically the propagation engine)
+ * It is a plain interface rather than a set of std::function callbacks,
+ * since every fixing in a propagation goes through it.
+ */
+
+class DomainListener
+{
+public:
+	virtual ~DomainListener() {}
+	virtual void fixedBinUp(int j) = 0;
+	virtual void fixedBinDown(int j) = 0;
+	virtual void tightenedLb(int j, double newValue, double oldValue) = 0;
+	virtual void tightenedUb(int j, double newValue, double oldValue) = 0;
+};
+
 /**
  * Stores the domains of a set of variables and their info
  */
@@ -53,19 +70,19 @@ public:
 	{
 		DOMINIQS_ASSERT(dominiqs::equal(ub[j], 1.0));
 		DOMINIQS_ASSERT(type[j] == 'B');
-		lb[j] = 1.0;
-		fixed[j] = true;
-		if (emitFixedBinUp)
-			emitFixedBinUp(j);
+		setLb(j, 1.0);
+		setFixed(j);
+		if (listener)
+			listener->fixedBinUp(j);
 	}
 	inline void fixBinDown(int j)
 	{
 		DOMINIQS_ASSERT(dominiqs::equal(lb[j], 0.0));
 		DOMINIQS_ASSERT(type[j] == 'B');
-		ub[j] = 0.0;
-		fixed[j] = true;
-		if (emitFixedBinDown)
-			emitFixedBinDown(j);
+		setUb(j, 0.0);
+		setFixed(j);
+		if (listener)
+			listener->fixedBinDown(j);
 	}
 	inline void tightenLb(int j, double newValue)
 	{
@@ -74,11 +91,11 @@ public:
 		newValue = std::min(newValue, ub[j]);
 		if (dominiqs::greaterThan(newValue, oldValue))
 		{
-			lb[j] = newValue;
+			setLb(j, newValue);
 			if (dominiqs::isNull(ub[j] - lb[j]))
-				fixed[j] = true;
-			if (emitTightenedLb)
-				emitTightenedLb(j, newValue, oldValue);
+				setFixed(j);
+			if (listener)
+				listener->tightenedLb(j, newValue, oldValue);
 		}
 	}
 	inline void tightenUb(int j, double newValue)
@@ -88,21 +105,36 @@ public:
 		newValue = std::max(newValue, lb[j]);
 		if (dominiqs::lessThan(newValue, oldValue))
 		{
-			ub[j] = newValue;
+			setUb(j, newValue);
 			if (dominiqs::isNull(ub[j] - lb[j]))
-				fixed[j] = true;
-			if (emitTightenedUb)
-				emitTightenedUb(j, newValue, oldValue);
+				setFixed(j);
+			if (listener)
+				listener->tightenedUb(j, newValue, oldValue);
 		}
 	}
+	/**
+	 * Overwrite the bounds of a variable, possibly relaxing them.
+	 * No callback is emitted: the caller is responsible for bringing whoever depends on
+	 * the domain (e.g., propagators) in sync (see PropagationEngine::rebase).
+	 */
+	inline void resetBounds(int j, double l, double u)
+	{
+		setLb(j, l);
+		setUb(j, u);
+		setFixed(j, dominiqs::equal(l, u));
+	}
 	//@}
 	//@{
-	// callbacks
-	std::function<void(int)> emitFixedBinUp;
-	std::function<void(int)> emitFixedBinDown;
-	std::function<void(int, double, double)> emitTightenedLb;
-	std::function<void(int, double, double)> emitTightenedUb;
+	/**
+	 * Single level undo, cheaper than a state manager dump/restore for taking back a
+	 * tentative decision: undoToMark() brings back the bounds as they were at the last
+	 * mark() (and leaves the mark in place). A restore() of the state manager drops the mark.
+	 */
+	void mark();
+	void undoToMark();
 	//@}
+	// events receiver (not owned)
+	DomainListener *listener = nullptr;
 	StatePtr getStateMgr();
 
 protected:
@@ -112,12 +144,64 @@ protected:
 	std::vector<double> ub;
 	std::vector<bool> fixed;
 	std::vector<char> type;
+	// change tracking (active once a state manager has taken a snapshot)
+	std::unique_ptr<dominiqs::trail<double>> lbTrail;
+	std::unique_ptr<dominiqs::trail<double>> ubTrail;
+	std::unique_ptr<dominiqs::trail<bool>> fixedTrail;
+	// undo mark: old values of the variables changed since mark()
+	struct MarkEntry
+	{
+		int var;
+		double lb;
+		double ub;
+		bool fixed;
+	};
+	bool marking = false;
+	int markId = 0;
+	std::vector<int> markStamp;
+	std::vector<MarkEntry> markLog;
+	inline void logForMark(int j)
+	{
+		if (marking && (markStamp[j] != markId))
+		{
+			markStamp[j] = markId;
+			markLog.push_back({j, lb[j], ub[j], fixed[j]});
+		}
+	}
+	inline void setLb(int j, double value)
+	{
+		logForMark(j);
+		if (lbTrail)
+			lbTrail->set(j, value);
+		else
+			lb[j] = value;
+	}
+	inline void setUb(int j, double value)
+	{
+		logForMark(j);
+		if (ubTrail)
+			ubTrail->set(j, value);
+		else
+			ub[j] = value;
+	}
+	inline void setFixed(int j, bool value = true)
+	{
+		logForMark(j);
+		if (fixedTrail)
+			fixedTrail->set(j, value);
+		else
+			fixed[j] = value;
+	}
 };
 
 typedef std::shared_ptr<Domain> DomainPtr;
 
 /**
  * State Management
+ *
+ * dump() marks the current domains as the state to go back to, restore() undoes
+ * all the changes made since the last dump(), in time linear in the number of changes.
+ * Changes are tracked by the domain itself, so only one state manager per domain can be active.
  */
 
 class DomainState : public State
@@ -130,9 +214,6 @@ public:
 
 private:
 	Domain &domain;
-	std::vector<double> lb;
-	std::vector<double> ub;
-	std::vector<bool> fixed;
 };
 
 typedef std::shared_ptr<DomainState> DomainStatePtr;
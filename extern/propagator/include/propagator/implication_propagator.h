@@ -0,0 +1,111 @@
+/**
+ * @file implication_propagator.h
+ * @brief Binary implication graph propagator
+ *
+ * @author Domenico Salvagnin dominiqs@gmail.com
+ * 2023
+ */
+
+#ifndef IMPLICATION_PROPAGATOR_H
+#define IMPLICATION_PROPAGATOR_H
+
+#include <vector>
+
+#include "propagator.h"
+#include "advisors.h"
+
+/**
+ * @brief Propagator for the implications between binary variables
+ *
+ * Literals are x_j = 1 (2j) and x_j = 0 (2j+1). Every two-variable binary row adds
+ * the implications (and their contrapositives) excluding its infeasible assignments.
+ * Before the first propagation the graph is compressed: its strongly connected
+ * components are sets of equivalent literals, and the propagation walks the resulting
+ * DAG of components once per fixing, fixing every literal reached, instead of sending
+ * each link of an implication chain through the engine queue.
+ * As the clique table, one graph is shared by all the rows of a domain (the factory
+ * returns it after each row, and createAdvisors() only returns the new advisors).
+ */
+
+class ImplicationGraphProp : public Propagator
+{
+public:
+	ImplicationGraphProp(Domain &d);
+	static inline int literal(int j, bool value) { return 2 * j + (value ? 0 : 1); }
+	/** add the implication a -> b (and its contrapositive) between literals */
+	void addImplication(int a, int b);
+	void createAdvisors(std::vector<AdvisorPtr> &advisors);
+	void propagate();
+	StatePtr getStateMgr();
+	// info
+	inline int numImplications() const { return (int)implFrom.size(); }
+	int numComponents();
+	// output
+	std::ostream &print(std::ostream &out) const;
+	//@{
+	/**
+	 * advisor events (shared by the advisor objects and the engine flattened dispatch)
+	 * The fixings done by the propagation itself are already covered by the walk.
+	 */
+	inline void fixedUp(int j)
+	{
+		if ((state != CSTATE_UNKNOWN) || propagating)
+			return;
+		pending.push_back(literal(j, true));
+		dirty = true;
+	}
+	inline void fixedDown(int j)
+	{
+		if ((state != CSTATE_UNKNOWN) || propagating)
+			return;
+		pending.push_back(literal(j, false));
+		dirty = true;
+	}
+	//@}
+
+protected:
+	friend class ImplicationGraphPropState;
+	// implications as added
+	std::vector<int> implFrom;
+	std::vector<int> implTo;
+	std::vector<char> advised;
+	int advisedUpTo; //< implications up to which advisors were created
+	bool graphDirty;
+	// compressed graph: component of each literal, literals of each component (CSR)
+	// and successors of each component in the DAG (CSR)
+	std::vector<int> comp;
+	std::vector<int> compBeg;
+	std::vector<int> compLits;
+	std::vector<int> dagBeg;
+	std::vector<int> dagAdj;
+	bool rootInfeasible;
+	// propagation
+	std::vector<int> pending; //< literals set to true since the last propagation
+	std::vector<int> visited;  //< stamp of the last walk that reached each component
+	int stamp;
+	std::vector<int> stack;
+	bool propagating;
+	// helpers
+	void buildGraph();
+	int setLiteral(int lit);
+};
+
+/**
+ * Factory collecting all rows with exactly two binary variables into the implication graph
+ * (rows that fix a variable by themselves, or are redundant, are left to the other factories)
+ */
+
+class ImplicationFactory : public PropagatorFactory
+{
+public:
+	PropagatorFactoryPtr clone() const;
+	int getPriority() const;
+	const char *getName() const;
+	PropagatorPtr analyze(Domain &d, const dominiqs::Constraint *c);
+
+protected:
+	std::shared_ptr<ImplicationGraphProp> graph;
+	const Domain *graphDomain = nullptr;
+};
+
+#endif /* IMPLICATION_PROPAGATOR_H */
@@ -28,6 +28,80 @@ public:
 	void createAdvisors(std::vector<AdvisorPtr> &advisors);
 	void propagate();
 	StatePtr getStateMgr();
+	//@{
+	/**
+	 * advisor events for variable j with coefficient a > 0 (pos*) or a < 0 (neg*)
+	 * Shared by the advisor objects and the engine flattened dispatch.
+	 */
+	inline void posFixedUp(double a)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		minAct += a;
+		dirty |= (dominiqs::lessThan(rhs, INFBOUND) && (minActInfCnt <= 1));
+	}
+	inline void posFixedDown(double a)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		maxAct -= a;
+		dirty |= (dominiqs::greaterThan(lhs, -INFBOUND) && (maxActInfCnt <= 1));
+	}
+	inline void posTightenLb(int j, double a, double delta, bool decreaseInfCnt, bool propagate)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		if (minActInfIdx == j)
+			minActInfIdx = -1;
+		minAct += delta * a;
+		minActInfCnt -= decreaseInfCnt;
+		dirty |= (propagate && dominiqs::lessThan(rhs, INFBOUND) && (minActInfCnt <= 1));
+	}
+	inline void posTightenUb(int j, double a, double delta, bool decreaseInfCnt, bool propagate)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		if (maxActInfIdx == j)
+			maxActInfIdx = -1;
+		maxAct += delta * a;
+		maxActInfCnt -= decreaseInfCnt;
+		dirty |= (propagate && dominiqs::greaterThan(lhs, -INFBOUND) && (maxActInfCnt <= 1));
+	}
+	inline void negFixedUp(double a)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		maxAct += a;
+		dirty |= (dominiqs::greaterThan(lhs, -INFBOUND) && (maxActInfCnt <= 1));
+	}
+	inline void negFixedDown(double a)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		minAct -= a;
+		dirty |= (dominiqs::lessThan(rhs, INFBOUND) && (minActInfCnt <= 1));
+	}
+	inline void negTightenLb(int j, double a, double delta, bool decreaseInfCnt, bool propagate)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		if (maxActInfIdx == j)
+			maxActInfIdx = -1;
+		maxAct += delta * a;
+		maxActInfCnt -= decreaseInfCnt;
+		dirty |= (propagate && dominiqs::greaterThan(lhs, -INFBOUND) && (maxActInfCnt <= 1));
+	}
+	inline void negTightenUb(int j, double a, double delta, bool decreaseInfCnt, bool propagate)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		if (minActInfIdx == j)
+			minActInfIdx = -1;
+		minAct += delta * a;
+		minActInfCnt -= decreaseInfCnt;
+		dirty |= (propagate && dominiqs::lessThan(rhs, INFBOUND) && (minActInfCnt <= 1));
+	}
+	//@}
 
 protected:
 	friend class PositiveLinearAdvisor;
@@ -84,6 +158,37 @@ public:
 	void createAdvisors(std::vector<AdvisorPtr> &advisors);
 	void propagate();
 	StatePtr getStateMgr();
+	//@{
+	/**
+	 * advisor events (shared by the advisor objects and the engine flattened dispatch)
+	 */
+	inline void fixedUp()
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		minAct++;
+		if (minAct == rhs)
+			dirty = true;
+		else if (minAct > rhs)
+		{
+			state = CSTATE_INFEAS;
+			dirty = false;
+		}
+	}
+	inline void fixedDown()
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		maxAct--;
+		if (maxAct == lhs)
+			dirty = true;
+		else if (maxAct < lhs)
+		{
+			state = CSTATE_INFEAS;
+			dirty = false;
+		}
+	}
+	//@}
 	// output
 	std::ostream &print(std::ostream &out) const;
 
@@ -120,6 +225,40 @@ public:
 	void createAdvisors(std::vector<AdvisorPtr> &advisors);
 	void propagate();
 	StatePtr getStateMgr();
+	//@{
+	/**
+	 * advisor events for a variable with coefficient a
+	 * (shared by the advisor objects and the engine flattened dispatch)
+	 */
+	inline void fixedUp(double a)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		minAct += a;
+		dirty |= dominiqs::lessThan(rhs, INFBOUND);
+	}
+	inline void fixedDown(double a)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		maxAct -= a;
+		dirty |= dominiqs::greaterThan(lhs, -INFBOUND);
+	}
+	inline void tightenLb(double a, double delta, bool propagate)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		minAct += delta * a;
+		dirty |= (propagate && dominiqs::lessThan(rhs, INFBOUND));
+	}
+	inline void tightenUb(double a, double delta, bool propagate)
+	{
+		if (state != CSTATE_UNKNOWN)
+			return;
+		maxAct += delta * a;
+		dirty |= (propagate && dominiqs::greaterThan(lhs, -INFBOUND));
+	}
+	//@}
 	// output
 	std::ostream &print(std::ostream &out) const;
 
@@ -41,12 +41,18 @@ public:
 /**
  * Propagation Engine
  * Coordinates propagators actions, advisors and store the var domains
+ *
+ * Domain events are dispatched through a flattened copy of the advisors:
+ * for each variable, contiguous arrays of (propagator id, coefficient, advisor kind),
+ * with the kinds of the linear propagators handled by a switch on their inline
+ * handlers and only the other (generic) advisors called virtually.
  */
 
-class PropagationEngine
+class PropagationEngine : public DomainListener
 {
 public:
-	PropagationEngine() : stopPropagationIfFailed(false), domain(0), hasFailed(false) {}
+	PropagationEngine() : stopPropagationIfFailed(false), flatDispatch(true), domain(0), dispatchDirty(true), hasFailed(false),
+		marking(false), markId(0), markDecisions(0), markFailed(false) {}
 	virtual ~PropagationEngine();
 	inline DomainPtr getDomain() { return domain; }
 	void setDomain(DomainPtr d);
@@ -58,16 +64,40 @@ public:
 	bool failed() const { return hasFailed; }
 	// state handler
 	StatePtr getStateMgr();
+	/**
+	 * Root re-basing.
+	 * dumpBase() remembers the current domain and propagator states as the base.
+	 * rebase() then moves the domain to any tightening of the base bounds without
+	 * rebuilding the propagators: the variables changed by the previous rebase (and the
+	 * propagators watching them) go back to their base state, and the new bounds are
+	 * applied as regular tightenings. Must be called at the root (no decisions pending),
+	 * and is followed by a dump() of the state manager to make the new bounds the root.
+	 * @return false if the bounds are not a tightening of the base ones (nothing is changed),
+	 *         or if they make some propagator fail
+	 */
+	void dumpBase();
+	bool rebase(const std::vector<double>& lbs, const std::vector<double>& ubs);
+	/**
+	 * Single level undo, for trying a decision and taking it back (e.g., when it fails).
+	 * mark() remembers the current domain and propagator states: propagators save their
+	 * state only when first touched after the mark, so a mark costs nothing up front.
+	 * undoToMark() takes back everything done since the last mark() (decisions, fixings
+	 * and failure flag) and leaves the mark in place.
+	 * The mark is dropped by a restore() of the state manager.
+	 */
+	void mark();
+	void undoToMark();
 	// remove everything (advisors, propagators...)
 	virtual void clear();
 	// options
 	bool stopPropagationIfFailed;
+	bool flatDispatch; //< use the flattened advisor dispatch (otherwise call the advisor objects)
 protected:
 	// signal handlers
-	void fixedBinUp(int j);
-	void fixedBinDown(int j);
-	void tightenedLb(int j, double newValue, double oldValue);
-	void tightenedUb(int j, double newValue, double oldValue);
+	void fixedBinUp(int j) override;
+	void fixedBinDown(int j) override;
+	void tightenedLb(int j, double newValue, double oldValue) override;
+	void tightenedUb(int j, double newValue, double oldValue) override;
 protected:
 	friend class PropagationEngineState;
 
@@ -75,6 +105,14 @@ protected:
 	std::vector<int> vPropLbCount;
 	std::vector<int> vPropUbCount;
 	std::vector< std::vector<AdvisorPtr> > advisors;
+	// flattened advisors (CSR by variable, same order as advisors[j])
+	std::vector<int> advBeg;
+	std::vector<int> advProp;
+	std::vector<double> advCoef;
+	std::vector<char> advKind;
+	std::vector<AdvisorI*> advObj; //< only for ADVISOR_GENERIC
+	std::vector<Propagator*> propPtr;
+	bool dispatchDirty;
 
 	std::vector<PropagatorPtr> propagators;
 	typedef std::deque<int> Queue;
@@ -83,9 +121,36 @@ protected:
 	std::vector<Decision> decisions;
 	std::vector<int> lastFixed;
 	bool hasFailed;
+	// propagators whose state might have changed since the last state dump
+	std::vector<bool> touchedFlag;
+	std::vector<int> touched;
+	// base for rebase()
+	std::vector<double> baseLb;
+	std::vector<double> baseUb;
+	std::vector<StatePtr> baseState;
+	std::vector<int> rebased; //< variables whose bounds differ from the base ones
+	// undo mark
+	bool marking;
+	int markId;
+	std::vector<int> markStamp; //< markId if the propagator state was saved for the current mark
+	std::vector<StatePtr> markState;
+	std::vector<int> markTouched;
+	unsigned int markDecisions;
+	bool markFailed;
 	// helper
+	void buildDispatch();
 	PropagatorPtr top();
    void loop();
+	void saveForMark(int id);
+	inline void touch(int id)
+	{
+		if (marking && (markStamp[id] != markId)) saveForMark(id);
+		if (!touchedFlag[id])
+		{
+			touchedFlag[id] = true;
+			touched.push_back(id);
+		}
+	}
 };
 
 #endif /* PROP_ENGINE_H */
@@ -0,0 +1,310 @@
+/**
+ * @file clique_propagator.cpp
+ * @brief Clique table propagator
+ *
+ * @author Domenico Salvagnin dominiqs@gmail.com
+ * 2023
+ */
+
+#include <iostream>
+
+#include <fmt/format.h>
+#include <utils/floats.h>
+
+#include "propagator/clique_propagator.h"
+
+using namespace dominiqs;
+
+static const int CLIQUE_DEFAULT_PRIORITY = 500;
+
+class CliqueAdvisor : public AdvisorI
+{
+public:
+	CliqueAdvisor(CliqueTableProp &p, int j) : AdvisorI(p, j) {}
+	AdvisorKind getKind() const { return ADVISOR_CLIQUE; }
+	// events for binary variables
+	void fixedUp() { getMyProp<CliqueTableProp>().fixedUp(var); }
+	void fixedDown() { getMyProp<CliqueTableProp>().fixedDown(var); }
+	// output
+	std::ostream &print(std::ostream &out) const
+	{
+		return out << fmt::format("adv({}, idx={})", prop.getName(), var);
+	}
+};
+
+class CliqueTablePropState : public State
+{
+public:
+	CliqueTablePropState(CliqueTableProp &p) : prop(p) {}
+	std::shared_ptr<CliqueTablePropState> clone() const
+	{
+		return std::make_shared<CliqueTablePropState>(*this);
+	}
+	void dump()
+	{
+		state = prop.state;
+	}
+	void restore()
+	{
+		prop.state = state;
+		prop.dirty = false;
+		prop.pendingOnes.clear();
+		prop.pendingZeros.clear();
+	}
+
+protected:
+	CliqueTableProp &prop;
+	PropagatorState state;
+};
+
+CliqueTableProp::CliqueTableProp(Domain &d) : Propagator(d), indexDirty(true), advisedUpTo(0), propagating(false)
+{
+	name = "cliques";
+	cliqueBeg.push_back(0);
+	inEqClique.resize(domain.size(), false);
+	advised.resize(domain.size(), false);
+	dirty = false;
+	setPriority(CLIQUE_DEFAULT_PRIORITY);
+}
+
+void CliqueTableProp::addClique(const std::vector<int> &vars, bool isEq)
+{
+	bool zeroSeen = false;
+	for (int j : vars)
+	{
+		cliqueVars.push_back(j);
+		if (isEq)
+			inEqClique[j] = true;
+		// fixings at creation time are propagated on the first call
+		if (domain.isVarFixed(j))
+		{
+			if (domain.varLb(j) > 0.5)
+				pendingOnes.push_back(j);
+			else if (isEq && !zeroSeen)
+			{
+				pendingZeros.push_back(j);
+				zeroSeen = true;
+			}
+		}
+	}
+	cliqueBeg.push_back(cliqueVars.size());
+	cliqueEq.push_back(isEq);
+	indexDirty = true;
+	dirty |= (!pendingOnes.empty() || !pendingZeros.empty());
+}
+
+void CliqueTableProp::createAdvisors(std::vector<AdvisorPtr> &advisors)
+{
+	for (unsigned int k = advisedUpTo; k < cliqueVars.size(); k++)
+	{
+		int j = cliqueVars[k];
+		if (advised[j])
+			continue;
+		advised[j] = true;
+		advisors.push_back(std::make_shared<CliqueAdvisor>(*this, j));
+	}
+	advisedUpTo = cliqueVars.size();
+}
+
+void CliqueTableProp::buildIndex()
+{
+	unsigned int n = domain.size();
+	varBeg.assign(n + 1, 0);
+	for (int j : cliqueVars)
+		varBeg[j + 1]++;
+	for (unsigned int j = 0; j < n; j++)
+		varBeg[j + 1] += varBeg[j];
+	varCliques.resize(cliqueVars.size());
+	std::vector<int> pos(varBeg.begin(), varBeg.end() - 1);
+	int m = numCliques();
+	for (int c = 0; c < m; c++)
+	{
+		for (int k = cliqueBeg[c]; k < cliqueBeg[c + 1]; k++)
+			varCliques[pos[cliqueVars[k]]++] = c;
+	}
+	indexDirty = false;
+}
+
+void CliqueTableProp::fail()
+{
+	state = CSTATE_INFEAS;
+	dirty = false;
+}
+
+void CliqueTableProp::propagate()
+{
+	dirty = false;
+	if (state == CSTATE_UNKNOWN)
+	{
+		if (indexDirty)
+			buildIndex();
+		propagating = true;
+		// the fixings done here are appended to the pending lists by our own advisors
+		unsigned int nextOne = 0;
+		unsigned int nextZero = 0;
+		while ((state == CSTATE_UNKNOWN) && ((nextOne < pendingOnes.size()) || (nextZero < pendingZeros.size())))
+		{
+			if (nextOne < pendingOnes.size())
+			{
+				// x_j = 1: all its clique neighbors go to 0
+				int j = pendingOnes[nextOne++];
+				for (int p = varBeg[j]; (p < varBeg[j + 1]) && (state == CSTATE_UNKNOWN); p++)
+				{
+					int c = varCliques[p];
+					for (int k = cliqueBeg[c]; k < cliqueBeg[c + 1]; k++)
+					{
+						int i = cliqueVars[k];
+						if (i == j)
+							continue;
+						if (domain.isVarFixed(i))
+						{
+							if (domain.varLb(i) > 0.5)
+							{
+								fail();
+								break;
+							}
+							continue;
+						}
+						domain.fixBinDown(i);
+					}
+				}
+			}
+			else
+			{
+				// x_j = 0: partitioning cliques with a single free variable left force it to 1
+				int j = pendingZeros[nextZero++];
+				for (int p = varBeg[j]; (p < varBeg[j + 1]) && (state == CSTATE_UNKNOWN); p++)
+				{
+					int c = varCliques[p];
+					if (!cliqueEq[c])
+						continue;
+					int free = -1;
+					int freeCnt = 0;
+					bool hasOne = false;
+					for (int k = cliqueBeg[c]; k < cliqueBeg[c + 1]; k++)
+					{
+						int i = cliqueVars[k];
+						if (domain.isVarFixed(i))
+						{
+							if (domain.varLb(i) > 0.5)
+							{
+								hasOne = true;
+								break;
+							}
+							continue;
+						}
+						free = i;
+						freeCnt++;
+					}
+					if (hasOne)
+						continue;
+					if (freeCnt == 0)
+						fail();
+					else if (freeCnt == 1)
+						domain.fixBinUp(free);
+				}
+			}
+		}
+		propagating = false;
+	}
+	pendingOnes.clear();
+	pendingZeros.clear();
+}
+
+StatePtr CliqueTableProp::getStateMgr()
+{
+	return std::make_shared<CliqueTablePropState>(*this);
+}
+
+std::ostream &CliqueTableProp::print(std::ostream &out) const
+{
+	return out << fmt::format("{}: {} cliques, {} nonzeros", name, numCliques(), cliqueVars.size());
+}
+
+PropagatorFactoryPtr CliqueFactory::clone() const
+{
+	return std::make_shared<CliqueFactory>();
+}
+
+int CliqueFactory::getPriority() const
+{
+	return CLIQUE_DEFAULT_PRIORITY;
+}
+
+const char *CliqueFactory::getName() const
+{
+	return "clique";
+}
+
+PropagatorPtr CliqueFactory::analyze(Domain &d, const Constraint *c)
+{
+	unsigned int size = c->row.size();
+	if ((size < 2) || ((c->sense != 'L') && (c->sense != 'E')))
+		return nullptr;
+	const int *idx = c->row.idx();
+	const double *coef = c->row.coef();
+	double minCoef = INFBOUND;
+	double secondMinCoef = INFBOUND;
+	double maxCoef = 0.0;
+	for (unsigned int k = 0; k < size; k++)
+	{
+		if ((d.varType(idx[k]) != 'B') || !isPositive(coef[k]))
+			return nullptr;
+		if (coef[k] < minCoef)
+		{
+			secondMinCoef = minCoef;
+			minCoef = coef[k];
+		}
+		else if (coef[k] < secondMinCoef)
+			secondMinCoef = coef[k];
+		maxCoef = std::max(maxCoef, coef[k]);
+	}
+	bool isEq = (c->sense == 'E');
+	if (isEq)
+	{
+		// set partitioning (up to scaling)
+		if (different(minCoef, maxCoef) || different(c->rhs, minCoef))
+			return nullptr;
+	}
+	else
+	{
+		// any variable can be at 1, no two of them together
+		if (greaterThan(maxCoef, c->rhs) || !greaterThan(minCoef + secondMinCoef, c->rhs))
+			return nullptr;
+	}
+	if (!table || (tableDomain != &d))
+	{
+		table = std::make_shared<CliqueTableProp>(d);
+		tableDomain = &d;
+	}
+	vars.clear();
+	for (unsigned int k = 0; k < size; k++)
+	{
+		// variables at 0 play no role in a packing clique
+		if (!isEq && d.isVarFixed(idx[k]) && (d.varUb(idx[k]) < 0.5))
+			continue;
+		vars.push_back(idx[k]);
+	}
+	table->addClique(vars, isEq);
+	numCreated++;
+	return table;
+}
+
+// auto registration
+
+class CLIQUE_FACTORY_RECORDER
+{
+public:
+	CLIQUE_FACTORY_RECORDER()
+	{
+#ifndef SILENT_EXEC
+		std::cout << "Registering CliqueFactory...";
+#endif //< SILENT_EXEC
+		PropagatorFactories::getInstance().registerClass<CliqueFactory>("clique");
+#ifndef SILENT_EXEC
+		std::cout << "done" << std::endl;
+#endif //< SILENT_EXEC
+	}
+};
+
+CLIQUE_FACTORY_RECORDER my_clique_factory_recorder;
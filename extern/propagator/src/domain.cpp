@@ -12,6 +12,7 @@ using namespace dominiqs;
 
 void Domain::pushVar(const std::string& name, char t, double l, double u)
 {
+	DOMINIQS_ASSERT( !lbTrail ); // trails cannot grow
 	names.push_back(name);
 	type.push_back(t);
 	lb.push_back(l);
@@ -26,11 +27,38 @@ StatePtr Domain::getStateMgr()
 
 void Domain::clear()
 {
+	lbTrail.reset();
+	ubTrail.reset();
+	fixedTrail.reset();
 	names.clear();
 	type.clear();
 	lb.clear();
 	ub.clear();
 	fixed.clear();
+	marking = false;
+	markStamp.clear();
+	markLog.clear();
+}
+
+void Domain::mark()
+{
+	if (markStamp.size() != size()) markStamp.assign(size(), 0);
+	markId++;
+	markLog.clear();
+	marking = true;
+}
+
+void Domain::undoToMark()
+{
+	DOMINIQS_ASSERT( marking );
+	for (auto itr = markLog.rbegin(); itr != markLog.rend(); ++itr)
+	{
+		// already logged for this mark: setters will not log again
+		setLb(itr->var, itr->lb);
+		setUb(itr->var, itr->ub);
+		setFixed(itr->var, itr->fixed);
+	}
+	mark();
 }
 
 DomainStatePtr DomainState::clone() const
@@ -40,18 +68,27 @@ DomainStatePtr DomainState::clone() const
 
 void DomainState::dump()
 {
-	lb = domain.lb;
-	ub = domain.ub;
-	fixed = domain.fixed;
+	if (!domain.lbTrail)
+	{
+		// start tracking changes
+		domain.lbTrail.reset(new trail<double>(domain.lb));
+		domain.ubTrail.reset(new trail<double>(domain.ub));
+		domain.fixedTrail.reset(new trail<bool>(domain.fixed));
+	}
+	else
+	{
+		// commit the changes made so far
+		domain.lbTrail->clear();
+		domain.ubTrail->clear();
+		domain.fixedTrail->clear();
+	}
 }
 
 void DomainState::restore()
 {
-	DOMINIQS_ASSERT( lb.size() == domain.names.size() );
-	DOMINIQS_ASSERT( ub.size() == domain.names.size() );
-	DOMINIQS_ASSERT( fixed.size() == domain.names.size() );
-	DOMINIQS_ASSERT( domain.fixed.size() == domain.names.size() );
-	domain.lb = lb;
-	domain.ub = ub;
-	domain.fixed = fixed;
+	DOMINIQS_ASSERT( domain.lbTrail && domain.ubTrail && domain.fixedTrail );
+	domain.lbTrail->restore();
+	domain.ubTrail->restore();
+	domain.fixedTrail->restore();
+	domain.marking = false;
 }
@@ -0,0 +1,410 @@
+/**
+ * @file implication_propagator.cpp
+ * @brief Binary implication graph propagator
+ *
+ * @author Domenico Salvagnin dominiqs@gmail.com
+ * 2023
+ */
+
+#include <iostream>
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <utils/floats.h>
+
+#include "propagator/implication_propagator.h"
+
+using namespace dominiqs;
+
+static const int IMPLICATION_DEFAULT_PRIORITY = 5;
+
+// outcomes of setting a literal to true
+static const int LIT_SET = 0;
+static const int LIT_ALREADY_TRUE = 1;
+static const int LIT_CONFLICT = 2;
+
+class ImplicationAdvisor : public AdvisorI
+{
+public:
+	ImplicationAdvisor(ImplicationGraphProp &p, int j) : AdvisorI(p, j) {}
+	AdvisorKind getKind() const { return ADVISOR_IMPLICATION; }
+	// events for binary variables
+	void fixedUp() { getMyProp<ImplicationGraphProp>().fixedUp(var); }
+	void fixedDown() { getMyProp<ImplicationGraphProp>().fixedDown(var); }
+	// output
+	std::ostream &print(std::ostream &out) const
+	{
+		return out << fmt::format("adv({}, idx={})", prop.getName(), var);
+	}
+};
+
+class ImplicationGraphPropState : public State
+{
+public:
+	ImplicationGraphPropState(ImplicationGraphProp &p) : prop(p) {}
+	std::shared_ptr<ImplicationGraphPropState> clone() const
+	{
+		return std::make_shared<ImplicationGraphPropState>(*this);
+	}
+	void dump()
+	{
+		state = prop.state;
+	}
+	void restore()
+	{
+		prop.state = state;
+		prop.dirty = false;
+		prop.pending.clear();
+	}
+
+protected:
+	ImplicationGraphProp &prop;
+	PropagatorState state;
+};
+
+ImplicationGraphProp::ImplicationGraphProp(Domain &d)
+	: Propagator(d), advisedUpTo(0), graphDirty(true), rootInfeasible(false), stamp(0), propagating(false)
+{
+	name = "implications";
+	advised.resize(domain.size(), false);
+	dirty = false;
+	setPriority(IMPLICATION_DEFAULT_PRIORITY);
+}
+
+void ImplicationGraphProp::addImplication(int a, int b)
+{
+	implFrom.push_back(a);
+	implTo.push_back(b);
+	graphDirty = true;
+	// implications of literals already true at creation time are propagated on the first call
+	for (int lit : {a, b ^ 1})
+	{
+		int j = lit / 2;
+		if (domain.isVarFixed(j) && ((domain.varLb(j) > 0.5) == ((lit & 1) == 0)))
+		{
+			pending.push_back(lit);
+			dirty = true;
+		}
+	}
+}
+
+void ImplicationGraphProp::createAdvisors(std::vector<AdvisorPtr> &advisors)
+{
+	for (unsigned int k = advisedUpTo; k < implFrom.size(); k++)
+	{
+		for (int lit : {implFrom[k], implTo[k]})
+		{
+			int j = lit / 2;
+			if (advised[j])
+				continue;
+			advised[j] = true;
+			advisors.push_back(std::make_shared<ImplicationAdvisor>(*this, j));
+		}
+	}
+	advisedUpTo = implFrom.size();
+}
+
+void ImplicationGraphProp::buildGraph()
+{
+	int nlits = 2 * domain.size();
+	// literal graph (CSR), with the contrapositives
+	std::vector<int> adjBeg(nlits + 1, 0);
+	for (unsigned int k = 0; k < implFrom.size(); k++)
+	{
+		adjBeg[implFrom[k] + 1]++;
+		adjBeg[(implTo[k] ^ 1) + 1]++;
+	}
+	for (int l = 0; l < nlits; l++)
+		adjBeg[l + 1] += adjBeg[l];
+	std::vector<int> adj(adjBeg[nlits]);
+	std::vector<int> pos(adjBeg.begin(), adjBeg.end() - 1);
+	for (unsigned int k = 0; k < implFrom.size(); k++)
+	{
+		adj[pos[implFrom[k]]++] = implTo[k];
+		adj[pos[implTo[k] ^ 1]++] = implFrom[k] ^ 1;
+	}
+	// strongly connected components (iterative Tarjan: implication chains can be very deep)
+	std::vector<int> index(nlits, -1);
+	std::vector<int> low(nlits, 0);
+	std::vector<char> onStack(nlits, false);
+	std::vector<int> sccStack;
+	std::vector<std::pair<int, int>> callStack; //< (literal, next arc)
+	comp.assign(nlits, -1);
+	int ncomps = 0;
+	int counter = 0;
+	for (int s = 0; s < nlits; s++)
+	{
+		if (index[s] >= 0)
+			continue;
+		callStack.emplace_back(s, adjBeg[s]);
+		index[s] = low[s] = counter++;
+		sccStack.push_back(s);
+		onStack[s] = true;
+		while (!callStack.empty())
+		{
+			int v = callStack.back().first;
+			int &arc = callStack.back().second;
+			if (arc < adjBeg[v + 1])
+			{
+				int w = adj[arc++];
+				if (index[w] < 0)
+				{
+					index[w] = low[w] = counter++;
+					sccStack.push_back(w);
+					onStack[w] = true;
+					callStack.emplace_back(w, adjBeg[w]);
+				}
+				else if (onStack[w])
+					low[v] = std::min(low[v], index[w]);
+				continue;
+			}
+			// v is done
+			if (low[v] == index[v])
+			{
+				int w;
+				do
+				{
+					w = sccStack.back();
+					sccStack.pop_back();
+					onStack[w] = false;
+					comp[w] = ncomps;
+				} while (w != v);
+				ncomps++;
+			}
+			callStack.pop_back();
+			if (!callStack.empty())
+			{
+				int u = callStack.back().first;
+				low[u] = std::min(low[u], low[v]);
+			}
+		}
+	}
+	// literals of each component
+	compBeg.assign(ncomps + 1, 0);
+	for (int l = 0; l < nlits; l++)
+		compBeg[comp[l] + 1]++;
+	for (int c = 0; c < ncomps; c++)
+		compBeg[c + 1] += compBeg[c];
+	compLits.resize(nlits);
+	pos.assign(compBeg.begin(), compBeg.end() - 1);
+	for (int l = 0; l < nlits; l++)
+		compLits[pos[comp[l]]++] = l;
+	// DAG of the components
+	dagBeg.assign(ncomps + 1, 0);
+	dagAdj.clear();
+	std::vector<int> succ;
+	for (int c = 0; c < ncomps; c++)
+	{
+		succ.clear();
+		for (int k = compBeg[c]; k < compBeg[c + 1]; k++)
+		{
+			int l = compLits[k];
+			for (int p = adjBeg[l]; p < adjBeg[l + 1]; p++)
+				if (comp[adj[p]] != c)
+					succ.push_back(comp[adj[p]]);
+		}
+		std::sort(succ.begin(), succ.end());
+		succ.erase(std::unique(succ.begin(), succ.end()), succ.end());
+		dagAdj.insert(dagAdj.end(), succ.begin(), succ.end());
+		dagBeg[c + 1] = dagAdj.size();
+	}
+	// x_j = 1 equivalent to x_j = 0: no assignment satisfies the rows
+	rootInfeasible = false;
+	for (int l = 0; l < nlits; l += 2)
+		rootInfeasible |= (comp[l] == comp[l + 1]);
+	visited.assign(ncomps, 0);
+	stamp = 0;
+	graphDirty = false;
+}
+
+int ImplicationGraphProp::numComponents()
+{
+	if (graphDirty)
+		buildGraph();
+	return (int)compBeg.size() - 1;
+}
+
+int ImplicationGraphProp::setLiteral(int lit)
+{
+	int j = lit / 2;
+	bool value = ((lit & 1) == 0);
+	if (domain.isVarFixed(j))
+		return ((domain.varLb(j) > 0.5) == value) ? LIT_ALREADY_TRUE : LIT_CONFLICT;
+	if (value)
+		domain.fixBinUp(j);
+	else
+		domain.fixBinDown(j);
+	return LIT_SET;
+}
+
+void ImplicationGraphProp::propagate()
+{
+	dirty = false;
+	if (state == CSTATE_UNKNOWN)
+	{
+		if (graphDirty)
+			buildGraph();
+		if (rootInfeasible)
+		{
+			state = CSTATE_INFEAS;
+			pending.clear();
+			return;
+		}
+		propagating = true;
+		stamp++;
+		for (unsigned int i = 0; (i < pending.size()) && (state == CSTATE_UNKNOWN); i++)
+		{
+			// the component of a new fixing is always expanded, even if reached (and found
+			// already true) by a previous walk of this call
+			int c = comp[pending[i]];
+			visited[c] = stamp;
+			stack.push_back(c);
+			bool first = true;
+			while (!stack.empty())
+			{
+				c = stack.back();
+				stack.pop_back();
+				bool newFixings = first;
+				first = false;
+				for (int k = compBeg[c]; k < compBeg[c + 1]; k++)
+				{
+					int outcome = setLiteral(compLits[k]);
+					if (outcome == LIT_CONFLICT)
+					{
+						state = CSTATE_INFEAS;
+						break;
+					}
+					newFixings |= (outcome == LIT_SET);
+				}
+				if (state != CSTATE_UNKNOWN)
+					break;
+				// a component that was already true has been walked by the fixing that made it so
+				if (!newFixings)
+					continue;
+				for (int p = dagBeg[c]; p < dagBeg[c + 1]; p++)
+				{
+					int d = dagAdj[p];
+					if (visited[d] != stamp)
+					{
+						visited[d] = stamp;
+						stack.push_back(d);
+					}
+				}
+			}
+		}
+		propagating = false;
+	}
+	pending.clear();
+	stack.clear();
+}
+
+StatePtr ImplicationGraphProp::getStateMgr()
+{
+	return std::make_shared<ImplicationGraphPropState>(*this);
+}
+
+std::ostream &ImplicationGraphProp::print(std::ostream &out) const
+{
+	return out << fmt::format("{}: {} implications", name, numImplications());
+}
+
+PropagatorFactoryPtr ImplicationFactory::clone() const
+{
+	return std::make_shared<ImplicationFactory>();
+}
+
+int ImplicationFactory::getPriority() const
+{
+	return IMPLICATION_DEFAULT_PRIORITY;
+}
+
+const char *ImplicationFactory::getName() const
+{
+	return "implication";
+}
+
+PropagatorPtr ImplicationFactory::analyze(Domain &d, const Constraint *c)
+{
+	if ((c->row.size() != 2) || (c->sense == 'N'))
+		return nullptr;
+	const int *idx = c->row.idx();
+	const double *coef = c->row.coef();
+	if ((d.varType(idx[0]) != 'B') || (d.varType(idx[1]) != 'B') || isNull(coef[0]) || isNull(coef[1]))
+		return nullptr;
+	double lhs = -INFBOUND;
+	double rhs = INFBOUND;
+	switch (c->sense)
+	{
+	case 'L':
+		rhs = c->rhs;
+		break;
+	case 'G':
+		lhs = c->rhs;
+		break;
+	case 'E':
+		lhs = c->rhs;
+		rhs = c->rhs;
+		break;
+	case 'R':
+		lhs = c->rhs - c->range;
+		rhs = c->rhs;
+		break;
+	default:
+		return nullptr;
+	}
+	// which of the four assignments violate the row?
+	bool infeas[2][2];
+	int numInfeas = 0;
+	for (int u = 0; u < 2; u++)
+	{
+		for (int v = 0; v < 2; v++)
+		{
+			double act = coef[0] * u + coef[1] * v;
+			infeas[u][v] = lessThan(act, lhs) || greaterThan(act, rhs);
+			numInfeas += infeas[u][v];
+		}
+	}
+	if (numInfeas == 0)
+		return nullptr;
+	for (int u = 0; u < 2; u++)
+	{
+		// the row fixes a variable by itself
+		if ((infeas[u][0] && infeas[u][1]) || (infeas[0][u] && infeas[1][u]))
+			return nullptr;
+	}
+	if (!graph || (graphDomain != &d))
+	{
+		graph = std::make_shared<ImplicationGraphProp>(d);
+		graphDomain = &d;
+	}
+	// each infeasible assignment (x = u, y = v) gives x = u -> y = 1 - v (and y = v -> x = 1 - u)
+	for (int u = 0; u < 2; u++)
+	{
+		for (int v = 0; v < 2; v++)
+		{
+			if (infeas[u][v])
+				graph->addImplication(ImplicationGraphProp::literal(idx[0], u), ImplicationGraphProp::literal(idx[1], !v));
+		}
+	}
+	numCreated++;
+	return graph;
+}
+
+// auto registration
+
+class IMPLICATION_FACTORY_RECORDER
+{
+public:
+	IMPLICATION_FACTORY_RECORDER()
+	{
+#ifndef SILENT_EXEC
+		std::cout << "Registering ImplicationFactory...";
+#endif //< SILENT_EXEC
+		PropagatorFactories::getInstance().registerClass<ImplicationFactory>("implication");
+#ifndef SILENT_EXEC
+		std::cout << "done" << std::endl;
+#endif //< SILENT_EXEC
+	}
+};
+
+IMPLICATION_FACTORY_RECORDER my_implication_factory_recorder;
@@ -33,45 +33,19 @@ class PositiveLinearAdvisor : public AdvisorI
 {
 public:
 	PositiveLinearAdvisor(LinearProp &p, int j, double coef) : AdvisorI(p, j), a(coef) {}
+	AdvisorKind getKind() const { return ADVISOR_LINEAR_POS; }
+	double getCoef() const { return a; }
 	// events for binary variables
-	void fixedUp()
-	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		LinearProp &p = getMyProp<LinearProp>();
-		p.minAct += a;
-		p.dirty |= (lessThan(p.rhs, INFBOUND) && (p.minActInfCnt <= 1));
-	}
-	void fixedDown()
-	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		LinearProp &p = getMyProp<LinearProp>();
-		p.maxAct -= a;
-		p.dirty |= (greaterThan(p.lhs, -INFBOUND) && (p.maxActInfCnt <= 1));
-	}
+	void fixedUp() { getMyProp<LinearProp>().posFixedUp(a); }
+	void fixedDown() { getMyProp<LinearProp>().posFixedDown(a); }
 	// events for other variables
 	void tightenLb(double delta, bool decreaseInfCnt, bool propagate)
 	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		LinearProp &p = getMyProp<LinearProp>();
-		if (p.minActInfIdx == var)
-			p.minActInfIdx = -1;
-		p.minAct += delta * a;
-		p.minActInfCnt -= decreaseInfCnt;
-		p.dirty |= (propagate && lessThan(p.rhs, INFBOUND) && (p.minActInfCnt <= 1));
+		getMyProp<LinearProp>().posTightenLb(var, a, delta, decreaseInfCnt, propagate);
 	}
 	void tightenUb(double delta, bool decreaseInfCnt, bool propagate)
 	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		LinearProp &p = getMyProp<LinearProp>();
-		if (p.maxActInfIdx == var)
-			p.maxActInfIdx = -1;
-		p.maxAct += delta * a;
-		p.maxActInfCnt -= decreaseInfCnt;
-		p.dirty |= (propagate && greaterThan(p.lhs, -INFBOUND) && (p.maxActInfCnt <= 1));
+		getMyProp<LinearProp>().posTightenUb(var, a, delta, decreaseInfCnt, propagate);
 	}
 	// output
 	std::ostream &print(std::ostream &out) const
@@ -92,45 +66,19 @@ class NegativeLinearAdvisor : public AdvisorI
 {
 public:
 	NegativeLinearAdvisor(LinearProp &p, int j, double coef) : AdvisorI(p, j), a(coef) {}
+	AdvisorKind getKind() const { return ADVISOR_LINEAR_NEG; }
+	double getCoef() const { return a; }
 	// events for binary variables
-	void fixedUp()
-	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		LinearProp &p = getMyProp<LinearProp>();
-		p.maxAct += a;
-		p.dirty |= (greaterThan(p.lhs, -INFBOUND) && (p.maxActInfCnt <= 1));
-	}
-	void fixedDown()
-	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		LinearProp &p = getMyProp<LinearProp>();
-		p.minAct -= a;
-		p.dirty |= (lessThan(p.rhs, INFBOUND) && (p.minActInfCnt <= 1));
-	}
+	void fixedUp() { getMyProp<LinearProp>().negFixedUp(a); }
+	void fixedDown() { getMyProp<LinearProp>().negFixedDown(a); }
 	// events for other variables
 	void tightenLb(double delta, bool decreaseInfCnt, bool propagate)
 	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		LinearProp &p = getMyProp<LinearProp>();
-		if (p.maxActInfIdx == var)
-			p.maxActInfIdx = -1;
-		p.maxAct += delta * a;
-		p.maxActInfCnt -= decreaseInfCnt;
-		p.dirty |= (propagate && greaterThan(p.lhs, -INFBOUND) && (p.maxActInfCnt <= 1));
+		getMyProp<LinearProp>().negTightenLb(var, a, delta, decreaseInfCnt, propagate);
 	}
 	void tightenUb(double delta, bool decreaseInfCnt, bool propagate)
 	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		LinearProp &p = getMyProp<LinearProp>();
-		if (p.minActInfIdx == var)
-			p.minActInfIdx = -1;
-		p.minAct += delta * a;
-		p.minActInfCnt -= decreaseInfCnt;
-		p.dirty |= (propagate && lessThan(p.rhs, INFBOUND) && (p.minActInfCnt <= 1));
+		getMyProp<LinearProp>().negTightenUb(var, a, delta, decreaseInfCnt, propagate);
 	}
 	// output
 	std::ostream &print(std::ostream &out) const
@@ -218,11 +166,13 @@ LinearProp::LinearProp(Domain &d, const Constraint *c) : Propagator(d)
 		double a = coef[k];
 		if (isNull(a))
 			continue;
+		// binaries may be fixed already (e.g., when building on the bounds of a sub-MIP)
 		if (a > 0.0)
 		{
 			if (domain.varType(j) == 'B')
 			{
-				maxAct += a;
+				minAct += (domain.varLb(j) * a);
+				maxAct += (domain.varUb(j) * a);
 				posBinIdx.push_back(j);
 				posBinCoef.push_back(a);
 			}
@@ -244,7 +194,8 @@ LinearProp::LinearProp(Domain &d, const Constraint *c) : Propagator(d)
 		{
 			if (domain.varType(j) == 'B')
 			{
-				minAct += a;
+				minAct += (domain.varUb(j) * a);
+				maxAct += (domain.varLb(j) * a);
 				negBinIdx.push_back(j);
 				negBinCoef.push_back(a);
 			}
@@ -647,35 +598,10 @@ class CardinalityAdvisor : public AdvisorI
 {
 public:
 	CardinalityAdvisor(CardinalityProp &p, int j) : AdvisorI(p, j) {}
+	AdvisorKind getKind() const { return ADVISOR_CARDINALITY; }
 	// events for binary variables
-	void fixedUp()
-	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		CardinalityProp &p = getMyProp<CardinalityProp>();
-		p.minAct++;
-		if (p.minAct == p.rhs)
-			p.dirty = true;
-		else if (p.minAct > p.rhs)
-		{
-			p.state = CSTATE_INFEAS;
-			p.dirty = false;
-		}
-	}
-	void fixedDown()
-	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		CardinalityProp &p = getMyProp<CardinalityProp>();
-		p.maxAct--;
-		if (p.maxAct == p.lhs)
-			p.dirty = true;
-		else if (p.maxAct < p.lhs)
-		{
-			p.state = CSTATE_INFEAS;
-			p.dirty = false;
-		}
-	}
+	void fixedUp() { getMyProp<CardinalityProp>().fixedUp(); }
+	void fixedDown() { getMyProp<CardinalityProp>().fixedDown(); }
 	// output
 	std::ostream &print(std::ostream &out) const
 	{
@@ -893,39 +819,19 @@ class KnapsackAdvisor : public AdvisorI
 {
 public:
 	KnapsackAdvisor(KnapsackProp &p, int j, double coef) : AdvisorI(p, j), a(coef) {}
+	AdvisorKind getKind() const { return ADVISOR_KNAPSACK; }
+	double getCoef() const { return a; }
 	// events for binary variables
-	void fixedUp()
-	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		KnapsackProp &p = getMyProp<KnapsackProp>();
-		p.minAct += a;
-		p.dirty |= lessThan(p.rhs, INFBOUND);
-	}
-	void fixedDown()
-	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		KnapsackProp &p = getMyProp<KnapsackProp>();
-		p.maxAct -= a;
-		p.dirty |= greaterThan(p.lhs, -INFBOUND);
-	}
+	void fixedUp() { getMyProp<KnapsackProp>().fixedUp(a); }
+	void fixedDown() { getMyProp<KnapsackProp>().fixedDown(a); }
 	// events for other variables
 	void tightenLb(double delta, bool decreaseInfCnt, bool propagate)
 	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		KnapsackProp &p = getMyProp<KnapsackProp>();
-		p.minAct += delta * a;
-		p.dirty |= (propagate && lessThan(p.rhs, INFBOUND));
+		getMyProp<KnapsackProp>().tightenLb(a, delta, propagate);
 	}
 	void tightenUb(double delta, bool decreaseInfCnt, bool propagate)
 	{
-		if (prop.getState() != CSTATE_UNKNOWN)
-			return;
-		KnapsackProp &p = getMyProp<KnapsackProp>();
-		p.maxAct += delta * a;
-		p.dirty |= (propagate && greaterThan(p.lhs, -INFBOUND));
+		getMyProp<KnapsackProp>().tightenUb(a, delta, propagate);
 	}
 	// output
 	std::ostream &print(std::ostream &out) const
@@ -977,7 +883,8 @@ KnapsackProp::KnapsackProp(Domain &d, const Constraint *c) : Propagator(d)
 		DOMINIQS_ASSERT(a > 0.0);
 		if (domain.varType(j) == 'B')
 		{
-			maxAct += a;
+			minAct += a * domain.varLb(j);
+			maxAct += a * domain.varUb(j);
 			posBinIdx.push_back(j);
 			posBinCoef.push_back(a);
 		}
@@ -7,27 +7,26 @@
  * 2008-2012
  */
 
-#include <functional>
 #include <iostream>
 
 #include <utils/floats.h>
 
 #include "propagator/prop_engine.h"
+#include "propagator/linear_propagator.h"
+#include "propagator/clique_propagator.h"
+#include "propagator/implication_propagator.h"
 
 using namespace dominiqs;
 
 class PropagationEngineState : public State
 {
 public:
-	PropagationEngineState(PropagationEngine& e) : engine(e), domainState(0), failed(false)
+	PropagationEngineState(PropagationEngine& e) : engine(e), domainState(0), failed(false), dumped(false)
 	{
 		DOMINIQS_ASSERT( engine.domain );
 		domainState = engine.domain->getStateMgr();
-		for (PropagatorPtr p: engine.propagators)
-		{
-			StatePtr ps = p->getStateMgr();
-			if (ps) propState.push_back(ps);
-		}
+		// indexed by propagator ID (null if the propagator has no state)
+		for (PropagatorPtr p: engine.propagators) propState.push_back(p->getStateMgr());
 	}
 	virtual ~PropagationEngineState()
 	{
@@ -39,15 +38,33 @@ public:
 	{
 		DOMINIQS_ASSERT( domainState );
 		domainState->dump();
-		for (StatePtr ps: propState) ps->dump();
+		if (!dumped)
+		{
+			for (StatePtr ps: propState) if (ps) ps->dump();
+			dumped = true;
+		}
+		else
+		{
+			// the other propagators are still in the state of the previous dump
+			for (int id: engine.touched) if (propState[id]) propState[id]->dump();
+		}
 		failed = engine.hasFailed;
+		for (int id: engine.touched) engine.touchedFlag[id] = false;
+		engine.touched.clear();
 	}
 	void restore()
 	{
 		DOMINIQS_ASSERT( domainState );
 		domainState->restore();
-		for (StatePtr ps: propState) ps->restore();
+		// only the propagators that were notified or propagated since the dump can have a different state
+		for (int id: engine.touched)
+		{
+			if (propState[id]) propState[id]->restore();
+			engine.touchedFlag[id] = false;
+		}
+		engine.touched.clear();
 		engine.decisions.clear(); // need to think about this!
+		engine.marking = false;
 		engine.hasFailed = failed; // need to think about this!
 	}
 protected:
@@ -55,6 +72,7 @@ protected:
 	StatePtr domainState;
 	std::vector<StatePtr> propState;
 	bool failed;
+	bool dumped;
 };
 
 
@@ -65,8 +83,6 @@ PropagationEngine::~PropagationEngine()
 
 void PropagationEngine::setDomain(DomainPtr d)
 {
-	using namespace std::placeholders;
-
 	DOMINIQS_ASSERT( d );
 	clear();
 	domain = d;
@@ -77,22 +93,52 @@ void PropagationEngine::setDomain(DomainPtr d)
 		advisors.emplace_back();
 	}
 
-	domain->emitFixedBinUp = std::bind(&PropagationEngine::fixedBinUp, this, _1);
-	domain->emitFixedBinDown = std::bind(&PropagationEngine::fixedBinDown, this, _1);
-	domain->emitTightenedLb = std::bind(&PropagationEngine::tightenedLb, this, _1, _2, _3);
-	domain->emitTightenedUb = std::bind(&PropagationEngine::tightenedUb, this, _1, _2, _3);
+	domain->listener = this;
 }
 
 void PropagationEngine::pushPropagator(PropagatorPtr prop)
 {
 	DOMINIQS_ASSERT( prop );
 	DOMINIQS_ASSERT( &(prop->getDomain()) == domain.get() );
-	propagators.push_back(prop);
-	prop->setID(propagators.size() - 1);
+	int id = prop->getID();
+	if ((id < 0) || (id >= (int)propagators.size()) || (propagators[id] != prop))
+	{
+		propagators.push_back(prop);
+		prop->setID(propagators.size() - 1);
+		touchedFlag.push_back(false);
+	}
+	// else: pushed again after growing (e.g., the clique table), only the new advisors are added below
 	if (prop->pending()) queue.push_back(prop->getID());
 	std::vector<AdvisorPtr> advs;
 	prop->createAdvisors(advs);
 	for (AdvisorPtr adv: advs) advisors[adv->getVar()].push_back(adv);
+	dispatchDirty = true;
+}
+
+void PropagationEngine::buildDispatch()
+{
+	unsigned int n = advisors.size();
+	advBeg.resize(n + 1);
+	advProp.clear();
+	advCoef.clear();
+	advKind.clear();
+	advObj.clear();
+	for (unsigned int j = 0; j < n; j++)
+	{
+		advBeg[j] = advProp.size();
+		for (const AdvisorPtr& adv: advisors[j])
+		{
+			AdvisorKind kind = adv->getKind();
+			advProp.push_back(adv->getPropagator().getID());
+			advCoef.push_back(adv->getCoef());
+			advKind.push_back(kind);
+			advObj.push_back((kind == ADVISOR_GENERIC) ? adv.get() : nullptr);
+		}
+	}
+	advBeg[n] = advProp.size();
+	propPtr.clear();
+	for (PropagatorPtr p: propagators) propPtr.push_back(p.get());
+	dispatchDirty = false;
 }
 
 void PropagationEngine::loop()
@@ -102,7 +148,11 @@ void PropagationEngine::loop()
 	{
 		PropagatorPtr p = top();
 		if (!p) break;
-		if (p->pending()) p->propagate();
+		if (p->pending())
+		{
+			touch(p->getID());
+			p->propagate();
+		}
 		if (p->failed()) hasFailed = true;
 		if (stopPropagationIfFailed && hasFailed) break;
 	}
@@ -176,14 +226,117 @@ StatePtr PropagationEngine::getStateMgr()
 	return std::make_shared<PropagationEngineState>(*this);
 }
 
+void PropagationEngine::dumpBase()
+{
+	DOMINIQS_ASSERT( domain );
+	unsigned int n = domain->size();
+	baseLb.resize(n);
+	baseUb.resize(n);
+	for (unsigned int j = 0; j < n; j++)
+	{
+		baseLb[j] = domain->varLb(j);
+		baseUb[j] = domain->varUb(j);
+	}
+	baseState.clear();
+	for (PropagatorPtr p: propagators)
+	{
+		StatePtr ps = p->getStateMgr();
+		if (ps) ps->dump();
+		baseState.push_back(ps);
+	}
+	rebased.clear();
+}
+
+bool PropagationEngine::rebase(const std::vector<double>& lbs, const std::vector<double>& ubs)
+{
+	DOMINIQS_ASSERT( domain );
+	DOMINIQS_ASSERT( decisions.empty() );
+	marking = false;
+	unsigned int n = domain->size();
+	DOMINIQS_ASSERT( (baseLb.size() == n) && (lbs.size() >= n) && (ubs.size() >= n) );
+	// propagators can only follow tightenings
+	for (unsigned int j = 0; j < n; j++)
+	{
+		if (lessThan(lbs[j], baseLb[j]) || greaterThan(ubs[j], baseUb[j]) || greaterThan(lbs[j], ubs[j])) return false;
+	}
+	// undo the previous rebase
+	for (int j: rebased)
+	{
+		domain->resetBounds(j, baseLb[j], baseUb[j]);
+		for (AdvisorPtr adv: advisors[j])
+		{
+			int id = adv->getPropagator().getID();
+			if (baseState[id]) baseState[id]->restore();
+			touch(id);
+		}
+	}
+	rebased.clear();
+	// apply the new bounds (propagated on the next call, as after the initial setup)
+	for (unsigned int j = 0; j < n; j++)
+	{
+		if (equal(lbs[j], baseLb[j]) && equal(ubs[j], baseUb[j])) continue;
+		rebased.push_back(j);
+		if (domain->varType(j) == 'B')
+		{
+			if (greaterThan(lbs[j], 0.0)) domain->fixBinUp(j);
+			else domain->fixBinDown(j);
+		}
+		else
+		{
+			domain->tightenLb(j, lbs[j]);
+			domain->tightenUb(j, ubs[j]);
+		}
+	}
+	lastFixed.clear();
+	return (!hasFailed);
+}
+
+void PropagationEngine::mark()
+{
+	DOMINIQS_ASSERT( domain );
+	domain->mark();
+	if (markStamp.size() != propagators.size())
+	{
+		markStamp.assign(propagators.size(), 0);
+		markState.resize(propagators.size());
+	}
+	markId++;
+	markTouched.clear();
+	markDecisions = decisions.size();
+	markFailed = hasFailed;
+	marking = true;
+}
+
+void PropagationEngine::undoToMark()
+{
+	DOMINIQS_ASSERT( marking );
+	domain->undoToMark();
+	for (int id: markTouched) markState[id]->restore();
+	queue.clear();
+	decisions.resize(markDecisions);
+	hasFailed = markFailed;
+	lastFixed.clear();
+	mark();
+}
+
+void PropagationEngine::saveForMark(int id)
+{
+	markStamp[id] = markId;
+	if (!markState[id])
+	{
+		markState[id] = propagators[id]->getStateMgr();
+		// stateless propagator: never to be saved for this engine
+		if (!markState[id]) return;
+	}
+	markState[id]->dump();
+	markTouched.push_back(id);
+}
+
 void PropagationEngine::clear()
 {
 	if (domain)
 	{
-		domain->emitFixedBinUp = nullptr;
-		domain->emitFixedBinDown = nullptr;
-		domain->emitTightenedLb = nullptr;
-		domain->emitTightenedUb = nullptr;
+		if (domain->listener == this) domain->listener = nullptr;
 		domain = nullptr;
 	}
 
@@ -194,9 +347,26 @@ void PropagationEngine::clear()
 		for (AdvisorI* adv: advs) delete adv;
 	}*/
 	advisors.clear();
+	advBeg.clear();
+	advProp.clear();
+	advCoef.clear();
+	advKind.clear();
+	advObj.clear();
+	propPtr.clear();
+	dispatchDirty = true;
 
 	//for (PropagatorPtr p: propagators) delete p;
 	propagators.clear();
+	touchedFlag.clear();
+	touched.clear();
+	baseLb.clear();
+	baseUb.clear();
+	baseState.clear();
+	rebased.clear();
+	marking = false;
+	markStamp.clear();
+	markState.clear();
+	markTouched.clear();
 	lastFixed.clear();
 	decisions.clear();
 }
@@ -214,13 +384,46 @@ void PropagationEngine::tightenedLb(int j, double newValue, double oldValue)
 	}
 	if (domain->isVarFixed(j) && (domain->varType(j) != 'C')) lastFixed.push_back(j);
 	bool propagateFlag = (domain->isVarFixed(j) || (vPropLbCount[j]++ < MAX_PROP_COUNT));
-	for (AdvisorPtr adv: advisors[j])
+	if (!flatDispatch)
 	{
-		Propagator& p = adv->getPropagator();
-		bool wasPending = p.pending();
-		adv->tightenLb(delta, wasUnbounded, propagateFlag);
-		if (p.pending() && !wasPending) queue.push_back(p.getID());
-		if (p.failed()) hasFailed = true;
+		for (const AdvisorPtr& adv: advisors[j])
+		{
+			Propagator& p = adv->getPropagator();
+			touch(p.getID());
+			bool wasPending = p.pending();
+			adv->tightenLb(delta, wasUnbounded, propagateFlag);
+			if (p.pending() && !wasPending) queue.push_back(p.getID());
+			if (p.failed()) hasFailed = true;
+		}
+		return;
+	}
+	if (dispatchDirty) buildDispatch();
+	for (int k = advBeg[j]; k < advBeg[j + 1]; k++)
+	{
+		int id = advProp[k];
+		Propagator* p = propPtr[id];
+		touch(id);
+		bool wasPending = p->pending();
+		switch (advKind[k])
+		{
+			case ADVISOR_LINEAR_POS:
+				static_cast<LinearProp*>(p)->posTightenLb(j, advCoef[k], delta, wasUnbounded, propagateFlag);
+				break;
+			case ADVISOR_LINEAR_NEG:
+				static_cast<LinearProp*>(p)->negTightenLb(j, advCoef[k], delta, wasUnbounded, propagateFlag);
+				break;
+			case ADVISOR_KNAPSACK:
+				static_cast<KnapsackProp*>(p)->tightenLb(advCoef[k], delta, propagateFlag);
+				break;
+			case ADVISOR_CARDINALITY:
+			case ADVISOR_CLIQUE:
+			case ADVISOR_IMPLICATION:
+				break;
+			default:
+				advObj[k]->tightenLb(delta, wasUnbounded, propagateFlag);
+		}
+		if (p->pending() && !wasPending) queue.push_back(id);
+		if (p->failed()) hasFailed = true;
 	}
 }
 
@@ -235,39 +438,148 @@ void PropagationEngine::tightenedUb(int j, double newValue, double oldValue)
 	}
 	if (domain->isVarFixed(j) && (domain->varType(j) != 'C')) lastFixed.push_back(j);
 	bool propagateFlag = (domain->isVarFixed(j) || (vPropUbCount[j]++ < MAX_PROP_COUNT));
-	for (AdvisorPtr adv: advisors[j])
+	if (!flatDispatch)
 	{
-		Propagator& p = adv->getPropagator();
-		bool wasPending = p.pending();
-		adv->tightenUb(delta, wasUnbounded, propagateFlag);
-		if (p.pending() && !wasPending) queue.push_back(p.getID());
-		if (p.failed()) hasFailed = true;
+		for (const AdvisorPtr& adv: advisors[j])
+		{
+			Propagator& p = adv->getPropagator();
+			touch(p.getID());
+			bool wasPending = p.pending();
+			adv->tightenUb(delta, wasUnbounded, propagateFlag);
+			if (p.pending() && !wasPending) queue.push_back(p.getID());
+			if (p.failed()) hasFailed = true;
+		}
+		return;
+	}
+	if (dispatchDirty) buildDispatch();
+	for (int k = advBeg[j]; k < advBeg[j + 1]; k++)
+	{
+		int id = advProp[k];
+		Propagator* p = propPtr[id];
+		touch(id);
+		bool wasPending = p->pending();
+		switch (advKind[k])
+		{
+			case ADVISOR_LINEAR_POS:
+				static_cast<LinearProp*>(p)->posTightenUb(j, advCoef[k], delta, wasUnbounded, propagateFlag);
+				break;
+			case ADVISOR_LINEAR_NEG:
+				static_cast<LinearProp*>(p)->negTightenUb(j, advCoef[k], delta, wasUnbounded, propagateFlag);
+				break;
+			case ADVISOR_KNAPSACK:
+				static_cast<KnapsackProp*>(p)->tightenUb(advCoef[k], delta, propagateFlag);
+				break;
+			case ADVISOR_CARDINALITY:
+			case ADVISOR_CLIQUE:
+			case ADVISOR_IMPLICATION:
+				break;
+			default:
+				advObj[k]->tightenUb(delta, wasUnbounded, propagateFlag);
+		}
+		if (p->pending() && !wasPending) queue.push_back(id);
+		if (p->failed()) hasFailed = true;
 	}
 }
 
 void PropagationEngine::fixedBinUp(int j)
 {
 	lastFixed.push_back(j);
-	for (AdvisorPtr adv: advisors[j])
+	if (!flatDispatch)
+	{
+		for (const AdvisorPtr& adv: advisors[j])
+		{
+			Propagator& p = adv->getPropagator();
+			touch(p.getID());
+			bool wasPending = p.pending();
+			adv->fixedUp();
+			if (p.pending() && !wasPending) queue.push_back(p.getID());
+			if (p.failed()) hasFailed = true;
+		}
+		return;
+	}
+	if (dispatchDirty) buildDispatch();
+	for (int k = advBeg[j]; k < advBeg[j + 1]; k++)
 	{
-		Propagator& p = adv->getPropagator();
-		bool wasPending = p.pending();
-		adv->fixedUp();
-		if (p.pending() && !wasPending) queue.push_back(p.getID());
-		if (p.failed()) hasFailed = true;
+		int id = advProp[k];
+		Propagator* p = propPtr[id];
+		touch(id);
+		bool wasPending = p->pending();
+		switch (advKind[k])
+		{
+			case ADVISOR_LINEAR_POS:
+				static_cast<LinearProp*>(p)->posFixedUp(advCoef[k]);
+				break;
+			case ADVISOR_LINEAR_NEG:
+				static_cast<LinearProp*>(p)->negFixedUp(advCoef[k]);
+				break;
+			case ADVISOR_KNAPSACK:
+				static_cast<KnapsackProp*>(p)->fixedUp(advCoef[k]);
+				break;
+			case ADVISOR_CARDINALITY:
+				static_cast<CardinalityProp*>(p)->fixedUp();
+				break;
+			case ADVISOR_CLIQUE:
+				static_cast<CliqueTableProp*>(p)->fixedUp(j);
+				break;
+			case ADVISOR_IMPLICATION:
+				static_cast<ImplicationGraphProp*>(p)->fixedUp(j);
+				break;
+			default:
+				advObj[k]->fixedUp();
+		}
+		if (p->pending() && !wasPending) queue.push_back(id);
+		if (p->failed()) hasFailed = true;
 	}
 }
 
 void PropagationEngine::fixedBinDown(int j)
 {
 	lastFixed.push_back(j);
-	for (AdvisorPtr adv: advisors[j])
+	if (!flatDispatch)
 	{
-		Propagator& p = adv->getPropagator();
-		bool wasPending = p.pending();
-		adv->fixedDown();
-		if (p.pending() && !wasPending) queue.push_back(p.getID());
-		if (p.failed()) hasFailed = true;
+		for (const AdvisorPtr& adv: advisors[j])
+		{
+			Propagator& p = adv->getPropagator();
+			touch(p.getID());
+			bool wasPending = p.pending();
+			adv->fixedDown();
+			if (p.pending() && !wasPending) queue.push_back(p.getID());
+			if (p.failed()) hasFailed = true;
+		}
+		return;
+	}
+	if (dispatchDirty) buildDispatch();
+	for (int k = advBeg[j]; k < advBeg[j + 1]; k++)
+	{
+		int id = advProp[k];
+		Propagator* p = propPtr[id];
+		touch(id);
+		bool wasPending = p->pending();
+		switch (advKind[k])
+		{
+			case ADVISOR_LINEAR_POS:
+				static_cast<LinearProp*>(p)->posFixedDown(advCoef[k]);
+				break;
+			case ADVISOR_LINEAR_NEG:
+				static_cast<LinearProp*>(p)->negFixedDown(advCoef[k]);
+				break;
+			case ADVISOR_KNAPSACK:
+				static_cast<KnapsackProp*>(p)->fixedDown(advCoef[k]);
+				break;
+			case ADVISOR_CARDINALITY:
+				static_cast<CardinalityProp*>(p)->fixedDown();
+				break;
+			case ADVISOR_CLIQUE:
+				static_cast<CliqueTableProp*>(p)->fixedDown(j);
+				break;
+			case ADVISOR_IMPLICATION:
+				static_cast<ImplicationGraphProp*>(p)->fixedDown(j);
+				break;
+			default:
+				advObj[k]->fixedDown();
+		}
+		if (p->pending() && !wasPending) queue.push_back(id);
+		if (p->failed()) hasFailed = true;
 	}
 }
 
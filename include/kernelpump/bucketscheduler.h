@@ -0,0 +1,63 @@
+/**
+ * @file bucketscheduler.h
+ * @brief Adaptive time budget for the buckets of the Kernel Pump
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#ifndef BUCKETSCHEDULER_H
+#define BUCKETSCHEDULER_H
+
+namespace dominiqs
+{
+
+	/** what happened while pumping on a bucket */
+	struct BucketProgress
+	{
+		bool lpFeasible = false; /**< did the pump get past the initial LP? */
+		double startDist;		 /**< closest distance before the bucket */
+		double endDist;			 /**< closest distance found in the bucket */
+		double time = 0.0;		 /**< wall-clock time spent */
+		int iterations = 0;		 /**< pumping iterations */
+		int cycles = 0;			 /**< cycles detected (perturbations + restarts) */
+	};
+
+	/**
+	 * @brief Re-plans the time budget of each bucket from the progress observed on the previous ones
+	 *
+	 * The time left is split evenly among the buckets still to be pumped, so that time not used
+	 * by buckets failing fast goes to the following ones. The fair share is then multiplied by
+	 * boost if the last bucket was still improving the closest distance, or divided by it if the
+	 * last bucket only cycled. Each bucket gets at least the time for minIterations iterations
+	 * (at the observed speed), as long as the following buckets keep a fair/boost share each.
+	 */
+	class BucketScheduler
+	{
+	public:
+		BucketScheduler();
+		void setup(double _boost, int _minIterations, double _imprThreshold);
+		void reset();
+		/** time budget for the next bucket, given the time left and the number of buckets (including that one) still to go */
+		double budget(double timeLeft, int bucketsLeft) const;
+		void record(const BucketProgress &progress);
+		// accessors
+		bool isImproving() const { return improving; }
+		bool isCycling() const { return cycling; }
+		double timePerIteration() const { return iterTime; }
+
+	private:
+		// config
+		double boost;
+		int minIterations;
+		double imprThreshold;
+		// state
+		double iterTime; /**< smoothed time per pumping iteration (negative if unknown) */
+		bool improving;
+		bool cycling;
+	};
+
+} // namespace dominiqs
+
+#endif /* BUCKETSCHEDULER_H */
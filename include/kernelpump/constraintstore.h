@@ -0,0 +1,131 @@
+/**
+ * @file constraintstore.h
+ * @brief Contiguous (CSR) storage of the constraints of a model
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#ifndef CONSTRAINTSTORE_H
+#define CONSTRAINTSTORE_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <iterator>
+
+#include <utils/maths.h>
+
+namespace dominiqs
+{
+
+	/**
+	 * @brief Lightweight view of a row of a ConstraintStore
+	 *
+	 * Ranged rows follow the Constraint convention: the linear expression must be in [rhs-range,rhs].
+	 */
+	struct RowView
+	{
+		int cnt;		   /**< number of nonzeros */
+		const int *idx;	   /**< column indexes */
+		const double *coef; /**< coefficients */
+		char sense;
+		double rhs;
+		double range;
+		// accessors
+		int size() const { return cnt; }
+		/** same as Constraint::violation */
+		double violation(const double *x) const;
+		bool satisfiedBy(const double *x, double eps = defaultEPS) const { return !isPositive(violation(x), eps); }
+		/** copy this row into a (legacy) Constraint object */
+		void toConstraint(Constraint &c) const;
+	};
+
+	/**
+	 * @brief Immutable row-major (CSR) copy of the constraint matrix, with sense/rhs/range
+	 *
+	 * All the nonzeros live in a few contiguous arrays, so scanning the rows does not
+	 * chase pointers. The column-major (CSC) transpose is built lazily (and thread-safely)
+	 * on the first call to columns(). The store is shared (read-only) by cloned models.
+	 */
+	class ConstraintStore
+	{
+	public:
+		/** column-major copy of the matrix */
+		struct Columns
+		{
+			std::vector<int> start; /**< size ncols+1 */
+			std::vector<int> rowIdx;
+			std::vector<double> coef;
+		};
+
+		class const_iterator
+		{
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef RowView value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const RowView *pointer;
+			typedef RowView reference;
+			const_iterator(const ConstraintStore *_store, int _i) : store(_store), i(_i) {}
+			RowView operator*() const { return (*store)[i]; }
+			const_iterator &operator++()
+			{
+				i++;
+				return *this;
+			}
+			bool operator==(const const_iterator &other) const { return i == other.i; }
+			bool operator!=(const const_iterator &other) const { return i != other.i; }
+
+		private:
+			const ConstraintStore *store;
+			int i;
+		};
+
+		/**
+		 * Build the store from a row-major matrix (as returned by MIPModelI::rows(SparseMatrix&)).
+		 * Senses, rhs and ranges are given in solver convention, i.e., ranged rows are [rhs,rhs+range].
+		 */
+		ConstraintStore(int ncols, const SparseMatrix &matrix, const std::vector<char> &sense,
+						const std::vector<double> &rhs, const std::vector<double> &range);
+		/** Same as above, but taking ownership of the CSR arrays (rowStart of size nrows+1): no copy of the matrix */
+		ConstraintStore(int ncols, std::vector<int> &&rowStart, std::vector<int> &&colIdx, std::vector<double> &&coefs,
+						std::vector<char> sense, std::vector<double> rhs, std::vector<double> range);
+		// accessors
+		int size() const { return senses.size(); }
+		int nrows() const { return senses.size(); }
+		int ncols() const { return numCols; }
+		int nnz() const { return colIdx.size(); }
+		RowView operator[](int i) const
+		{
+			int beg = rowStart[i];
+			return RowView{rowStart[i + 1] - beg, colIdx.data() + beg, coefs.data() + beg, senses[i], rhss[i], ranges[i]};
+		}
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, size()); }
+		/** column-major transpose (built on first use) */
+		const Columns &columns() const;
+		/** memory footprint of the store (in bytes, CSC excluded) */
+		std::size_t bytes() const;
+
+	private:
+		int numCols;
+		std::vector<int> rowStart; /**< size nrows+1 */
+		std::vector<int> colIdx;
+		std::vector<double> coefs;
+		std::vector<char> senses;
+		std::vector<double> rhss;
+		std::vector<double> ranges;
+		// lazy transpose
+		mutable std::once_flag columnsFlag;
+		mutable Columns cols;
+		// helpers
+		void convertRanges();
+	};
+
+	typedef std::shared_ptr<const ConstraintStore> ConstraintStorePtr;
+
+} // namespace dominiqs
+
+#endif /* CONSTRAINTSTORE_H */
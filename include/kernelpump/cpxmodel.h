@@ -25,6 +25,7 @@ public:
 	std::unique_ptr<CPXModel> clone() const { return std::unique_ptr<CPXModel>(this->clone_impl()); }
 	/* Read/Write */
 	void readModel(const std::string &filename) override;
+	void loadModel(const ModelData &data) override;
 	void writeModel(const std::string &filename, const std::string &format = "") const override;
 	void writeSol(const std::string &filename) const override;
 	/* Solve */
@@ -37,11 +38,15 @@ public:
 	std::unique_ptr<CPXModel> presolvedModel() const { return std::unique_ptr<CPXModel>(this->presolvedmodel_impl()); }
 	std::vector<double> postsolveSolution(const std::vector<double> &preX) const override;
 	std::vector<double> presolveSolution(const std::vector<double> &origX) const override;
+	bool presolvedColMap(std::vector<int> &origToPre) const override;
 	/* Get solution */
 	double objval() const override;
 	void sol(double *x, int first = 0, int last = -1) const override;
 	void reduced_costs(double *x, int first = 0, int last = -1) const override;
 	bool isPrimalFeas() const override;
+	/* Basis */
+	bool getBasis(LPBasis &basis) const override;
+	bool setBasis(const LPBasis &basis) override;
 	/* Parameters */
 	void handleCtrlC(bool flag) override;
 	bool aborted() const override;
@@ -87,6 +92,7 @@ public:
 	void lbs(int cnt, const int *cols, const double *values) override;
 	void ub(int cidx, double val) override;
 	void ubs(int cnt, const int *cols, const double *values) override;
+	void rhs(int cnt, const int *rows, const double *values) override;
 	void fixCol(int cidx, double val) override;
 	void objcoef(int cidx, double val) override;
 	void objcoefs(int cnt, const int *cols, const double *values) override;
@@ -12,16 +12,72 @@
 
 #include <list>
 #include <set>
+#include <atomic>
 
 #include <utils/randgen.h>
 #include <utils/it_display.h>
 #include <utils/timer.h>
 
 #include "kernelpump/fp_interface.h"
+#include "kernelpump/intcache.h"
+#include "kernelpump/rowactivity.h"
+#include "kernelpump/jumprepair.h"
 
 namespace dominiqs
 {
 
+	/**
+	 * @brief Columns of a point that may have changed since it was last looked at
+	 */
+	struct ChangedColumns
+	{
+		std::vector<int> cols;
+		bool all = true; /**< any column may have changed */
+		void add(const std::vector<int> &changed)
+		{
+			if (!all)
+				cols.insert(cols.end(), changed.begin(), changed.end());
+		}
+		void setAll()
+		{
+			all = true;
+			cols.clear();
+		}
+		void reset()
+		{
+			all = false;
+			cols.clear();
+		}
+	};
+
+	/**
+	 * @brief Pumping iterations left to a pump: limits on stage 1, on stage 2 and overall
+	 *
+	 * Each pump() call uses part of the budget, so that consecutive calls share the limits.
+	 */
+	struct IterBudget
+	{
+		int stage1 = 0;
+		int stage2 = 0;
+		int total = 0;
+		/** iterations used to go from this budget down to after */
+		IterBudget used(const IterBudget &after) const { return IterBudget{stage1 - after.stage1, stage2 - after.stage2, total - after.total}; }
+		/** this budget minus the iterations in used */
+		IterBudget charged(const IterBudget &used) const
+		{
+			return IterBudget{std::max(0, stage1 - used.stage1), std::max(0, stage2 - used.stage2), std::max(0, total - used.total)};
+		}
+		/**
+		 * A pump given this budget used the iterations in used: would it have stopped at the same point with budget other?
+		 * True if every limit is either the same in both budgets or not reached with either of them.
+		 */
+		bool sameRun(const IterBudget &used, const IterBudget &other) const
+		{
+			auto same = [](int limit, int otherLimit, int n) { return (limit == otherLimit) || (n < std::min(limit, otherLimit)); };
+			return same(stage1, other.stage1, used.stage1) && same(stage2, other.stage2, used.stage2) && same(total, other.total, used.total);
+		}
+	};
+
 	/**
 	 * @brief Basic Feasibility Pump Scheme
 	 * Accepts custom rounders
@@ -39,6 +95,23 @@ namespace dominiqs
 		 * @param ctype: if the problem object is an LP, you can provide variable type info with this vector
 		 */
 		bool init(MIPModelPtr model, const std::vector<char> &ctype = std::vector<char>());
+		/** re-enter the pump on the model of the last init() with different variable bounds, without presolving again
+		 * @param cols, lbs, ubs: bounds (in the space of the model given to init()) of the variables restricted w.r.t. that model.
+		 *                        Variables not listed get back the bounds they had at init() time.
+		 * @return false if the bounds invalidate the presolve reductions (or the model cannot be reused): init() must be called again
+		 */
+		bool updateBounds(const std::vector<int> &cols, const std::vector<double> &lbs, const std::vector<double> &ubs);
+		/** cooperative cancellation: the pump stops as soon as *flag becomes true, and sets it itself when it finds a solution
+		 * (the flag is shared by all the pumps of a portfolio, nullptr disables it)
+		 */
+		void setStopFlag(std::atomic<bool> *flag) { stopFlag = flag; }
+		/** iterations left (decreased by each pump() call, reset by readConfig()) */
+		IterBudget getIterBudget() const { return IterBudget{stage1IterLimit, stage2IterLimit, iterLimit}; }
+		void setIterBudget(const IterBudget &budget);
+		/** seed of the config */
+		uint64_t getSeed() const { return seed; }
+		/** restart all the random choices of the pump (rounder included) from the given seed, as after readConfig() */
+		void reseed(uint64_t newSeed);
 		/** pump
 		 * @param xStart: starting fractional solution (will solve LP if empty)
 		 * @param pFeas: primal feasiblity status of supplied vector
@@ -56,8 +129,16 @@ namespace dominiqs
 		double getSolutionValue(const std::vector<double> &x) const;
 		double getPrimalBound() const { return primalBound; }
 		int getIterations() const;
+		/** number of perturbations + restarts, i.e., of cycles detected (cumulative, as getIterations()) */
+		int getCycles() const { return pertCnt + restartCnt; }
 		int nbins() const { return binaries.size(); }
 		const std::vector<int> &bins() const { return binaries; } // needed to build Kernel Pump's initial kernel and buckets.
+		/** simplex basis the first LP of the next pump() call starts from (it must come from a pump with the same getModelSpace()) */
+		void setStartBasis(const LPBasis &basis) { startBasis = basis; }
+		/** basis of the last LP solved to optimality by the last pump() call (false if none) */
+		bool getLastBasis(LPBasis &basis) const;
+		/** id of the column space of the pumped model: 0 for the model given to init(), a new id after each presolve */
+		int getModelSpace() const { return modelSpace; }
 		const char getfirstOptMethod() const { return firstOptMethod; }
 		const char getReOptMethod() const { return reOptMethod; }
 		// reset EVERYTING
@@ -83,6 +164,12 @@ namespace dominiqs
 		bool walksatPerturbe;
 		bool randomizeLP;
 		bool penaltyObj;
+		int intCacheSize; // max number of integer points kept in the cycle detection cache (<= 0 means unlimited)
+		bool pipelineLP;		// solve the projection LPs asynchronously, preparing alternative roundings meanwhile
+		int pipelineCandidates; // number of alternative roundings prepared during each LP solve
+		bool stopOnFeasibleRounding; // stop as soon as a rounding is feasible, without solving the LP again
+		bool jumpRepair;			 // try to repair infeasible roundings with a few local search moves before the LP
+		int jumpRepairMoves;		 // max number of local search moves per repair
 
 		// new parameters
 		int stage1NoImprIterLimit; // max iterations without 10% improvent in stage 1
@@ -140,15 +227,33 @@ namespace dominiqs
 		int primalFeas;					 /**< is current fractional x^* primal feasible? */
 		std::vector<double> integer_x;	 /**< integer x^~ */
 		typedef std::pair<double, std::vector<double>> AlphaVector;
-		std::list<AlphaVector> lastIntegerX; /**< integer x cache */
+		IntegerPointCache lastIntegerX; /**< integer x cache */
 
 		typedef std::pair<int, std::vector<double>> NumberVector;
 		std::list<NumberVector> lastFracX; /**< fractional x cache */
 
 		typedef std::pair<double, std::vector<double>> DistVector;
-		std::list<DistVector> multipleIntegerX;	 /**< integer reference points */
-		std::list<DistVector> closestIntegerXs1; /**< closest integer x cache stage 1*/
-		std::list<DistVector> closestIntegerXs2; /**< closest integer x cache stage 2*/
+		std::list<DistVector> multipleIntegerX; /**< integer reference points */
+		typedef std::pair<double, IntegerPoint> DistPoint;
+		std::list<DistPoint> closestIntegerXs1; /**< closest integer x cache stage 1*/
+		std::list<DistPoint> closestIntegerXs2; /**< closest integer x cache stage 2*/
+
+		std::vector<double> installedObj;  /**< distance objective currently installed in the LP */
+		std::vector<double> binWeightDown; /**< exp/logistic weights of the binaries (rounded down) */
+		std::vector<double> binWeightUp;   /**< exp/logistic weights of the binaries (rounded up) */
+
+		/** auxiliary variable (and linking constraints) modelling the distance |x_j - ref| of a general integer */
+		struct DeltaSlot
+		{
+			int col; /**< index of the delta variable */
+			int row; /**< index of the first linking constraint (x_j - delta <= ref), the second one (x_j + delta >= ref) follows */
+			double ref;
+		};
+		std::vector<DeltaSlot> deltaPool; /**< delta variables created in the current stage (kept at the end of the model) */
+		std::vector<int> deltaPoolIdx;	  /**< (reference point, general integer) -> slot in deltaPool (-1 if not created yet) */
+		std::vector<int> deltaRhsIdx;	  /**< linking constraints whose rhs must be updated */
+		std::vector<double> deltaRhsVal;
+		std::vector<std::vector<double>> altRoundings; /**< alternative roundings of the previous LP solution (pipelined mode) */
 
 		RandGen rnd;
 		std::vector<double> closestPoint; /**< point closest to feasibility */
@@ -170,7 +275,31 @@ namespace dominiqs
 		std::vector<int> binaries;						  /**< list of binary vars indexes */
 		std::vector<int> gintegers;						  /**< list of general integer vars indexes */
 		std::vector<int> integers;						  /**< list of non continuous vars indexes (binaries + gintegers) */
-		std::shared_ptr<std::vector<ConstraintPtr>> rows; /**< constraints of the model */
+		std::vector<int> nonIntegers;					  /**< list of fixed and continuous vars indexes */
+		PointLayoutPtr pointLayout;						  /**< layout of the compact integer points stored in the caches */
+		ConstraintStorePtr rows;						  /**< constraints of the model */
+		RowActivity intActivity;						  /**< row activities of the last integer point checked */
+		ChangedColumns intActivityChanges;				  /**< columns in which integer_x may differ from the point of intActivity */
+		ChangedColumns intHashChanges;					  /**< columns in which integer_x may differ from the vector last hashed by lastIntegerX */
+		JumpRepair repairer;							  /**< local search repair of the roundings */
+		std::vector<double> repaired;					  /**< rounding being repaired */
+		// model state right after init(), needed to re-enter the pump with updateBounds()
+		std::vector<double> initLb;	  /**< bounds of the model given to init() */
+		std::vector<double> initUb;
+		std::vector<int> origToPre;	  /**< column map from the model given to init() to the presolved one (-1 if removed) */
+		std::vector<double> preLb;	  /**< bounds of the (presolved) model right after presolve */
+		std::vector<double> preUb;
+		std::vector<double> preObj;	  /**< objective of the (presolved) model right after presolve */
+		ObjSense preObjSense;
+		double preObjOffset;
+		bool canUpdateBounds = false;
+		// warm start across pump() calls
+		LPBasis startBasis;		 /**< basis to install before the first LP of pump() */
+		LPBasis lastBasis;		 /**< basis of the last optimal LP */
+		bool hasLastBasis = false;
+		int modelSpace = 0;
+		int presolveCount = 0;
+		std::atomic<bool> *stopFlag = nullptr;
 		IterationDisplay display;
 		// solution
 		bool hasIncumbent;
@@ -181,6 +310,8 @@ namespace dominiqs
 		int pertCnt;
 		int restartCnt;
 		int walksatCnt;
+		int altRoundingCnt; /**< cycles broken with an alternative rounding (pipelined mode) */
+		int repairCnt;		/**< roundings made feasible by the local search repair */
 		int nitr; /**< pumping iterations */
 		int lastRestart;
 		int flipsInRestart;
@@ -193,14 +324,27 @@ namespace dominiqs
 		double acTime;
 		int rootLpIter;
 		// helpers
+		bool stopRequested() const { return stopFlag && stopFlag->load(std::memory_order_relaxed); }
+		bool setup(bool boundsOnly = false);
+		void resetSetup();
 		void solveInitialLP();
+		void installStartBasis();
+		void saveLastBasis();
 		void perturbe(std::vector<double> &x, bool ignoreGeneralIntegers);
 		void restart(std::vector<double> &x, bool ignoreGeneralIntegers);
 		bool pumpLoop(double &runningAlpha, int stage, double &dualBound, bool stopWithNoImprLimit);
 		bool stage3();
 		void foundIncumbent(const std::vector<double> &x, double objval);
-		bool isInCache(double a, const std::vector<double> &x, bool ignoreGeneralIntegers);
+		void trackRounding();
+		void integerXChanged();
+		void updateIntActivity(const std::vector<double> &x);
+		uint64_t integerXHash();
 		void infeasibleSupport(const std::vector<double> &x, std::set<int> &supp, bool ignoreGeneralIntegers);
+		int useDeltaSlot(int point, int k, double ref, const std::vector<std::string> &xNames, std::vector<int> &colIndices, std::vector<double> &distObj);
+		void flushDeltaRhs();
+		void prepareAlternativeRoundings(const std::vector<int> &intSubset);
+		bool useAlternativeRounding(const std::vector<int> &intSubset, double runningAlpha);
+		void clearDeltaPool();
 
 		// added function
 		void aggregateFracs(std::vector<double> &aggr_frac_x, std::vector<double> &scaleVector);
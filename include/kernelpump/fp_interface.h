@@ -32,15 +32,29 @@ namespace dominiqs
 	public:
 		virtual ~SolutionTransformer() {}
 		virtual void readConfig() {}
+		/**
+		 * Restart the random choices (if any) from @param seed, as if it was the seed of the config
+		 */
+		virtual void reseed(uint64_t seed) {}
 		/**
 		 * Read needed information (if any) about the problem (@param pinfo)
 		 */
 		virtual void init(MIPModelPtr model, bool ignoreGeneralInt = true) {}
+		/**
+		 * Same as init(), for a model that differs from the one of the last init() only in the variable bounds
+		 * @return false if the transformer cannot update itself incrementally (init() must be called instead)
+		 */
+		virtual bool updateBounds(MIPModelPtr model, bool ignoreGeneralInt = true) { return false; }
 		virtual void ignoreGeneralIntegers(bool flag) {}
 		/**
 		 * Trasform the vector given as input @param in and store the result in @param out
 		 */
 		virtual void apply(const std::vector<double> &in, std::vector<double> &out) = 0;
+		/**
+		 * Columns of the output of the last apply() whose value may differ from the one the output vector had before
+		 * (nullptr if unknown, i.e., any column may have changed)
+		 */
+		virtual const std::vector<int> *changedColumns() const { return nullptr; }
 		virtual void newIncumbent(const std::vector<double> &x, double objval) {}
 		/**
 		 *
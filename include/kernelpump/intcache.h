@@ -0,0 +1,150 @@
+/**
+ * @file intcache.h
+ * @brief Compact integer points and hash-indexed cache of the points visited by the Feasibility Pump
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#ifndef INTCACHE_H
+#define INTCACHE_H
+
+#include <list>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace dominiqs
+{
+
+	/**
+	 * @brief Description of the integer part of a point, shared by all the IntegerPoint objects of a model
+	 */
+	class PointLayout
+	{
+	public:
+		PointLayout(int n, const std::vector<int> &_binaries, const std::vector<int> &_gintegers,
+					const std::vector<double> &lb, const std::vector<double> &ub);
+		std::vector<int> binaries;	/**< binary vars indexes */
+		std::vector<int> gintegers; /**< general integer vars indexes */
+		std::vector<double> ref;	/**< reference value of each general integer (a finite bound if any, 0 otherwise) */
+		std::vector<int> pos;		/**< var -> position in binaries (>= 0), in gintegers (-pos-1) or NO_POS */
+		int numWords;				/**< number of 64-bit words needed to store the binaries */
+		static const int NO_POS;
+	};
+
+	typedef std::shared_ptr<const PointLayout> PointLayoutPtr;
+
+	/**
+	 * @brief Compact storage for the integer part of a point
+	 *
+	 * Binaries are packed into 64-bit words, general integers are stored sparsely
+	 * as (nonzero) offsets from their reference value, continuous variables are not stored.
+	 * Equality between points compares whole binary words.
+	 */
+	class IntegerPoint
+	{
+	public:
+		IntegerPoint() = default;
+		IntegerPoint(PointLayoutPtr _layout, const std::vector<double> &x);
+		/** value of (binary or general integer) variable j */
+		double operator[](int j) const;
+		/** write the integer components of this point into x */
+		void unpack(std::vector<double> &x) const;
+		bool equals(const IntegerPoint &other, bool ignoreGeneralIntegers) const;
+
+	private:
+		PointLayoutPtr layout;
+		std::vector<uint64_t> bits;
+		std::vector<int> gpos;		 /**< positions (in layout->gintegers) of the general integers not at their reference value */
+		std::vector<long long> gval; /**< corresponding offsets */
+	};
+
+	/**
+	 * @brief Cache of (alpha, integer point) pairs used for cycle detection
+	 *
+	 * Points are compared only on the binaries in stage 1 and on all integers in stage 2.
+	 * Every point is identified by a 64-bit Zobrist-like hash of its integer part, which
+	 * is kept up to date incrementally: only the components that changed w.r.t. the last
+	 * hashed vector contribute work, and if the caller knows which columns may have changed,
+	 * only those are looked at. Lookups go through an index keyed on (hash, alpha bucket),
+	 * so a full comparison is done only on a hash hit.
+	 *
+	 * If a capacity is given, the oldest points are evicted from the cache, but their
+	 * hashes and alphas are kept (up to HISTORY_PER_POINT times the capacity), so that longer
+	 * cycles can still be detected (an evicted point is matched on its hash only: a false
+	 * positive needs a 64-bit hash collision). An unlimited cache evicts nothing.
+	 */
+	class IntegerPointCache
+	{
+	public:
+		struct Point
+		{
+			double alpha;
+			uint64_t hash;
+			IntegerPoint x;
+		};
+		typedef std::list<Point>::const_iterator const_iterator;
+
+		IntegerPointCache();
+		/** reset the cache and set the variables the points are compared on
+		 * @param layout: integer part of the points
+		 * @param ignoreGeneralIntegers: compare points on the binaries only
+		 * @param alphaDist: two points with alphas closer than this are considered to have the same alpha
+		 * @param capacity: max number of points kept in the cache (<= 0 means unlimited)
+		 */
+		void setup(PointLayoutPtr layout, bool ignoreGeneralIntegers, double alphaDist, int capacity);
+		/** remove all points (keeps the setup) */
+		void clear();
+		// accessors
+		bool empty() const { return points.empty(); }
+		std::size_t size() const { return points.size(); }
+		const Point &front() const { return points.front(); }
+		const_iterator begin() const { return points.begin(); }
+		const_iterator end() const { return points.end(); }
+		/** add a new point as the most recent one */
+		void push_front(double alpha, const std::vector<double> &x) { push_front(alpha, x, hash(x)); }
+		/** is x the same as the most recent point (regardless of alpha)? */
+		bool sameAsLast(const std::vector<double> &x) { return sameAsLast(x, hash(x)); }
+		/** has (alpha, x) been visited already? */
+		bool contains(double alpha, const std::vector<double> &x) { return contains(alpha, x, hash(x)); }
+		/** same as above, for a vector x whose hash h is known already */
+		void push_front(double alpha, const std::vector<double> &x, uint64_t h);
+		bool sameAsLast(const std::vector<double> &x, uint64_t h) const;
+		bool contains(double alpha, const std::vector<double> &x, uint64_t h);
+		/** hash of the integer part of x */
+		uint64_t hash(const std::vector<double> &x);
+		/** hash of the integer part of x, which differs from the last hashed vector at most in the columns changed */
+		uint64_t hash(const std::vector<double> &x, const std::vector<int> &changed);
+		// stats
+		int historyHits() const { return numHistoryHits; }
+		std::size_t historySize() const { return history.size(); }
+		static const int HISTORY_PER_POINT;
+
+	private:
+		PointLayoutPtr layout;
+		bool ignoreGenerals;
+		std::vector<int> subset; /**< vars the hash is computed on */
+		double alphaDist;
+		int capacity;
+		std::list<Point> points;
+		std::unordered_multimap<uint64_t, const_iterator> index;
+		// incremental hashing
+		std::vector<long long> hashedVals; /**< integer values of the last hashed vector (aligned with subset) */
+		uint64_t currHash;
+		// long history
+		std::unordered_multimap<uint64_t, double> history;		  /**< hash -> alpha of the evicted points */
+		std::deque<std::pair<uint64_t, double>> historyOrder; /**< evicted points, oldest first */
+		int numHistoryHits;
+		// helpers
+		int64_t alphaBucket(double a) const;
+		void rehash(int k, long long v); //< move component k of subset to value v
+	};
+
+} // namespace dominiqs
+
+#endif /* INTCACHE_H */
@@ -0,0 +1,65 @@
+/**
+ * @file jumprepair.h
+ * @brief Feasibility Jump style local search repair of rounded points
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#ifndef JUMPREPAIR_H
+#define JUMPREPAIR_H
+
+#include <vector>
+#include <utility>
+
+#include <utils/randgen.h>
+
+#include "kernelpump/rowactivity.h"
+
+namespace dominiqs
+{
+
+	/**
+	 * @brief Weighted local search moving a point towards feasibility
+	 *
+	 * Each move sets a single variable to its jump value, i.e., the value within its bounds
+	 * minimizing the weighted violation of its rows given the other variables (integer
+	 * variables only take integer values). Candidate variables are sampled from violated rows
+	 * and the move decreasing most the weight of the violated rows is taken; at local minima
+	 * the weights of the violated rows are increased.
+	 * Row weights survive across calls (until the next init()), so that rows which are hard
+	 * to satisfy are favoured from the start when repairing the next point.
+	 */
+	class JumpRepair
+	{
+	public:
+		JumpRepair() = default;
+		void init(ConstraintStorePtr rows, const std::vector<char> &xType, uint64_t seed, double _eps = defaultEPS);
+		/**
+		 * do at most maxMoves moves on x, keeping it within [lb,ub]
+		 * activity must hold the row activities of x and is moved along with it
+		 * @return true if x is feasible at the end (x is left at the last point visited in any case)
+		 */
+		bool repair(std::vector<double> &x, RowActivity &activity, const std::vector<double> &lb, const std::vector<double> &ub, int maxMoves);
+		/** total number of moves done since init() */
+		int movesDone() const { return moves; }
+
+	private:
+		ConstraintStorePtr store;
+		const ConstraintStore::Columns *cols = nullptr;
+		std::vector<char> xType;
+		double eps = defaultEPS;
+		std::vector<double> weight;
+		std::vector<int> lastMoved; /**< move at which each variable was last changed (tabu) */
+		int moves = 0;
+		STLRandGen rnd;
+		std::vector<std::pair<double, double>> events; /**< (breakpoint, slope increase) of the weighted violation */
+		// helpers
+		double jumpTarget(const RowActivity &activity, int j, double xj, double lb, double ub);
+		double moveScore(const RowActivity &activity, int j, double xj, double value) const;
+	};
+
+} // namespace dominiqs
+
+#endif /* JUMPREPAIR_H */
@@ -2,9 +2,14 @@
 
 #include "kernelpump/mipmodel.h"
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <future>
+#include <functional>
 #include <boost/dynamic_bitset.hpp>
 #include <utils/timer.h>
 #include "kernelpump/feaspump.h"
+#include "kernelpump/bucketscheduler.h"
 
 using namespace dominiqs;
 
@@ -13,10 +18,18 @@ class IloNumArray;
 class KernelPump
 {
 public:
+    /** must return a new empty model (with its own solver environment), called from the speculative pump threads */
+    typedef std::function<MIPModelPtr()> ModelFactory;
+
     explicit KernelPump() = default;
     virtual ~KernelPump() = default;
 
     void readConfig();
+    /** needed by the speculative pumps (kp.speculativeBuckets > 0), which cannot share the solver environment of the model */
+    void setModelFactory(ModelFactory factory)
+    {
+        model_factory_ = factory;
+    }
     bool Init(MIPModelPtr problem);
     bool Run(double time_limit);
 
@@ -27,7 +40,7 @@ public:
     }
     int getIterations() const
     {
-        return feasibility_pump_.getIterations();
+        return feasibility_pump_.getIterations() + speculative_iterations_;
     }
 
     double getClosestDist() const
@@ -70,12 +83,50 @@ public:
     void getSolution(std::vector<double> &solution) const;
 
 private:
+    // outcome of pumping on a reference kernel.
+    struct BucketResult
+    {
+        bool found_int_feasible_solution = false;
+        bool feasible_fp = false;
+        double closest_dist = INFBOUND;
+        std::vector<double> closest_frac; // only filled if closest_dist improves on the one the pump started from.
+        std::vector<double> solution;
+        double primal_bound = INFBOUND;
+        double time = 0.0; // wall-clock time of the pump.
+        int iterations = 0;
+        int cycles = 0;
+        IterBudget used; // pumping iterations charged to the limits of the pump.
+    };
+
+    // pump running (in its own thread, on its own model) on the reference kernel of a future bucket.
+    struct SpeculativeBucket
+    {
+        int bucket_index = -1;
+        boost::dynamic_bitset<> kernel; // kernel at launch time: the reference kernel is kernel | bucket.
+        double closest_dist = INFBOUND; // closest distance at launch time (the pump starts from the corresponding point).
+        double time_limit = 0.0;        // time limit of the pump, which might differ from the budget of the bucket once its turn comes.
+        IterBudget budget;              // iteration limits of the serial pump at launch time (at least the ones it has once the turn of the bucket comes).
+        LPBasis start_basis;            // warm start of the first LP, if start_basis_space is the model space of the pump.
+        int start_basis_space = -1;
+        bool on_base = false;           // the pump is initialized on its own copy of the pump base model.
+        std::unique_ptr<FeasibilityPump> pump;
+        MIPModelPtr model;
+        std::atomic<bool> stop{false};
+        std::future<BucketResult> result;
+    };
+
     FeasibilityPump feasibility_pump_;
     boost::dynamic_bitset<> binaries_;
     boost::dynamic_bitset<> gintegers_;
     boost::dynamic_bitset<> continuous_;
 
     bool BuildKernelAndBuckets(double time_limit);
+    void ReferenceKernelBounds(const boost::dynamic_bitset<> &active_binaries, std::vector<int> &cols, std::vector<double> &lbs, std::vector<double> &ubs) const;
+    bool InitPump(const boost::dynamic_bitset<> &active_binaries);
+    BucketResult PumpBucket(FeasibilityPump &pump, double time_limit, bool stop_with_no_impr_limit, const std::vector<double> &closest_frac, double closest_dist) const;
+    void LaunchSpeculativeBuckets(int curr_bucket_index, const boost::dynamic_bitset<> &curr_reference_kernel, double min_time_per_bucket, double time_limit);
+    SpeculativeBucket *FindSpeculativeBucket(int bucket_index);
+    void StopSpeculativeBuckets();
     int addVarToBucket(int var_index, const std::vector<double> &var_values, boost::dynamic_bitset<> &curr_bucket_bitset, boost::dynamic_bitset<> &total_added_vars_bitset) const;
     void PrintKernelAndBuckets();
 
@@ -95,8 +146,19 @@ private:
     bool has_presolve_ = false;
     int first_bucket_to_iter_pump_ = -1; // first bucket for which the feasibility pump is able to iterate (find problem LP feasible and not MIP infeasible in the presolve).
     std::vector<double> solution_;
+    MIPModelPtr pump_base_model_;   // copy of pristine_model_ the pump has been initialized (and presolved) on.
+    MIPModelPtr pristine_model_;    // copy of model_ before any bucket bounds (the pump base model is presolved in place).
+    std::vector<double> binaries_lb_; // lower bounds of the binaries in model_.
+    bool pump_on_base_ = false;       // the pump is initialized on pump_base_model_ (and not on a bucket of its own).
+    LPBasis kernel_basis_;            // last optimal LP basis of the pump, carried to the next reference kernel.
+    int kernel_basis_space_ = -1;     // PumpModelSpace() of the pump kernel_basis_ belongs to.
     int num_binary_vars_with_value_1_in_solution_ = 0;
-    std::shared_ptr<std::vector<boost::dynamic_bitset<>>> cols_dependency_;
+    VariableGraphPtr cols_dependency_;
+    std::vector<std::unique_ptr<SpeculativeBucket>> speculative_; // in flight, by increasing bucket index.
+    std::vector<std::unique_ptr<SpeculativeBucket>> discarded_;   // stopped, waiting to be joined.
+    int speculative_iterations_ = 0;                              // pumping iterations of the speculative results used.
+    ModelFactory model_factory_;                                  // fresh models for the speculative pumps.
+    BucketScheduler scheduler_;
 
     // parameters.
     bool try_enforce_feasibility_initial_kernel_ = false;
@@ -111,4 +173,9 @@ private:
     bool buckets_by_variable_dependency_ = false;
     int num_bucket_layers_ = 0;
     int max_size_buckets_ = 0;
+    bool presolve_once_ = true;         // presolve only once per run, and re-enter the pump with the bucket bounds.
+    int dependency_max_row_length_ = 0; // rows longer than this are ignored in the variable dependency (0 = no limit).
+    int speculative_buckets_ = 0;       // number of next buckets pumped concurrently with the current one (0 = serial).
+    bool adaptive_schedule_ = false;    // re-plan the time budget of each bucket from the progress so far (even split otherwise).
+    bool warm_start_basis_ = true;      // start the first LP of each bucket from the last optimal basis of the previous one.
 };
\ No newline at end of file
@@ -14,10 +14,15 @@
 #include <vector>
 #include <unordered_set>
 #include <memory>
+#include <future>
+#include <algorithm>
 #include <utils/maths.h>
 #include <utils/asserter.h>
 #include <utils/consolelog.h>
 #include <boost/dynamic_bitset.hpp>
+#include "kernelpump/constraintstore.h"
+#include "kernelpump/vargraph.h"
+#include "kernelpump/modelreader.h"
 
 using namespace dominiqs;
 
@@ -37,7 +42,8 @@ enum class IntParam
 	PdlpWarmStart,
 	Presolve,
 	FeasOptMode,
-	Emphasis
+	Emphasis,
+	DualReductions
 };
 
 enum class DblParam
@@ -64,18 +70,174 @@ enum class DblAttr
 	MIPDualBound
 };
 
+/**
+ * @brief Simplex basis in a solver-neutral encoding
+ *
+ * The status codes are those of CPLEX, Xpress and SCIP LPI alike (nonbasic at lower bound,
+ * basic, nonbasic at upper bound, free nonbasic/superbasic).
+ * Row statuses refer to the slack of each row.
+ */
+struct LPBasis
+{
+	enum Status : char
+	{
+		AtLower = 0,
+		Basic = 1,
+		AtUpper = 2,
+		Free = 3
+	};
+	std::vector<char> cols;
+	std::vector<char> rows;
+	bool empty() const { return cols.empty() && rows.empty(); }
+	void clear()
+	{
+		cols.clear();
+		rows.clear();
+	}
+	/**
+	 * adapt the basis to a model with the same leading columns and rows, and possibly some more
+	 * or less trailing ones (as the columns and rows appended by the pump): new columns are
+	 * nonbasic at their lower bound, new rows have a basic slack.
+	 * The number of basic statuses is then made equal to the number of rows again, by demoting
+	 * basic columns (last first) or promoting nonbasic slacks: the result may still be singular,
+	 * which the solvers repair.
+	 */
+	void fit(int ncols, int nrows)
+	{
+		cols.resize(ncols, AtLower);
+		rows.resize(nrows, Basic);
+		int basics = std::count(cols.begin(), cols.end(), Basic) + std::count(rows.begin(), rows.end(), Basic);
+		for (int j = ncols - 1; (j >= 0) && (basics > nrows); j--)
+		{
+			if (cols[j] == Basic)
+			{
+				cols[j] = AtLower;
+				basics--;
+			}
+		}
+		for (int i = 0; (i < nrows) && (basics < nrows); i++)
+		{
+			if (rows[i] != Basic)
+			{
+				rows[i] = Basic;
+				basics++;
+			}
+		}
+	}
+};
+
 /* Interface for a MIP model and solver */
 class MIPModelI
 {
 public:
 	virtual ~MIPModelI() {}
-	std::unique_ptr<MIPModelI> clone() const { return std::unique_ptr<MIPModelI>(this->clone_impl()); }
+	std::unique_ptr<MIPModelI> clone() const
+	{
+		std::unique_ptr<MIPModelI> copy(this->clone_impl());
+		// the constraint store is immutable: share it if the matrix has not changed since it was built
+		if (constraints && (constraintsVersion == matrixVersion))
+		{
+			copy->constraints = constraints;
+			copy->constraintsVersion = copy->matrixVersion;
+		}
+		return copy;
+	}
 	/* Read/Write */
 	virtual void readModel(const std::string &filename) = 0;
+	/** bulk copy of a model read by readModelFile() into an empty problem (default: column by column, then row by row) */
+	virtual void loadModel(const ModelData &data)
+	{
+		DOMINIQS_ASSERT((nrows() == 0) && (ncols() == 0));
+		objSense((ObjSense)data.objSense);
+		objOffset(data.objOffset);
+		for (int j = 0; j < data.ncols(); j++)
+			addEmptyCol(std::string(data.colNames[j]), data.ctype[j], data.lb[j], data.ub[j], data.obj[j]);
+		for (int i = 0; i < data.nrows(); i++)
+		{
+			int beg = data.rowBeg[i];
+			addRow(std::string(data.rowNames[i]), data.rowIdx.data() + beg, data.rowVal.data() + beg, data.rowBeg[i + 1] - beg,
+				   data.sense[i], data.rhs[i], data.range[i]);
+		}
+	}
+	/** bulk copy of the current problem (the inverse of loadModel), e.g., to load it into a model with its own solver environment */
+	void getModelData(ModelData &data) const
+	{
+		int n = ncols();
+		int m = nrows();
+		data = ModelData();
+		data.objSense = (int)objSense();
+		data.objOffset = objOffset();
+		std::vector<std::string> names;
+		colNames(names);
+		for (const std::string &name : names)
+			data.colNames.push(name);
+		rowNames(names);
+		for (const std::string &name : names)
+			data.rowNames.push(name);
+		data.obj.resize(n);
+		data.lb.resize(n);
+		data.ub.resize(n);
+		data.ctype.resize(n);
+		if (n > 0)
+		{
+			objcoefs(data.obj.data());
+			lbs(data.lb.data());
+			ubs(data.ub.data());
+			ctypes(data.ctype.data());
+		}
+		data.sense.resize(m);
+		data.rhs.resize(m);
+		data.range.resize(m);
+		if (m > 0)
+		{
+			sense(data.sense.data());
+			rhs(data.rhs.data());
+			range(data.range.data());
+		}
+		// matbeg might not have the trailing nnz entry
+		dominiqs::SparseMatrix matrix;
+		rows(matrix);
+		data.rowBeg.assign(matrix.matbeg.begin(), matrix.matbeg.begin() + m);
+		data.rowBeg.push_back(matrix.nnz);
+		data.rowIdx.assign(matrix.matind.begin(), matrix.matind.begin() + matrix.nnz);
+		data.rowVal.assign(matrix.matval.begin(), matrix.matval.begin() + matrix.nnz);
+		cols(matrix);
+		data.colBeg.assign(matrix.matbeg.begin(), matrix.matbeg.begin() + n);
+		data.colBeg.push_back(matrix.nnz);
+		data.colIdx.assign(matrix.matind.begin(), matrix.matind.begin() + matrix.nnz);
+		data.colVal.assign(matrix.matval.begin(), matrix.matval.begin() + matrix.nnz);
+	}
+	/** read the model with the in-tree MPS/LP reader (see modelreader.h) instead of the solver one */
+	void readModelNative(const std::string &filename, int threads = 0)
+	{
+		ModelData data;
+		readModelFile(filename, data, threads);
+		loadModelNative(data);
+	}
+	/** load a model read natively (or from a snapshot): the CSR arrays of data are moved into the constraint store */
+	void loadModelNative(ModelData &data)
+	{
+		loadModel(data);
+		// the reader has the matrix row-wise already: no need to extract it back from the solver
+		constraints = std::make_shared<const ConstraintStore>(data.ncols(), std::move(data.rowBeg), std::move(data.rowIdx), std::move(data.rowVal),
+															  std::move(data.sense), std::move(data.rhs), std::move(data.range));
+		constraintsVersion = matrixVersion;
+		dependency = nullptr;
+	}
 	virtual void writeModel(const std::string &filename, const std::string &format = "") const = 0;
 	virtual void writeSol(const std::string &filename) const = 0;
 	/* Solve */
 	virtual bool lpopt(char method, bool decrease_tol, bool initial) = 0;
+	/**
+	 * start lpopt() in the background and return its outcome as a future.
+	 * The model must not be accessed (not even read) until the future is ready.
+	 * The default runs lpopt() in a separate thread: solvers with a native asynchronous API may override it.
+	 */
+	virtual std::future<bool> lpoptAsync(char method, bool decrease_tol, bool initial)
+	{
+		return std::async(std::launch::async, [this, method, decrease_tol, initial]()
+						  { return lpopt(method, decrease_tol, initial); });
+	}
 	virtual int status() const = 0;
 	virtual bool mipopt() = 0;
 	/* Presolve/Postsolve */
@@ -84,11 +246,18 @@ public:
 	std::unique_ptr<MIPModelI> presolvedModel() const { return std::unique_ptr<MIPModelI>(this->presolvedmodel_impl()); }
 	virtual std::vector<double> postsolveSolution(const std::vector<double> &preX) const = 0; /* get solution vector in the original space */
 	virtual std::vector<double> presolveSolution(const std::vector<double> &origX) const = 0; /* get solution vector in the presolved space */
+	/* map each column to its index in the presolved model (-1 if removed). Returns false if not available */
+	virtual bool presolvedColMap(std::vector<int> &) const { return false; }
 	/* Get solution */
 	virtual double objval() const = 0;
 	virtual void sol(double *x, int first = 0, int last = -1) const = 0;
 	virtual void reduced_costs(double *x, int first = 0, int last = -1) const = 0;
 	virtual bool isPrimalFeas() const = 0;
+	/* Basis (only for simplex-based solvers, otherwise false is returned) */
+	/** get the basis of the last LP solved, if an optimal one is available */
+	virtual bool getBasis(LPBasis &) const { return false; }
+	/** install a starting basis for the next LP (it must have the size of the model, see LPBasis::fit()) */
+	virtual bool setBasis(const LPBasis &) { return false; }
 	/* Parameters */
 	virtual void handleCtrlC(bool flag) = 0;
 	virtual bool aborted() const = 0;
@@ -176,17 +345,18 @@ public:
 		return {integrality_gap, num_infeas_values};
 	}
 
-	std::shared_ptr<std::vector<ConstraintPtr>> rows()
+	ConstraintStorePtr rows()
 	{
 		if (!constraints)
 			retrieveConstraints_impl();
 		return constraints;
 	}
 
-	std::shared_ptr<std::vector<boost::dynamic_bitset<>>> colsDependency()
+	/** variable interaction graph (rows longer than maxRowLength are ignored, if positive) */
+	VariableGraphPtr colsDependency(int maxRowLength = 0)
 	{
-		if (!dependency)
-			retrieveDependency_impl();
+		if (!dependency || (dependency->maxRowLength() != maxRowLength))
+			dependency = std::make_shared<const VariableGraph>(rows(), maxRowLength);
 		return dependency;
 	}
 
@@ -241,7 +411,7 @@ public:
 		const auto &rows = *(this->rows());
 		for (auto c : rows)
 		{
-			if (!c->satisfiedBy(&x[0]))
+			if (!c.satisfiedBy(&x[0]))
 				return false;
 		}
 		return true;
@@ -253,10 +423,12 @@ public:
 		colsDependency();
 		std::vector<std::string> xNames;
 		colNames(xNames);
+		std::vector<int> neighbors;
 		for (int i = 0; i < dependency->size(); ++i)
 		{
 			std::string dep_list;
-			for (int j = ((*dependency)[i]).find_first(); j != boost::dynamic_bitset<>::npos; j = ((*dependency)[i]).find_next(j))
+			dependency->neighbors(i, neighbors);
+			for (int j : neighbors)
 			{
 				dep_list += xNames[j] + " ";
 			}
@@ -282,9 +454,29 @@ public:
 	virtual void lbs(int cnt, const int *cols, const double *values) = 0;
 	virtual void ub(int cidx, double val) = 0;
 	virtual void ubs(int cnt, const int *cols, const double *values) = 0;
+	virtual void rhs(int cnt, const int *rows, const double *values) = 0;
 	virtual void fixCol(int cidx, double val) = 0;
 	virtual void objcoef(int cidx, double val) = 0;
 	virtual void objcoefs(int cnt, const int *cols, const double *values) = 0;
+	/** change only the objective coefficients of the columns whose value differs between oldValues and newValues
+	 * (oldValues is the objective currently installed in the model). Returns the number of changed coefficients.
+	 */
+	virtual int objcoefsDiff(int cnt, const int *cols, const double *oldValues, const double *newValues)
+	{
+		std::vector<int> diffCols;
+		std::vector<double> diffValues;
+		for (int k = 0; k < cnt; k++)
+		{
+			if (oldValues[k] != newValues[k])
+			{
+				diffCols.push_back(cols[k]);
+				diffValues.push_back(newValues[k]);
+			}
+		}
+		if (diffCols.size())
+			objcoefs(diffCols.size(), &diffCols[0], &diffValues[0]);
+		return diffCols.size();
+	}
 	virtual void ctype(int cidx, char val) = 0;
 	virtual void ctypes(int cnt, const int *cols, const char *values) = 0;
 	virtual void switchToLP() = 0;
@@ -295,29 +487,6 @@ public:
 private:
 	virtual MIPModelI *clone_impl() const = 0;
 	virtual MIPModelI *presolvedmodel_impl() const = 0;
-	void retrieveDependency_impl()
-	{
-		int nCols = ncols();
-		dependency = std::make_shared<std::vector<boost::dynamic_bitset<>>>(nCols, boost::dynamic_bitset<>(nCols, 0));
-		const auto &rows = *(this->rows());
-		// for (int rowIndex = 0; rowIndex < rows.size(); ++rowIndex)
-		// {
-		// 	(*dependency)[rowIndex] = std::list<int>();
-		for (const auto &constraint : rows)
-		{
-			for (int i = 0; i < constraint->row.capacity(); ++i)
-			{
-				int var_i_index = constraint->row.idx()[i];
-				for (int j = i + 1; j < constraint->row.capacity(); ++j)
-				{
-					int var_j_index = constraint->row.idx()[j];
-					(*dependency)[var_i_index][var_j_index] = 1;
-					(*dependency)[var_j_index][var_i_index] = 1;
-				}
-			}
-		}
-	}
-
 	void retrieveConstraints_impl()
 	{
 		dominiqs::SparseMatrix matrix;
@@ -331,73 +500,28 @@ private:
 		std::vector<double> rngval(end, 0.0);
 
 		// here to correctly handle empty constraints
-		// get rhs
-		this->rhs(&rhs[0], beg, end - 1);
-		// get sense
-		this->sense(&sense[0], beg, end - 1);
-		// get rngval
-		this->range(&rngval[0], beg, end - 1);
-
-		constraints = std::make_unique<std::vector<ConstraintPtr>>(end);
-		// std::cout << constraints->size() << std::endl;
-		// for (int i = 0; i < constraints.size(); ++i)
-		// 	std::cout << *(constraints)[i] << std::endl;
-		// getchar();
-		// getchar();
-		for (int i = 0; i < end; ++i)
+		if (end > 0)
 		{
-			(*constraints)[i] = std::make_shared<Constraint>();
-			// CPLEX treats ranged rows considering the constraint satisfied
-			// if the linear expression is in the range [rhs, rhs+rngval].
-			// However, we interpret ranged rows differently, and the allowed
-			// range is [rhs-rngval,rhs] (in both cases, rngval >= 0).
-			// So we might have to update the rhs
-			if (sense[i] == 'R')
-			{
-				DOMINIQS_ASSERT(rngval[i] >= 0.0);
-				(rhs[i]) += rngval[i];
-			}
-
-			// fill the actual Constraint objects with the previously filled structures.
-			auto &curr_constraint = *((*constraints)[i]);
-			curr_constraint.sense = sense[i];
-			curr_constraint.rhs = rhs[i];
-			curr_constraint.range = rngval[i];
-
-			// compute number of non-zero entries in constraint coefficient vector.
-			// if last row, the end of the sub-vector of its corresponding indexes/values is the end of the matind/matval (position matrix.nnz-1)
-			int constraint_nnz = i < end - 1 ? matrix.matbeg[i + 1 - beg] - matrix.matbeg[i - beg] : matrix.nnz - matrix.matbeg[i - beg];
-			// beg  ==0, and could be omitted.
-			// just to be aware: when a given row is empty (has no non-zero coefficient), the corresponding matbeg (begin of its elements
-			// in matval and matind corresponds to the same begin of the next - non-empty - constraint). So, it is safe to always consider, for a row i, the
-			// number of non-zero elements as (matbeg[i+1] - matbeg[i]), even when i is empty! Case empty, matbeg[i+1] - matbeg[i] == 0,
-
-			// std::cout << "constraint " << i << std::endl;
-			// std::cout << "matbeg: " << matrix.matbeg[i] << std::endl;
-			// if (constraint_nnz > 0)
-			// 	std::cout << "range: " << "[" << matrix.matbeg[i] << "," << matrix.matbeg[i] + constraint_nnz - 1 << "]" << std::endl;
-			// else
-			// 	std::cout << "range: -" << std::endl;
-
-			auto &row = curr_constraint.row;
-			if (constraint_nnz > 0)
-			{
-				row.resize(constraint_nnz);
-				for (int j = 0; j < constraint_nnz; ++j)
-				{
-					auto index = matrix.matbeg[i - beg] + j;
-					row.idx()[j] = matrix.matind[index];
-					row.coef()[j] = matrix.matval[index];
-				}
-			}
-			else
-				row.clear();
+			// get rhs
+			this->rhs(&rhs[0], beg, end - 1);
+			// get sense
+			this->sense(&sense[0], beg, end - 1);
+			// get rngval
+			this->range(&rngval[0], beg, end - 1);
 		}
+
+		// a single contiguous copy of the matrix (ranged rows are converted by the store)
+		constraints = std::make_shared<const ConstraintStore>(ncols(), matrix, sense, rhs, rngval);
+		constraintsVersion = matrixVersion;
 	}
+	unsigned long matrixVersion = 0;	  // number of changes to the matrix (or the rhs) so far
+	unsigned long constraintsVersion = 0; // matrixVersion the constraint store was built at
 
 protected:
-	std::shared_ptr<std::vector<ConstraintPtr>> constraints = nullptr;			// must be computed just once, at the first call of rows(void).
-	std::shared_ptr<std::vector<boost::dynamic_bitset<>>> dependency = nullptr; // must be computed just once, at the first call of colsDependency(void).
+	/** to be called by every method changing the matrix or the rhs: clones no longer share the constraint store */
+	void matrixChanged() { matrixVersion++; }
+	ConstraintStorePtr constraints = nullptr;									// must be computed just once, at the first call of rows(void). Shared by clones.
+	VariableGraphPtr dependency = nullptr;										// computed at the first call of colsDependency().
 };
 
 using MIPModelPtr = std::shared_ptr<MIPModelI>;
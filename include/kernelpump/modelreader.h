@@ -0,0 +1,133 @@
+/**
+ * @file modelreader.h
+ * @brief Native MPS/LP model reader
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#ifndef MODELREADER_H
+#define MODELREADER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dominiqs
+{
+
+	/**
+	 * @brief Interned table of names: all the names live in a single character pool
+	 */
+	class NameTable
+	{
+	public:
+		int size() const { return (int)start.size() - 1; }
+		std::string_view operator[](int i) const { return std::string_view(pool.data() + start[i], start[i + 1] - start[i] - 1); }
+		/** zero terminated name (for the solver APIs) */
+		const char *c_str(int i) const { return pool.data() + start[i]; }
+		void push(std::string_view name)
+		{
+			pool.append(name.data(), name.size());
+			pool.push_back('\0');
+			start.push_back(pool.size());
+		}
+		void reserve(int n, std::size_t chars)
+		{
+			start.reserve(n + 1);
+			pool.reserve(chars);
+		}
+		void clear()
+		{
+			pool.clear();
+			start.assign(1, 0);
+		}
+		// raw access (for serialization)
+		const std::string &chars() const { return pool; }
+		const std::vector<std::size_t> &offsets() const { return start; }
+		void assign(std::string_view chars, const std::size_t *offsets, int n)
+		{
+			pool.assign(chars.data(), chars.size());
+			start.assign(offsets, offsets + n + 1);
+		}
+
+	private:
+		std::string pool;
+		std::vector<std::size_t> start = {0};
+	};
+
+	/**
+	 * @brief A MIP model as read from file, in the layout expected by the solver bulk-copy APIs
+	 *
+	 * Senses are 'L', 'G', 'E' and 'R', with ranged rows in solver convention, i.e.,
+	 * the linear expression must be in [rhs, rhs+range].
+	 * The objective sense is +1 (min) or -1 (max), as ObjSense.
+	 */
+	struct ModelData
+	{
+		std::string name;
+		int objSense = 1;
+		double objOffset = 0.0;
+		std::string objName;
+		// columns
+		NameTable colNames;
+		std::vector<double> obj;
+		std::vector<double> lb;
+		std::vector<double> ub;
+		std::vector<char> ctype;
+		// rows
+		NameTable rowNames;
+		std::vector<char> sense;
+		std::vector<double> rhs;
+		std::vector<double> range;
+		// matrix, both row-wise (CSR) and column-wise (CSC)
+		std::vector<int> rowBeg; /**< size nrows+1 */
+		std::vector<int> rowIdx;
+		std::vector<double> rowVal;
+		std::vector<int> colBeg; /**< size ncols+1 */
+		std::vector<int> colIdx;
+		std::vector<double> colVal;
+		// info
+		int nrows() const { return sense.size(); }
+		int ncols() const { return ctype.size(); }
+		int nnz() const { return rowIdx.size(); }
+	};
+
+	/**
+	 * @brief Read-only contents of a file: mapped in memory if plain, inflated in memory if
+	 * gzipped (and inflate is true)
+	 */
+	class FileBuffer
+	{
+	public:
+		explicit FileBuffer(const std::string &filename, bool inflate = true);
+		~FileBuffer();
+		FileBuffer(const FileBuffer &) = delete;
+		FileBuffer &operator=(const FileBuffer &) = delete;
+		const char *begin() const { return ptr; }
+		const char *end() const { return ptr + len; }
+		std::size_t size() const { return len; }
+
+	private:
+		std::string inflated;
+		void *mapped = nullptr;
+		const char *ptr = "";
+		std::size_t len = 0;
+	};
+
+	/**
+	 * Read a model in free/fixed MPS or CPLEX LP format, possibly gzipped (the format is deduced
+	 * from the extension: .mps, .lp, optionally followed by .gz).
+	 * The COLUMNS section of MPS files is parsed by @param threads threads (0 = one per core).
+	 * Integer columns with bounds [0,1] get type 'B'.
+	 * Throws std::runtime_error on parse errors or unsupported features (SOS, quadratic terms, ...).
+	 */
+	void readModelFile(const std::string &filename, ModelData &data, int threads = 0);
+
+	/** true if readModelFile() can read the given file */
+	bool canReadModelFile(const std::string &filename);
+
+} // namespace dominiqs
+
+#endif /* MODELREADER_H */
@@ -109,6 +109,7 @@ public:
 	void lbs(int cnt, const int *cols, const double *values) override;
 	void ub(int cidx, double val) override;
 	void ubs(int cnt, const int *cols, const double *values) override;
+	void rhs(int cnt, const int *rows, const double *values) override;
 	void fixCol(int cidx, double val) override;
 	void objcoef(int cidx, double val) override;
 	void objcoefs(int cnt, const int *cols, const double *values) override;
@@ -143,7 +144,8 @@ private:
 	bool verbosity;
 
 	// For PDLP
-	operations_research::pdlp::QuadraticProgram *qp;
+	std::optional<operations_research::pdlp::QuadraticProgram> qp; // kept in sync with solver by the setters (rebuilt only after structural changes)
+	bool qpDirty = true;
 	std::vector<MPVariable *> variables;
 	MPSolver *solver;
 	operations_research::pdlp::TerminationReason result_status;
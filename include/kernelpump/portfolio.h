@@ -0,0 +1,81 @@
+/**
+ * @file portfolio.h
+ * @brief Parallel multi-start Feasibility Pump portfolio
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <exception>
+#include <functional>
+
+#include "kernelpump/feaspump.h"
+
+namespace dominiqs
+{
+
+	/**
+	 * @brief Runs several diversified Feasibility Pumps concurrently
+	 *
+	 * Worker 0 uses the current configuration, the others override the seed, the rounder (fp.frac2int),
+	 * the ranker (fp.ranker) and the alpha schedule (fp.alpha, fp.alphaFactor) picking from the
+	 * portfolio.* lists. Each worker pumps on its own model (and hence its own solver environment).
+	 * All workers share a stop flag: the first one finding a feasible point stops the others.
+	 */
+	class FeasibilityPumpPortfolio
+	{
+	public:
+		/** must return a new model of the problem (with its own solver environment), called from the worker threads */
+		typedef std::function<MIPModelPtr()> ModelFactory;
+
+		FeasibilityPumpPortfolio();
+		void readConfig();
+		/** run all the workers until one finds a solution or all of them give up
+		 * @return true if a feasible solution was found
+		 */
+		bool run(ModelFactory makeModel, double timeLimit);
+		// get solution info (from the worker that found a solution, or the one with the closest point otherwise)
+		bool foundSolution() const { return winner >= 0 && workers[winner].found; }
+		void getSolution(std::vector<double> &x) const;
+		void getClosestFrac(std::vector<double> &frac) const;
+		double getClosestDist() const;
+		/** pumping iterations of all the workers */
+		int getIterations() const;
+		int getWinner() const { return winner; }
+		int numWorkers() const { return nWorkers; }
+
+	private:
+		struct Worker
+		{
+			std::unique_ptr<FeasibilityPump> fp;
+			MIPModelPtr model;
+			bool found = false;
+			std::exception_ptr error;
+		};
+		// config
+		int nWorkers;
+		uint64_t seed;
+		std::vector<std::string> rounders;
+		std::vector<std::string> rankers;
+		std::vector<double> alphas;
+		std::vector<double> alphaFactors;
+		// data
+		std::vector<Worker> workers;
+		std::atomic<bool> stop;
+		int winner;
+		// helpers
+		void setupWorker(int w);
+		void runWorker(int w, ModelFactory makeModel, double timeLimit);
+	};
+
+} // namespace dominiqs
+
+#endif /* PORTFOLIO_H */
@@ -34,6 +34,13 @@ public:
 	virtual void ignoreGeneralIntegers(bool flag);
 	virtual void setCurrentState(const std::vector<double>& x) = 0;
 	virtual int next() = 0;
+	/**
+	 * make the order differ from the one of a ranker with the same config (used to get several
+	 * roundings of the same point): either reverse it, or add noise, with the given seed
+	 */
+	virtual void diversify(bool, uint64_t) {}
+	/** restart the random choices (if any) from the given seed, keeping the rest of the config */
+	virtual void reseed(uint64_t) {}
 protected:
 	DomainPtr domain;
 	std::vector<int> binaries;
@@ -63,6 +70,13 @@ protected:
 /**
  * @brief Rank variables in order of increasing fractionality
  * always preferring binary variables to general integer ones
+ *
+ * Integral variables all have the same score, so they are not sorted at all but
+ * visited in index order; only the fractional ones are bucket sorted. The set of
+ * fractional variables is updated incrementally, looking only at the entries of x
+ * that changed since the previous call.
+ * Rank noise swaps random pairs over the whole order (integral variables included):
+ * when it is applied, the order is built explicitly.
  */
 
 class FractionalityRanker : public Ranker
@@ -72,17 +86,31 @@ public:
 	void ignoreGeneralIntegers(bool flag);
 	void setCurrentState(const std::vector<double>& x);
 	int next();
+	void diversify(bool reverseOrder, uint64_t seed);
+	void reseed(uint64_t seed);
 protected:
 	// options
 	bool reverse;
 	double rankNoise;
 	int noiseAfter;
 	dominiqs::STLRandGen rnd;
-	// data
-	typedef std::pair<double, int> Score;
-	std::vector<Score> scores;
-	std::vector<int> perm;
+	// data (indices are positions in integers)
+	std::vector<double> lastX; //< values at the previous call
+	std::vector<double> viol; //< integrality violations at the previous call
+	std::vector<int> fracPos; //< position in fracList (-1 if integral)
+	std::vector<int> fracList; //< fractional variables (unsorted)
+	std::vector<int> fracOrder; //< fractional variables in rank order
+	std::vector<int> bucketBeg;
+	std::vector<int> perm; //< whole order, built only if noise is applied
+	bool noisy = false; //< next() follows perm
+	unsigned int nBinaries; //< binaries are integers[0, nBinaries)
+	unsigned int fracBinaries; //< binaries are fracOrder[0, fracBinaries) (the tail if reverse)
+	// iterator: segment (integral/fractional binaries/general integers) and position within it
+	int segment;
 	unsigned int nextItr;
+	// helpers
+	void sortFractionals();
+	void buildOrder();
 };
 
 /**
@@ -96,6 +124,8 @@ public:
 	void ignoreGeneralIntegers(bool flag);
 	void setCurrentState(const std::vector<double>& x);
 	int next();
+	void diversify(bool reverseOrder, uint64_t seed);
+	void reseed(uint64_t seed);
 protected:
 	// data
 	dominiqs::STLRandGen rnd;
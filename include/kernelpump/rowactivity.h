@@ -0,0 +1,79 @@
+/**
+ * @file rowactivity.h
+ * @brief Incremental row activities and feasibility status of a point
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#ifndef ROWACTIVITY_H
+#define ROWACTIVITY_H
+
+#include <vector>
+
+#include <utils/floats.h>
+
+#include "kernelpump/constraintstore.h"
+
+namespace dominiqs
+{
+
+	/**
+	 * @brief Keeps the row activities of a current point up to date
+	 *
+	 * Uses the column-major view of the constraint store, so that moving the current
+	 * point costs O(column nnz) per changed variable. The set of violated rows is
+	 * maintained along the way, so feasibility and the number of violated rows are
+	 * answered in O(1) and the max violation in O(#violated).
+	 * Feasibility follows Constraint::satisfiedBy, i.e., a row is violated if its
+	 * violation is larger than eps.
+	 */
+	class RowActivity
+	{
+	public:
+		RowActivity() = default;
+		/** attach to the constraints and set the current point to zero */
+		void init(ConstraintStorePtr rows, double _eps = defaultEPS);
+		/**
+		 * move the current point to x, where only the components in changed may differ from it
+		 * (costs O(|changed|) plus the column nnz of the components that actually changed)
+		 */
+		void update(const std::vector<double> &x, const std::vector<int> &changed);
+		/** move a single component of the current point */
+		void update(int j, double value);
+		/** recompute all activities from scratch for the point x */
+		void set(const std::vector<double> &x);
+		// queries
+		bool isFeasible() const { return violated.empty(); }
+		int numViolated() const { return violated.size(); }
+		double maxViolation() const;
+		const std::vector<int> &violatedRows() const { return violated; }
+		double activity(int i) const { return act[i]; }
+		double violation(int i) const { return std::max(act[i] - hi[i], lo[i] - act[i]); }
+		/** row i must be in [lower(i),upper(i)] (infinite if the side is missing) */
+		double lower(int i) const { return lo[i]; }
+		double upper(int i) const { return hi[i]; }
+
+	private:
+		// column-major matrix
+		ConstraintStorePtr store;
+		const ConstraintStore::Columns *cols = nullptr;
+		// rows
+		std::vector<double> lo;
+		std::vector<double> hi;
+		double eps = defaultEPS;
+		// current point
+		std::vector<double> x;
+		std::vector<double> act;
+		std::vector<int> violated;	  /**< violated rows (unordered) */
+		std::vector<int> violatedPos; /**< row -> position in violated (-1 if satisfied) */
+		int updatesSinceRefresh = 0;
+		// helpers
+		void refresh(); //< recompute all activities of the current point from scratch
+		void updateStatus(int i);
+	};
+
+} // namespace dominiqs
+
+#endif /* ROWACTIVITY_H */
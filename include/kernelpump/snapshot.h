@@ -0,0 +1,47 @@
+/**
+ * @file snapshot.h
+ * @brief Binary model snapshots (.kpbin)
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <cstdint>
+
+#include "kernelpump/modelreader.h"
+
+namespace dominiqs
+{
+
+	/**
+	 * A snapshot stores a ModelData as a header followed by its arrays (8-byte aligned, native
+	 * endianness), so that loading it is a sequence of memcpy from the mapped file.
+	 * The header has a format version and the content hash of the model file it was built from:
+	 * a snapshot with a different version or hash is stale and ignored.
+	 */
+	static const uint32_t SNAPSHOT_VERSION = 1;
+
+	/** 64-bit hash of the (raw, not inflated) contents of a file */
+	uint64_t fileContentHash(const std::string &filename);
+
+	/** write the snapshot of data (built from a model file with the given hash), atomically */
+	void writeSnapshot(const std::string &filename, const ModelData &data, uint64_t sourceHash);
+
+	/** load a snapshot: return false if missing, corrupted or stale (data is then left empty) */
+	bool readSnapshot(const std::string &filename, ModelData &data, uint64_t sourceHash);
+
+	/**
+	 * Read a model file through its snapshot: the snapshot is loaded if up to date, otherwise the
+	 * model is parsed with readModelFile() and the snapshot (re)written.
+	 * Return true if the snapshot was used.
+	 */
+	bool readModelCached(const std::string &filename, const std::string &snapshotFile, ModelData &data, int threads = 0);
+
+} // namespace dominiqs
+
+#endif /* SNAPSHOT_H */
@@ -16,6 +16,7 @@
 
 #include "fp_interface.h"
 #include "ranking.h"
+#include "rowactivity.h"
 
 /**
  * Rounding helpers
@@ -23,6 +24,16 @@
 
 inline void doRound(const double& in, double& out, const double& thr) { out = floor(in + thr); }
 
+/** set out[j] to value, recording j in changed if its value changes */
+inline void setTracked(std::vector<double>& out, int j, double value, std::vector<int>& changed)
+{
+	if (out[j] != value)
+	{
+		out[j] = value;
+		changed.push_back(j);
+	}
+}
+
 inline double getRoundingThreshold(bool isRandom, dominiqs::RandGen& gen)
 {
 	if (isRandom)
@@ -44,13 +55,16 @@ class SimpleRounding : public dominiqs::SolutionTransformer
 public:
 	SimpleRounding();
 	void readConfig();
+	void reseed(uint64_t seed);
 	void init(MIPModelPtr model, bool ignoreGeneralInt = true);
 	void ignoreGeneralIntegers(bool flag);
 	void apply(const std::vector<double>& in, std::vector<double>& out);
+	const std::vector<int>* changedColumns() const { return &changed; }
 protected:
 	std::vector<int> binaries;
 	std::vector<int> gintegers;
 	std::vector<int> integers;
+	std::vector<int> changed; //< columns changed by the last apply()
 	dominiqs::RandGen roundGen;
 	bool randomizedRounding;
 	bool logDetails;
@@ -66,10 +80,19 @@ public:
 	PropagatorRounding();
 	~PropagatorRounding() { clear(); }
 	void readConfig();
+	void reseed(uint64_t seed);
 	void init(MIPModelPtr model, bool ignoreGeneralInt = true);
+	/** re-base the root domain on the new bounds (which must be within the ones of the last init) */
+	bool updateBounds(MIPModelPtr model, bool ignoreGeneralInt = true);
 	void ignoreGeneralIntegers(bool flag);
 	void apply(const std::vector<double>& in, std::vector<double>& out);
 	void clear();
+	/**
+	 * make the roundings differ from the ones of a rounder with the same config (variant > 0):
+	 * a different kind of ranker, ranking with noise or reversed ranking,
+	 * in turn, each with its own random thresholds. Call before init().
+	 */
+	void diversify(int variant, uint64_t seed);
 protected:
 	// data
 	DomainPtr domain;
@@ -78,6 +101,42 @@ protected:
 	std::map<int, PropagatorFactoryPtr> factories;
 	RankerPtr ranker;
 	bool filterConstraints;
+	int maxBacktracks; //< budget of repairs of failed roundings per apply (0 = greedy)
+};
+
+/**
+ * Several diversified propagation roundings of the same point, possibly in parallel
+ *
+ * Each candidate has its own rounder (domain and propagation engine) and its own incremental
+ * row activities. The output is the candidate with the fewest violated rows (ties broken by the
+ * distance from the input, then by candidate index), so the result does not depend on the threads.
+ */
+
+class BatchRounding : public dominiqs::SolutionTransformer
+{
+public:
+	BatchRounding();
+	void readConfig();
+	/** candidate k restarts from seed + k, as the variants of readConfig() */
+	void reseed(uint64_t seed);
+	void init(MIPModelPtr model, bool ignoreGeneralInt = true);
+	bool updateBounds(MIPModelPtr model, bool ignoreGeneralInt = true);
+	void ignoreGeneralIntegers(bool flag);
+	void apply(const std::vector<double>& in, std::vector<double>& out);
+	const std::vector<int>* changedColumns() const { return &changed; }
+	void clear();
+protected:
+	struct Candidate
+	{
+		PropagatorRounding rounder;
+		dominiqs::RowActivity activity;
+		std::vector<double> x;
+	};
+	std::vector<std::unique_ptr<Candidate>> candidates;
+	int numCandidates;
+	int numThreads; //< 0 = one per candidate (up to the number of cores)
+	std::vector<int> changed; //< columns changed by the last apply()
+	void round(int k, const std::vector<double>& in);
 };
 
 #endif /* TRANSFORMERS_H */
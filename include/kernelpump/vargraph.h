@@ -0,0 +1,48 @@
+/**
+ * @file vargraph.h
+ * @brief Sparse variable interaction (co-occurrence) graph
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#ifndef VARGRAPH_H
+#define VARGRAPH_H
+
+#include <vector>
+#include <memory>
+
+#include "kernelpump/constraintstore.h"
+
+namespace dominiqs
+{
+
+	/**
+	 * @brief Graph with an edge between two variables iff they appear together in some constraint
+	 *
+	 * The graph is not stored explicitly: the neighbors of a variable are enumerated on demand
+	 * by walking its column and then the rows it appears in, so memory scales with the number
+	 * of nonzeros of the matrix. Rows longer than maxRowLength (if positive) are ignored, since
+	 * they would connect almost everything to everything.
+	 */
+	class VariableGraph
+	{
+	public:
+		VariableGraph(ConstraintStorePtr rows, int maxRowLength = 0);
+		int size() const { return store->ncols(); }
+		int maxRowLength() const { return maxLen; }
+		/** neighbors of variable j (sorted, without duplicates and without j itself) */
+		void neighbors(int j, std::vector<int> &out) const;
+
+	private:
+		ConstraintStorePtr store;
+		const ConstraintStore::Columns *cols;
+		int maxLen;
+	};
+
+	typedef std::shared_ptr<const VariableGraph> VariableGraphPtr;
+
+} // namespace dominiqs
+
+#endif /* VARGRAPH_H */
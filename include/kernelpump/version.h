@@ -0,0 +1,22 @@
+/**
+ * @file version.h
+ * @brief Automatically generated version
+ *
+ * @author Domenico Salvagnin dominiqs@gmail.com
+ * @author Gioni Mexi gionimexi@gmail.com
+ * Copyright 2019 Domenico Salvagnin
+ */
+
+#ifndef KP_VERSION_H
+#define KP_VERSION_H
+
+const char *KP_VERSION = "1.0";
+
+/**
+ * Git branch/commit to be generated by cmake
+ */
+
+#define KP_GIT_BRANCH "master"
+#define KP_GIT_HASH "06a01403-dirty"
+
+#endif /* KP_VERSION_H */
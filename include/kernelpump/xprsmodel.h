@@ -37,6 +37,9 @@ public:
 	void sol(double *x, int first = 0, int last = -1) const override;
 	void reduced_costs(double *x, int first = 0, int last = -1) const override;
 	bool isPrimalFeas() const override;
+	/* Basis */
+	bool getBasis(LPBasis &basis) const override;
+	bool setBasis(const LPBasis &basis) override;
 	/* Parameters */
 	void handleCtrlC(bool flag) override;
 	bool aborted() const override;
@@ -81,6 +84,7 @@ public:
 	void lbs(int cnt, const int *cols, const double *values) override;
 	void ub(int cidx, double val) override;
 	void ubs(int cnt, const int *cols, const double *values) override;
+	void rhs(int cnt, const int *rows, const double *values) override;
 	void fixCol(int cidx, double val) override;
 	void objcoef(int cidx, double val) override;
 	void objcoefs(int cnt, const int *cols, const double *values) override;
@@ -0,0 +1,84 @@
+/**
+ * @file bucketscheduler.cpp
+ * @brief Adaptive time budget for the buckets of the Kernel Pump
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <algorithm>
+
+#include <utils/asserter.h>
+#include <utils/floats.h>
+
+#include "kernelpump/bucketscheduler.h"
+
+using namespace dominiqs;
+
+static const double DEF_BOOST = 2.0;
+static const int DEF_MIN_ITERATIONS = 10;
+static const double DEF_IMPR_THRESHOLD = 0.05;
+// weight of the last observation in the smoothed time per iteration
+static const double ITER_TIME_WEIGHT = 0.5;
+
+namespace dominiqs
+{
+
+	BucketScheduler::BucketScheduler() : boost(DEF_BOOST), minIterations(DEF_MIN_ITERATIONS), imprThreshold(DEF_IMPR_THRESHOLD)
+	{
+		reset();
+	}
+
+	void BucketScheduler::setup(double _boost, int _minIterations, double _imprThreshold)
+	{
+		DOMINIQS_ASSERT(_boost >= 1.0);
+		boost = _boost;
+		minIterations = std::max(_minIterations, 0);
+		imprThreshold = _imprThreshold;
+	}
+
+	void BucketScheduler::reset()
+	{
+		iterTime = -1.0;
+		improving = false;
+		cycling = false;
+	}
+
+	double BucketScheduler::budget(double timeLeft, int bucketsLeft) const
+	{
+		timeLeft = std::max(timeLeft, 0.0);
+		if (bucketsLeft <= 1)
+			return timeLeft;
+		double fair = timeLeft / bucketsLeft;
+		double share = fair;
+		if (improving)
+			share *= boost;
+		else if (cycling)
+			share /= boost;
+		// the following buckets must keep a minimum share each
+		double maxShare = timeLeft - (bucketsLeft - 1) * fair / boost;
+		if (iterTime > 0.0)
+			share = std::max(share, minIterations * iterTime);
+		return std::min(share, maxShare);
+	}
+
+	void BucketScheduler::record(const BucketProgress &progress)
+	{
+		if (progress.iterations > 0)
+		{
+			double t = progress.time / progress.iterations;
+			iterTime = (iterTime < 0.0) ? t : (ITER_TIME_WEIGHT * t + (1.0 - ITER_TIME_WEIGHT) * iterTime);
+		}
+		if (!progress.lpFeasible)
+		{
+			// failed fast: nothing learned about the pump itself
+			improving = false;
+			cycling = false;
+			return;
+		}
+		improving = lessThan(progress.endDist, progress.startDist * (1.0 - imprThreshold));
+		cycling = !improving && (progress.iterations > 0) && (2 * progress.cycles >= progress.iterations);
+	}
+
+} // namespace dominiqs
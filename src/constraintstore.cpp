@@ -0,0 +1,117 @@
+/**
+ * @file constraintstore.cpp
+ * @brief Contiguous (CSR) storage of the constraints of a model
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include <utils/asserter.h>
+
+#include "kernelpump/constraintstore.h"
+
+using namespace dominiqs;
+
+namespace dominiqs
+{
+
+	double RowView::violation(const double *x) const
+	{
+		double slack = rhs - dotProduct(idx, coef, cnt, x);
+		if (sense == 'L')
+			return -slack;
+		if (sense == 'G')
+			return slack;
+		if (sense == 'R')
+			return std::max(-slack, slack - range);
+		return fabs(slack);
+	}
+
+	void RowView::toConstraint(Constraint &c) const
+	{
+		c.sense = sense;
+		c.rhs = rhs;
+		c.range = range;
+		c.row.resize(cnt);
+		std::copy(idx, idx + cnt, c.row.idx());
+		std::copy(coef, coef + cnt, c.row.coef());
+	}
+
+	ConstraintStore::ConstraintStore(int ncols, const SparseMatrix &matrix, const std::vector<char> &sense,
+									 const std::vector<double> &rhs, const std::vector<double> &range)
+		: numCols(ncols), senses(sense), rhss(rhs), ranges(range)
+	{
+		int m = senses.size();
+		DOMINIQS_ASSERT((int)rhss.size() == m);
+		DOMINIQS_ASSERT((int)ranges.size() == m);
+		// matbeg might not have the trailing nnz entry
+		rowStart.resize(m + 1);
+		for (int i = 0; i < m; i++)
+			rowStart[i] = matrix.matbeg[i];
+		rowStart[m] = matrix.nnz;
+		colIdx.assign(matrix.matind.begin(), matrix.matind.begin() + matrix.nnz);
+		coefs.assign(matrix.matval.begin(), matrix.matval.begin() + matrix.nnz);
+		convertRanges();
+	}
+
+	ConstraintStore::ConstraintStore(int ncols, std::vector<int> &&_rowStart, std::vector<int> &&_colIdx, std::vector<double> &&_coefs,
+									 std::vector<char> sense, std::vector<double> rhs, std::vector<double> range)
+		: numCols(ncols), rowStart(std::move(_rowStart)), colIdx(std::move(_colIdx)), coefs(std::move(_coefs)),
+		  senses(std::move(sense)), rhss(std::move(rhs)), ranges(std::move(range))
+	{
+		DOMINIQS_ASSERT(rowStart.size() == senses.size() + 1);
+		DOMINIQS_ASSERT(rhss.size() == senses.size());
+		DOMINIQS_ASSERT(ranges.size() == senses.size());
+		DOMINIQS_ASSERT(rowStart.back() == (int)colIdx.size());
+		convertRanges();
+	}
+
+	void ConstraintStore::convertRanges()
+	{
+		for (int i = 0; i < size(); i++)
+		{
+			// solvers treat ranged rows as [rhs, rhs+range], while we use [rhs-range,rhs]
+			if (senses[i] == 'R')
+			{
+				DOMINIQS_ASSERT(ranges[i] >= 0.0);
+				rhss[i] += ranges[i];
+			}
+		}
+	}
+
+	const ConstraintStore::Columns &ConstraintStore::columns() const
+	{
+		std::call_once(columnsFlag, [this]()
+					   {
+			int m = size();
+			cols.start.assign(numCols + 1, 0);
+			for (int j : colIdx)
+				cols.start[j + 1]++;
+			for (int j = 0; j < numCols; j++)
+				cols.start[j + 1] += cols.start[j];
+			cols.rowIdx.resize(colIdx.size());
+			cols.coef.resize(colIdx.size());
+			std::vector<int> next(cols.start.begin(), cols.start.end() - 1);
+			for (int i = 0; i < m; i++)
+			{
+				for (int k = rowStart[i]; k < rowStart[i + 1]; k++)
+				{
+					int pos = next[colIdx[k]]++;
+					cols.rowIdx[pos] = i;
+					cols.coef[pos] = coefs[k];
+				}
+			} });
+		return cols;
+	}
+
+	std::size_t ConstraintStore::bytes() const
+	{
+		return rowStart.size() * sizeof(int) + colIdx.size() * (sizeof(int) + sizeof(double)) +
+			   senses.size() * (sizeof(char) + 2 * sizeof(double));
+	}
+
+} // namespace dominiqs
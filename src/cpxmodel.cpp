@@ -10,6 +10,7 @@
 #include "kernelpump/cpxmodel.h"
 #include <signal.h>
 #include <cstring>
+#include <algorithm>
 #include <stdexcept>
 #include <utils/consolelog.h>
 
@@ -81,9 +82,35 @@ CPXModel::~CPXModel()
 void CPXModel::readModel(const std::string &filename)
 {
 	DOMINIQS_ASSERT(env && lp);
+	matrixChanged();
 	CPX_CALL(CPXreadcopyprob, env, lp, filename.c_str(), nullptr);
 }
 
+void CPXModel::loadModel(const ModelData &data)
+{
+	DOMINIQS_ASSERT(env && lp);
+	matrixChanged();
+	int n = data.ncols();
+	int m = data.nrows();
+	std::vector<int> matcnt(n);
+	for (int j = 0; j < n; j++)
+		matcnt[j] = data.colBeg[j + 1] - data.colBeg[j];
+	std::vector<char *> colNames(n);
+	for (int j = 0; j < n; j++)
+		colNames[j] = const_cast<char *>(data.colNames.c_str(j));
+	std::vector<char *> rowNames(m);
+	for (int i = 0; i < m; i++)
+		rowNames[i] = const_cast<char *>(data.rowNames.c_str(i));
+	// ModelData follows the CPLEX conventions (objective sense, senses, ranges, infinite bounds)
+	CPX_CALL(CPXcopylpwnames, env, lp, n, m, data.objSense, data.obj.data(), data.rhs.data(), data.sense.data(),
+			 data.colBeg.data(), matcnt.data(), data.colIdx.data(), data.colVal.data(), data.lb.data(), data.ub.data(),
+			 data.range.data(), colNames.data(), rowNames.data());
+	if (std::any_of(data.ctype.begin(), data.ctype.end(), [](char t) { return t != 'C'; }))
+		CPX_CALL(CPXcopyctype, env, lp, data.ctype.data());
+	CPX_CALL(CPXchgprobname, env, lp, data.name.c_str());
+	objOffset(data.objOffset);
+}
+
 void CPXModel::writeModel(const std::string &filename, const std::string &format) const
 {
 	DOMINIQS_ASSERT(env && lp);
@@ -215,6 +242,20 @@ std::vector<double> CPXModel::presolveSolution(const std::vector<double> &origX)
 	return preX;
 }
 
+bool CPXModel::presolvedColMap(std::vector<int> &origToPre) const
+{
+	DOMINIQS_ASSERT(env && lp);
+	int preStat;
+	origToPre.resize(ncols());
+	CPX_CALL(CPXgetprestat, env, lp, &preStat, &origToPre[0], nullptr, nullptr, nullptr);
+	if (preStat != 1)
+		return false;
+	// negative values encode how the column was removed: we only care that it was
+	for (int &j : origToPre)
+		j = std::max(j, -1);
+	return true;
+}
+
 /* Get solution */
 double CPXModel::objval() const
 {
@@ -252,6 +293,38 @@ bool CPXModel::isPrimalFeas() const
 	return (primalFeas > 0);
 }
 
+bool CPXModel::getBasis(LPBasis &basis) const
+{
+	DOMINIQS_ASSERT(env && lp);
+	// only an optimal basic solution is worth a warm start
+	int soltype = CPX_NO_SOLN;
+	CPX_CALL(CPXsolninfo, env, lp, nullptr, &soltype, nullptr, nullptr);
+	if ((soltype != CPX_BASIC_SOLN) || (CPXgetstat(env, lp) != CPX_STAT_OPTIMAL))
+		return false;
+	int n = ncols();
+	int m = nrows();
+	std::vector<int> cstat(n);
+	std::vector<int> rstat(m);
+	CPX_CALL(CPXgetbase, env, lp, n ? &cstat[0] : nullptr, m ? &rstat[0] : nullptr);
+	// CPX_AT_LOWER, CPX_BASIC, CPX_AT_UPPER and CPX_FREE_SUPER are the neutral codes
+	basis.cols.assign(cstat.begin(), cstat.end());
+	basis.rows.assign(rstat.begin(), rstat.end());
+	return true;
+}
+
+bool CPXModel::setBasis(const LPBasis &basis)
+{
+	DOMINIQS_ASSERT(env && lp);
+	int n = ncols();
+	int m = nrows();
+	if (((int)basis.cols.size() != n) || ((int)basis.rows.size() != m))
+		return false;
+	std::vector<int> cstat(basis.cols.begin(), basis.cols.end());
+	std::vector<int> rstat(basis.rows.begin(), basis.rows.end());
+	// with an advanced basis, simplex starts from it (CPX_PARAM_ADVIND is on by default)
+	return (CPX_CALL_SILENT(CPXcopybase, env, lp, n ? &cstat[0] : nullptr, m ? &rstat[0] : nullptr) == 0);
+}
+
 /* Parameters */
 void CPXModel::handleCtrlC(bool flag)
 {
@@ -323,6 +396,10 @@ int CPXModel::intParam(IntParam which) const
 	case IntParam::Emphasis:
 		CPX_CALL(CPXgetintparam, env, CPXPARAM_Emphasis_MIP, &value);
 		break;
+	case IntParam::DualReductions:
+		CPX_CALL(CPXgetintparam, env, CPX_PARAM_REDUCE, &value);
+		value = (value == CPX_PREREDUCE_DUALONLY || value == CPX_PREREDUCE_PRIMALANDDUAL) ? 1 : 0;
+		break;
 	default:
 		throw std::runtime_error("Unknown integer parameter");
 	}
@@ -359,6 +436,9 @@ void CPXModel::intParam(IntParam which, int value)
 	case IntParam::Emphasis:
 		CPX_CALL(CPXsetintparam, env, CPXPARAM_Emphasis_MIP, value);
 		break;
+	case IntParam::DualReductions:
+		CPX_CALL(CPXsetintparam, env, CPX_PARAM_REDUCE, value ? CPX_PREREDUCE_PRIMALANDDUAL : CPX_PREREDUCE_PRIMALONLY);
+		break;
 	default:
 		throw std::runtime_error("Unknown integer parameter ");
 	}
@@ -768,6 +848,7 @@ void CPXModel::rowNames(std::vector<std::string> &names, int first, int last) co
 void CPXModel::addEmptyCol(const std::string &name, char ctype, double lb, double ub, double obj)
 {
 	DOMINIQS_ASSERT(env && lp);
+	matrixChanged();
 	char *cname = (char *)(name.c_str());
 	const char *ctypeptr = (ctype == 'C') ? nullptr : &ctype; //< do not risk turning the model into a MIP
 	CPX_CALL(CPXnewcols, env, lp, 1, &obj, &lb, &ub, ctypeptr, &cname);
@@ -776,6 +857,7 @@ void CPXModel::addEmptyCol(const std::string &name, char ctype, double lb, doubl
 void CPXModel::addCol(const std::string &name, const int *idx, const double *val, int cnt, char ctype, double lb, double ub, double obj)
 {
 	DOMINIQS_ASSERT(env && lp);
+	matrixChanged();
 	int matbeg = 0;
 	char *cname = (char *)(name.c_str());
 	if (cnt > 0)
@@ -795,6 +877,7 @@ void CPXModel::addCol(const std::string &name, const int *idx, const double *val
 void CPXModel::addRow(const std::string &name, const int *idx, const double *val, int cnt, char sense, double rhs, double rngval)
 {
 	DOMINIQS_ASSERT(env && lp);
+	matrixChanged();
 	int matbeg = 0;
 	char *rname = (char *)(name.c_str());
 	if (sense == 'R')
@@ -816,12 +899,14 @@ void CPXModel::addRow(const std::string &name, const int *idx, const double *val
 void CPXModel::delRow(int ridx)
 {
 	DOMINIQS_ASSERT(env && lp);
+	matrixChanged();
 	CPX_CALL(CPXdelrows, env, lp, ridx, ridx);
 }
 
 void CPXModel::delCol(int cidx)
 {
 	DOMINIQS_ASSERT(env && lp);
+	matrixChanged();
 	CPX_CALL(CPXdelcols, env, lp, cidx, cidx);
 }
 
@@ -831,6 +916,7 @@ void CPXModel::delRows(int first, int last)
 	DOMINIQS_ASSERT((first >= 0) && (first < nrows()));
 	DOMINIQS_ASSERT((last >= 0) && (last < nrows()));
 	DOMINIQS_ASSERT(first <= last);
+	matrixChanged();
 	CPX_CALL(CPXdelrows, env, lp, first, last);
 }
 
@@ -840,6 +926,7 @@ void CPXModel::delCols(int first, int last)
 	DOMINIQS_ASSERT((first >= 0) && (first < ncols()));
 	DOMINIQS_ASSERT((last >= 0) && (last < ncols()));
 	DOMINIQS_ASSERT(first <= last);
+	matrixChanged();
 	CPX_CALL(CPXdelcols, env, lp, first, last);
 }
 
@@ -885,6 +972,27 @@ void CPXModel::ubs(int cnt, const int *cols, const double *values)
 	CPX_CALL(CPXchgbds, env, lp, cnt, cols, &lu[0], values);
 }
 
+void CPXModel::rhs(int cnt, const int *rows, const double *values)
+{
+	DOMINIQS_ASSERT(env && lp);
+	matrixChanged();
+	std::vector<double> newRhs(values, values + cnt);
+	for (int i = 0; i < cnt; i++)
+	{
+		DOMINIQS_ASSERT((rows[i] >= 0) && (rows[i] < nrows()));
+		char sense;
+		CPX_CALL(CPXgetsense, env, lp, &sense, rows[i], rows[i]);
+		if (sense == 'R')
+		{
+			// for ranged rows, we assume [rhs-rngval,rhs] while CPLEX uses [rhs, rhs+rngval]
+			double rngval;
+			CPX_CALL(CPXgetrngval, env, lp, &rngval, rows[i], rows[i]);
+			newRhs[i] -= rngval;
+		}
+	}
+	CPX_CALL(CPXchgrhs, env, lp, cnt, rows, &newRhs[0]);
+}
+
 void CPXModel::fixCol(int cidx, double val)
 {
 	DOMINIQS_ASSERT(env && lp);
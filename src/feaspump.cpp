@@ -16,6 +16,7 @@
 #include <iomanip>
 #include <fstream>
 #include <algorithm>
+#include <future>
 
 #include <utils/asserter.h>
 #include <utils/floats.h>
@@ -59,13 +60,6 @@ static double solutionsLinfDistance(const std::vector<int> &integers, const std:
 		dist = std::max(dist, fabs(x1[j] - x2[j]));
 	return dist;
 }
-static bool areSolutionsEqual(const std::vector<int> &integers, const std::vector<double> &x1, const std::vector<double> &x2, double eps)
-{
-	for (int j : integers)
-		if (different(x1[j], x2[j], eps))
-			return false;
-	return true;
-}
 
 static std::vector<double> exponDecayVector(const double factor, const int numPoints)
 {
@@ -141,6 +135,12 @@ namespace dominiqs
 	static const bool DEF_WALKSAT_PERTURBE = true;
 	static const bool DEF_RANDOMIZE_LP = false;
 	static const bool DEF_PENALTYOBJ = false;
+	static const int DEF_INT_CACHE_SIZE = 0;
+	static const bool DEF_PIPELINE_LP = false;
+	static const int DEF_PIPELINE_CANDIDATES = 4;
+	static const bool DEF_STOP_ON_FEASIBLE_ROUNDING = false;
+	static const bool DEF_JUMP_REPAIR = false;
+	static const int DEF_JUMP_REPAIR_MOVES = 100;
 	static const bool DEF_EXPOBJ = false;
 	static const bool DEF_LOGISOBJ = false;
 	static const bool DEF_ACFP = false;
@@ -205,7 +205,10 @@ namespace dominiqs
 										 iterLimit(DEF_ITER_LIMIT), avgFlips(DEF_AVG_FLIPS), integralityEps(DEF_INTEGRALITY_EPS),
 										 seed(DEF_SEED), alpha(DEF_ALPHA), alphaFactor(DEF_ALPHA_FACTOR), alphaDist(DEF_ALPHA_DIST),
 										 doStage3(DEF_DO_STAGE_3), walksatPerturbe(DEF_WALKSAT_PERTURBE),
-										 randomizeLP(DEF_RANDOMIZE_LP), penaltyObj(DEF_PENALTYOBJ),
+										 randomizeLP(DEF_RANDOMIZE_LP), penaltyObj(DEF_PENALTYOBJ), intCacheSize(DEF_INT_CACHE_SIZE),
+										 pipelineLP(DEF_PIPELINE_LP), pipelineCandidates(DEF_PIPELINE_CANDIDATES),
+										 stopOnFeasibleRounding(DEF_STOP_ON_FEASIBLE_ROUNDING),
+										 jumpRepair(DEF_JUMP_REPAIR), jumpRepairMoves(DEF_JUMP_REPAIR_MOVES),
 										 firstOptMethod(DEF_FIRST_OPT_METHOD), reOptMethod(DEF_REOPT_METHOD),
 										 objOffset(0.0), hasIncumbent(false), numIntegersObj(DEF_INTEGERS_OBJ), mipPresolve(true),
 										 forceNullObjectiveInitialLP(false), forceSumVarsObjectiveInitialLP(false),
@@ -277,6 +280,12 @@ namespace dominiqs
 		READ_FROM_CONFIG(walksatPerturbe, DEF_WALKSAT_PERTURBE);
 		READ_FROM_CONFIG(randomizeLP, DEF_RANDOMIZE_LP);
 		READ_FROM_CONFIG(penaltyObj, DEF_PENALTYOBJ);
+		READ_FROM_CONFIG(intCacheSize, DEF_INT_CACHE_SIZE);
+		READ_FROM_CONFIG(pipelineLP, DEF_PIPELINE_LP);
+		READ_FROM_CONFIG(pipelineCandidates, DEF_PIPELINE_CANDIDATES);
+		READ_FROM_CONFIG(stopOnFeasibleRounding, DEF_STOP_ON_FEASIBLE_ROUNDING);
+		READ_FROM_CONFIG(jumpRepair, DEF_JUMP_REPAIR);
+		READ_FROM_CONFIG(jumpRepairMoves, DEF_JUMP_REPAIR_MOVES);
 		READ_FROM_CONFIG(forceNullObjectiveInitialLP, false);
 		READ_FROM_CONFIG(forceSumVarsObjectiveInitialLP, false);
 		READ_FROM_CONFIG(reverseObjectiveFunction, false);
@@ -386,12 +395,35 @@ namespace dominiqs
 		LOG_CONFIG(walksatPerturbe);
 		LOG_CONFIG(randomizeLP);
 		LOG_CONFIG(penaltyObj);
+		LOG_CONFIG(intCacheSize);
+		LOG_CONFIG(pipelineLP);
+		LOG_CONFIG(pipelineCandidates);
+		LOG_CONFIG(stopOnFeasibleRounding);
+		LOG_CONFIG(jumpRepair);
+		LOG_CONFIG(jumpRepairMoves);
 
 		rnd.setSeed(seed);
 		rnd.warmUp();
 		frac2int->readConfig();
 	}
 
+	void FeasibilityPump::setIterBudget(const IterBudget &budget)
+	{
+		stage1IterLimit = budget.stage1;
+		stage2IterLimit = budget.stage2;
+		iterLimit = budget.total;
+	}
+
+	void FeasibilityPump::reseed(uint64_t newSeed)
+	{
+		rnd.setSeed(newSeed);
+		rnd.warmUp();
+		// forget the general integer flips of previous calls
+		lastRestart = nitr;
+		flipsInRestart = 0;
+		frac2int->reseed(newSeed);
+	}
+
 	bool FeasibilityPump::foundSolution() const
 	{
 		return hasIncumbent;
@@ -450,6 +482,15 @@ namespace dominiqs
 	void FeasibilityPump::resetPartial()
 	{
 		hasPresolve = false;
+		canUpdateBounds = false;
+		origToPre.clear();
+		startBasis.clear();
+		model = MIPModelPtr();
+		resetSetup();
+	}
+
+	void FeasibilityPump::resetSetup()
+	{
 		lastIntegerX.clear();
 
 		lastFracX.clear();
@@ -461,11 +502,12 @@ namespace dominiqs
 		binaries.clear();
 		gintegers.clear();
 		integers.clear();
+		nonIntegers.clear();
+		pointLayout.reset();
 		rows.reset();
 		isPureInteger = false;
 		isBinary = false;
 		objOffset = 0.0;
-		model = MIPModelPtr();
 
 		closestPoint.clear();
 		closestFrac.clear();
@@ -480,6 +522,8 @@ namespace dominiqs
 		pertCnt = 0;
 		restartCnt = 0;
 		walksatCnt = 0;
+		altRoundingCnt = 0;
+		repairCnt = 0;
 		lastRestart = 0;
 		flipsInRestart = 0;
 		maxFlipsInRestart = 0;
@@ -502,6 +546,11 @@ namespace dominiqs
 
 		consoleLog("fpProblem: #rows={} #cols={} #nnz={}",
 				   originalModel->nrows(), originalModel->ncols(), originalModel->nnz());
+		// remember the bounds seen by presolve
+		initLb.resize(originalModel->ncols());
+		initUb.resize(originalModel->ncols());
+		originalModel->lbs(&initLb[0]);
+		originalModel->ubs(&initUb[0]);
 		// presolve
 		MIPModelPtr premodel;
 		if (mipPresolve)
@@ -543,6 +592,8 @@ namespace dominiqs
 		DOMINIQS_ASSERT(premodel);
 
 		model = premodel;
+		// bases of a presolved model are meaningless for any other presolve
+		modelSpace = hasPresolve ? ++presolveCount : 0;
 
 		int n = model->ncols();
 		// if user passed column type information, used it
@@ -552,7 +603,75 @@ namespace dominiqs
 			for (int j = 0; j < n; j++)
 				model->ctype(j, ctype[j]);
 		}
-		frac2int->init(model, true);
+
+		// save what is needed to re-enter the pump on this model with different bounds
+		if (hasPresolve)
+			canUpdateBounds = originalModel->presolvedColMap(origToPre);
+		else
+		{
+			origToPre.resize(n);
+			std::iota(origToPre.begin(), origToPre.end(), 0);
+			canUpdateBounds = true;
+		}
+		preLb.resize(n);
+		preUb.resize(n);
+		preObj.resize(n);
+		model->lbs(&preLb[0]);
+		model->ubs(&preUb[0]);
+		model->objcoefs(&preObj[0]);
+		preObjSense = model->objSense();
+		preObjOffset = model->objOffset();
+
+		return setup();
+	}
+
+	bool FeasibilityPump::updateBounds(const std::vector<int> &cols, const std::vector<double> &lbs, const std::vector<double> &ubs)
+	{
+		DOMINIQS_ASSERT((cols.size() == lbs.size()) && (cols.size() == ubs.size()));
+		if (!model || !canUpdateBounds || (model->nrows() != rows->nrows()) || (model->ncols() != rows->ncols()))
+			return false;
+		std::vector<double> newLb = preLb;
+		std::vector<double> newUb = preUb;
+		for (unsigned int k = 0; k < cols.size(); k++)
+		{
+			int j = cols[k];
+			// presolve reductions are valid only for restrictions of the domain it has seen
+			if (lessThan(lbs[k], initLb[j], integralityEps) || greaterThan(ubs[k], initUb[j], integralityEps))
+				return false;
+			int jp = origToPre[j];
+			if (jp < 0)
+			{
+				// removed by presolve: its value is known only for the domain presolve has seen
+				if (greaterThan(lbs[k], initLb[j], integralityEps) || lessThan(ubs[k], initUb[j], integralityEps))
+					return false;
+				continue;
+			}
+			newLb[jp] = std::max(newLb[jp], lbs[k]);
+			newUb[jp] = std::min(newUb[jp], ubs[k]);
+			if (greaterThan(newLb[jp], newUb[jp], integralityEps))
+				return false; //< let presolve detect the infeasibility
+		}
+		consoleInfo("[fpUpdateBounds]");
+		resetSetup();
+		// restore the model as it was right after presolve (pump changes objective and possibly bounds and types)
+		int n = model->ncols();
+		std::vector<int> allCols(n);
+		std::iota(allCols.begin(), allCols.end(), 0);
+		model->ctypes(n, &allCols[0], &xType[0]);
+		model->lbs(n, &allCols[0], &newLb[0]);
+		model->ubs(n, &allCols[0], &newUb[0]);
+		model->objcoefs(n, &allCols[0], &preObj[0]);
+		model->objSense(preObjSense);
+		model->objOffset(preObjOffset);
+		return setup(true);
+	}
+
+	bool FeasibilityPump::setup(bool boundsOnly)
+	{
+		int n = model->ncols();
+		// when only the bounds changed, the rounder can usually avoid a full rebuild
+		if (!boundsOnly || !frac2int->updateBounds(model, true))
+			frac2int->init(model, true);
 		frac_x.resize(n, 0);
 		integer_x.resize(n, 0);
 		obj.resize(n, 0);
@@ -579,7 +698,10 @@ namespace dominiqs
 			// this is trivially true for simple rounding, but some care must be
 			// taken for more elaborate strategies!!!
 			if (equal(lb[i], ub[i], integralityEps))
+			{
 				fixed.push_back(i);
+				nonIntegers.push_back(i);
+			}
 			else if (xType[i] != 'C')
 			{
 				integers.push_back(i);
@@ -589,11 +711,20 @@ namespace dominiqs
 					gintegers.push_back(i);
 			}
 			else
+			{
 				++num_continuous_vars;
+				nonIntegers.push_back(i);
+			}
 		}
 
+		pointLayout = std::make_shared<PointLayout>(n, binaries, gintegers, lb, ub);
+
 		// extract the rows.
 		rows = model->rows();
+		intActivity.init(rows);
+		integerXChanged();
+		if (jumpRepair)
+			repairer.init(rows, xType, seed);
 
 		// std::vector<std::string> varNames;
 		// model->colNames(varNames);
@@ -626,6 +757,7 @@ namespace dominiqs
 		newub.resize(n, -100000000000.0); /**< new upper bounds */
 
 		primalFeas = false;
+		hasLastBasis = false;
 		ObjSense origObjSense = model->objSense();
 		double dualBound = -static_cast<int>(origObjSense) * INFBOUND;
 		primalBound = static_cast<int>(origObjSense) * INFBOUND;
@@ -817,6 +949,10 @@ namespace dominiqs
 		LOG_ITEM("perturbationCnt", pertCnt);
 		LOG_ITEM("restartCnt", restartCnt);
 		LOG_ITEM("walksatCnt", walksatCnt);
+		if (pipelineLP)
+			LOG_ITEM("altRoundingCnt", altRoundingCnt);
+		if (jumpRepair)
+			LOG_ITEM("repairCnt", repairCnt);
 		if (stage == 3)
 			LOG_ITEM("stage3Time", stage3Time);
 		return {found, !closestFrac.empty()};
@@ -936,6 +1072,7 @@ namespace dominiqs
 		// model->switchToLP();
 
 		model->dblParam(DblParam::TimeLimit, timeLeft);
+		installStartBasis();
 		// StopWatch tp1;
 		// tp1.start();
 		bool result = model->lpopt(firstOptMethod, false, true);
@@ -951,6 +1088,7 @@ namespace dominiqs
 			return;
 
 		rootLpIter = std::max(simplexIt, barrierIt);
+		saveLastBasis();
 		if (model->isPrimalFeas())
 		{
 			// consoleInfo("is primal feasible");
@@ -969,6 +1107,81 @@ namespace dominiqs
 				   simplexIt, barrierIt, pdlpIt, rootTime, primalFeas, dualBound);
 	}
 
+	void FeasibilityPump::prepareAlternativeRoundings(const std::vector<int> &intSubset)
+	{
+		// runs while the LP is being solved: the model must not be accessed here
+		altRoundings.clear();
+		if ((pipelineCandidates <= 0) || (numFracsObj != 1) || analcenterFP)
+			return;
+		std::vector<double> shifted = frac_x;
+		std::vector<double> rounded(frac_x.size());
+		for (int c = 0; c < pipelineCandidates; c++)
+		{
+			// shifting the point by 0.5 - t moves the rounding threshold to t (evenly spread in (0,1)),
+			// and changes the order in which a ranked rounder fixes the variables
+			double t = (c + 1.0) / (pipelineCandidates + 1.0);
+			if (equal(t, 0.5))
+				continue;
+			for (int j : intSubset)
+				shifted[j] = std::min(std::max(frac_x[j] + 0.5 - t, lb[j]), ub[j]);
+			frac2int->apply(shifted, rounded);
+			if ((rounded != integer_x) && (std::find(altRoundings.begin(), altRoundings.end(), rounded) == altRoundings.end()))
+				altRoundings.push_back(rounded);
+		}
+	}
+
+	bool FeasibilityPump::useAlternativeRounding(const std::vector<int> &intSubset, double runningAlpha)
+	{
+		// the alternative closest to the current LP solution, among the ones not visited yet
+		int best = -1;
+		double bestDist = INFBOUND;
+		for (int c = 0; c < (int)altRoundings.size(); c++)
+		{
+			if (lastIntegerX.contains(runningAlpha, altRoundings[c]))
+				continue;
+			double dist = solutionsDistance(intSubset, frac_x, altRoundings[c]);
+			if (lessThan(dist, bestDist))
+			{
+				best = c;
+				bestDist = dist;
+			}
+		}
+		if (best < 0)
+			return false;
+		// the other components come from the current LP solution, as for the standard rounding
+		integer_x = frac_x;
+		for (int j : intSubset)
+			integer_x[j] = altRoundings[best][j];
+		altRoundingCnt++;
+		consoleDebug(DebugLevel::Verbose, "cycle broken with an alternative rounding: dist={}", bestDist);
+		return true;
+	}
+
+	void FeasibilityPump::installStartBasis()
+	{
+		if (startBasis.empty())
+			return;
+		// the pump may have appended (or not yet appended) its auxiliary columns and rows
+		startBasis.fit(model->ncols(), model->nrows());
+		if (model->setBasis(startBasis))
+			consoleLog("LP warm started from the given basis");
+		startBasis.clear();
+	}
+
+	void FeasibilityPump::saveLastBasis()
+	{
+		if (model->getBasis(lastBasis))
+			hasLastBasis = true;
+	}
+
+	bool FeasibilityPump::getLastBasis(LPBasis &basis) const
+	{
+		if (!hasLastBasis)
+			return false;
+		basis = lastBasis;
+		return true;
+	}
+
 	void FeasibilityPump::perturbe(std::vector<double> &x, bool ignoreGeneralIntegers)
 	{
 		pertCnt++;
@@ -1078,7 +1291,7 @@ namespace dominiqs
 		restartCnt++;
 		// get previous solution
 		DOMINIQS_ASSERT(lastIntegerX.size());
-		const std::vector<double> &previousSol = lastIntegerX.begin()->second;
+		const IntegerPoint &previousSol = lastIntegerX.front().x;
 		// perturbe
 		double sigma;
 		double r;
@@ -1168,7 +1381,9 @@ namespace dominiqs
 	bool FeasibilityPump::pumpLoop(double &runningAlpha, int stage, double &dualBound, bool stopWithNoImprLimit)
 	{
 		// setup
-		lastIntegerX.clear();
+		installedObj.clear(); //< the LP objective has been changed outside the loop
+		clearDeltaPool();
+		deltaPoolIdx.assign(std::max(numIntegersObj, 1) * gintegers.size(), -1);
 		multipleIntegerX.clear();
 		lastFracX.clear();
 		int n = model->ncols();
@@ -1179,7 +1394,10 @@ namespace dominiqs
 		int stageIterLimit = (stage == 1) ? stage1IterLimit : stage2IterLimit;
 		bool ignoreGenerals = (stage == 1) ? true : false;
 		const auto &intSubset = (stage == 1) ? binaries : integers;
+		lastIntegerX.setup(pointLayout, ignoreGenerals, alphaDist, intCacheSize);
+		altRoundings.clear();
 		frac2int->ignoreGeneralIntegers(ignoreGenerals);
+		integerXChanged(); //< outside the loop, and the cache hash starts over
 		double pumpTimeLimit = /*(timeMult > 0.0) ? timeMult * rootTime :*/ std::numeric_limits<double>::max();
 		std::vector<std::string> xNames;
 		model->colNames(xNames);
@@ -1200,10 +1418,10 @@ namespace dominiqs
 		if (stage == 2)
 			model->intParam(IntParam::PdlpWarmStart, 0);
 
-		while (!model->aborted() && ((nitr - oldIterCnt) < stageIterLimit) && ((nitr - oldIterCnt) < iterLimit))
+		while (!model->aborted() && !stopRequested() && ((nitr - oldIterCnt) < stageIterLimit) && ((nitr - oldIterCnt) < iterLimit))
 		{
 			// consoleInfo("{} - {} = {}/{}/{}", nitr, oldIterCnt, nitr - oldIterCnt, stageIterLimit, iterLimit);
-			lpfeasible = model->isSolutionFeasible(frac_x);
+			// note: lpfeasible is up to date here (computed before the loop or at the end of the previous iteration)
 			bool applyPdlpRestart = (!lpfeasible && isSolutionInteger(intSubset, frac_x, integralityEps));
 			// ToDo check the value of primFeas
 			// check if frac_x is feasible (w.r.t. the integer variables in this stage)
@@ -1247,25 +1465,36 @@ namespace dominiqs
 				aggregateFracs(frac2round, scaleVec);
 				// get rounding
 				frac2int->apply(frac2round, integer_x);
+				trackRounding();
 			}
 			// get rounding by using AC
 			else if (analcenterFP)
 			{
 				double bestgamma;
 				integerFromAC(integer_x, bestgamma, 0.05);
+				integerXChanged();
 			}
 			// round the last fractional point
 			else
 			{
 				frac2int->apply(frac_x, integer_x);
+				trackRounding();
 			}
 
 			roundWatch.stop();
 			consoleDebug(DebugLevel::Verbose, "roundingTime = {}", roundWatch.getPartial());
 
+			// pipelined mode: break a cycle with the alternative rounding prepared during the last LP solve, if any
+			if (!altRoundings.empty() && lastIntegerX.contains(runningAlpha, integer_x, integerXHash()))
+			{
+				useAlternativeRounding(intSubset, runningAlpha);
+				integerXChanged(); //< the alternatives have been hashed too
+			}
+			altRoundings.clear();
+
 			// cycle detection and antistalling actions
 			// is it the same of the last one? If yes perturbe
-			if (lastIntegerX.size() && areSolutionsEqual(intSubset, integer_x, (*(lastIntegerX.begin())).second, integralityEps) && equal(runningAlpha, (*(lastIntegerX.begin())).first, alphaDist))
+			if (lastIntegerX.sameAsLast(integer_x, integerXHash()) && equal(runningAlpha, lastIntegerX.front().alpha, alphaDist))
 			{
 				if (!pertCnt)
 					firstPerturbation = nitr;
@@ -1274,9 +1503,10 @@ namespace dominiqs
 					perturbe(integer_x, ignoreGenerals);
 				else
 					restart(integer_x, ignoreGenerals);
+				integerXChanged();
 			}
 
-			if (isInCache(runningAlpha, integer_x, ignoreGenerals))
+			if (lastIntegerX.contains(runningAlpha, integer_x, integerXHash()))
 			{
 
 				if ((!usedOrigFpNoRestart) && (numFracsObj != 1))
@@ -1284,6 +1514,7 @@ namespace dominiqs
 					usedOrigFpNoRestart = true;
 					integer_x.resize(n, 0);
 					frac2int->apply(frac_x, integer_x);
+					trackRounding();
 				}
 
 				else if ((!usedOrigFpNoRestart) && (numIntegersObj != 1))
@@ -1297,18 +1528,64 @@ namespace dominiqs
 					// do a restart until we are able to insert it in the cache
 					for (int rtry = 0; rtry < 10; rtry++)
 					{
-						if (isInCache(runningAlpha, integer_x, ignoreGenerals))
+						if (lastIntegerX.contains(runningAlpha, integer_x, integerXHash()))
+						{
 							restart(integer_x, ignoreGenerals);
+							integerXChanged();
+						}
 						else
 							break;
 					}
-					lastIntegerX.push_front(AlphaVector(runningAlpha, integer_x));
+					lastIntegerX.push_front(runningAlpha, integer_x, integerXHash());
 				}
 			}
 			else
 			{
 				usedOrigFpNoRestart = false;
-				lastIntegerX.push_front(AlphaVector(runningAlpha, integer_x));
+				lastIntegerX.push_front(runningAlpha, integer_x, integerXHash());
+			}
+
+			// an infeasible rounding may be a few moves away from feasibility: try to close the gap by local search
+			// (if that fails, the pump goes on from the rounding itself)
+			if (jumpRepair)
+			{
+				updateIntActivity(integer_x);
+				if (!intActivity.isFeasible())
+				{
+					repaired = integer_x;
+					// the repair moves intActivity along with repaired
+					intActivityChanges.setAll();
+					if (repairer.repair(repaired, intActivity, lb, ub, jumpRepairMoves) && isSolutionInteger(integers, repaired, integralityEps))
+					{
+						consoleLog("rounding repaired by local search: no LP needed");
+						repairCnt++;
+						integer_x = repaired;
+						// record it right away: the loop condition may not let us come back to the check at the top
+						frac_x = integer_x;
+						primalFeas = true;
+						closestDist = 0.0;
+						closestPoint = integer_x;
+						closestFrac = integer_x;
+						break;
+					}
+				}
+			}
+
+			// a feasible rounding needs no further LP (if all the integers are integral, also in stage 1):
+			// record it as the stage solution and stop here
+			if (stopOnFeasibleRounding)
+			{
+				updateIntActivity(integer_x);
+				if (intActivity.isFeasible() && isSolutionInteger(integers, integer_x, integralityEps))
+				{
+					consoleLog("feasible rounding found: no LP needed");
+					frac_x = integer_x;
+					primalFeas = true;
+					closestDist = 0.0;
+					closestPoint = integer_x;
+					closestFrac = integer_x;
+					break;
+				}
 			}
 
 			// int -> frac
@@ -1323,15 +1600,18 @@ namespace dominiqs
 			// then we might not realize the current integer_x is feasible.
 			// so we explictly check for feasibility and, if so,
 			// temporarily set the running alpha to zero.
-			if (model->isSolutionFeasible(integer_x))
+			// (row activities are updated incrementally: within an iteration only the integer components change)
+			updateIntActivity(integer_x);
+			bool intFeasible = intActivity.isFeasible();
+			consoleDebug(DebugLevel::Verbose, "integer point: #violated={} maxViolation={}", intActivity.numViolated(), intActivity.maxViolation());
+			if (intFeasible)
 			{
 				thisAlpha = 0.0;
 				currNumPointsInObj = 1;
 			}
 
-			// setup distance objective
+			// setup distance objective (the delta vars of the pool not used in this iteration get a null cost)
 			int addedVars = 0;
-			int addedConstrs = 0;
 			std::fill(distObj.begin(), distObj.end(), 0.0);
 
 			// if no score for the integers it is 0 for all
@@ -1361,26 +1641,58 @@ namespace dominiqs
 			// If aggregateInts=False we use a convex combination of distance functions of previous integers as abjoctive in the projection LP.
 			if (!aggregateInts)
 			{
+				// the exponential/logistic weights of the binaries only depend on frac_x:
+				// compute them once (in a tight loop over contiguous arrays) for all reference points
+				unsigned int nbins = binaries.size();
+				if (expObj || logisObj)
+				{
+					double rate = logisObj ? 0.1 : 0.5;
+					binWeightDown.resize(nbins);
+					binWeightUp.resize(nbins);
+					for (unsigned int k = 0; k < nbins; k++)
+					{
+						binWeightDown[k] = -rate * frac_x[binaries[k]];
+						binWeightUp[k] = -rate * (1 - frac_x[binaries[k]]);
+					}
+					for (unsigned int k = 0; k < nbins; k++)
+					{
+						binWeightDown[k] = exp(binWeightDown[k]);
+						binWeightUp[k] = exp(binWeightUp[k]);
+					}
+					if (logisObj)
+					{
+						for (unsigned int k = 0; k < nbins; k++)
+						{
+							binWeightDown[k] = rate * binWeightDown[k] / ((1 + binWeightDown[k]) * (1 + binWeightDown[k]));
+							binWeightUp[k] = rate * binWeightUp[k] / ((1 + binWeightUp[k]) * (1 + binWeightUp[k]));
+						}
+					}
+					else
+					{
+						for (unsigned int k = 0; k < nbins; k++)
+						{
+							binWeightDown[k] *= rate;
+							binWeightUp[k] *= rate;
+						}
+					}
+				}
 				for (int iter = 0; iter < currNumPointsInObj; iter++)
 				{
-					for (int j : binaries)
+					for (unsigned int k = 0; k < nbins; k++)
 					{
+						int j = binaries[k];
 						double distCoef = scaleIntVec[iter];
 
 						if (isNull(itrInt->second[j], integralityEps))
 						{
-							if (expObj)
-								distCoef = scaleIntVec[iter] * 0.5 * exp(-0.5 * frac_x[j]);
-							if (logisObj)
-								distCoef = scaleIntVec[iter] * 0.1 * exp(-0.1 * frac_x[j]) / pow(1 + exp(-0.1 * frac_x[j]), 2);
+							if (expObj || logisObj)
+								distCoef *= binWeightDown[k];
 							distObj[j] += distCoef;
 						}
 						else
 						{
-							if (expObj)
-								distCoef = scaleIntVec[iter] * 0.5 * exp(-0.5 * (1 - frac_x[j]));
-							if (logisObj)
-								distCoef = scaleIntVec[iter] * 0.1 * exp(-0.1 * (1 - frac_x[j])) / pow(1 + exp(-0.1 * (1 - frac_x[j])), 2);
+							if (expObj || logisObj)
+								distCoef *= binWeightUp[k];
 							distObj[j] -= distCoef;
 						}
 					}
@@ -1394,8 +1706,9 @@ namespace dominiqs
 					for (int iter = 0; iter < currNumPointsInObj; iter++)
 					{
 
-						for (int j : gintegers)
+						for (unsigned int k = 0; k < gintegers.size(); k++)
 						{
+							int j = gintegers[k];
 							double distCoef = scaleIntVec[iter];
 
 							if (equal(itrInt->second[j], lb[j], integralityEps))
@@ -1423,52 +1736,22 @@ namespace dominiqs
 								{
 									if (iter == 0)
 									{
-										std::string deltaName = xNames[j] + "_delta_" + std::to_string(iter);
-										model->addEmptyCol(deltaName, 'C', 0.0, INFBOUND, 0.0);
-										int auxIdx = model->ncols() - 1;
-										colIndices.push_back(auxIdx);
-										if (expObj)
-											distCoef = scaleIntVec[iter] * 0.5 * exp(-0.5 * fabs(frac_x[j] - itrInt->second[j]));
-										if (logisObj)
-											distCoef = scaleIntVec[iter] * 0.1 * exp(-0.1 * fabs(frac_x[j] - itrInt->second[j])) / pow(1 + exp(-0.1 * fabs(frac_x[j] - itrInt->second[j])), 2);
-
-										distObj.push_back(1.0);
+										int auxIdx = useDeltaSlot(iter, k, itrInt->second[j], xNames, colIndices, distObj);
+										distObj[auxIdx] = 1.0;
 										addedVars++;
-										// add constraints
-										SparseVector vec;
-										vec.push(j, 1.0);
-										vec.push(auxIdx, -1.0);
-										model->addRow(xNames[j] + "_d1p" + std::to_string(iter), vec.idx(), vec.coef(), 2, 'L', itrInt->second[j]);
-										addedConstrs++;
-										vec.coef()[1] = 1.0;
-										model->addRow(xNames[j] + "_d2p" + std::to_string(iter), vec.idx(), vec.coef(), 2, 'G', itrInt->second[j]);
-										addedConstrs++;
 									}
 								}
 
 								else
 								{
-									// add auxiliary variable
-									std::string deltaName = xNames[j] + "_delta_" + std::to_string(iter);
-									model->addEmptyCol(deltaName, 'C', 0.0, INFBOUND, 0.0);
-									int auxIdx = model->ncols() - 1;
-									colIndices.push_back(auxIdx);
+									// auxiliary variable
+									int auxIdx = useDeltaSlot(iter, k, itrInt->second[j], xNames, colIndices, distObj);
 									if (expObj)
 										distCoef = scaleIntVec[iter] * 0.5 * exp(-0.5 * fabs(frac_x[j] - itrInt->second[j]));
 									if (logisObj)
 										distCoef = scaleIntVec[iter] * 0.1 * exp(-0.1 * fabs(frac_x[j] - itrInt->second[j])) / pow(1 + exp(-0.1 * fabs(frac_x[j] - itrInt->second[j])), 2);
-
-									distObj.push_back(distCoef);
+									distObj[auxIdx] = distCoef;
 									addedVars++;
-									// add constraints
-									SparseVector vec;
-									vec.push(j, 1.0);
-									vec.push(auxIdx, -1.0);
-									model->addRow(xNames[j] + "_d1p" + std::to_string(iter), vec.idx(), vec.coef(), 2, 'L', itrInt->second[j]);
-									addedConstrs++;
-									vec.coef()[1] = 1.0;
-									model->addRow(xNames[j] + "_d2p" + std::to_string(iter), vec.idx(), vec.coef(), 2, 'G', itrInt->second[j]);
-									addedConstrs++;
 								}
 							}
 						}
@@ -1476,8 +1759,8 @@ namespace dominiqs
 						itrInt++;
 					}
 
-					consoleDebug(DebugLevel::Verbose, "addedVars={} addedConstrs={}", addedVars, addedConstrs);
-					DOMINIQS_ASSERT(distObj.size() == (unsigned int)(n + addedVars));
+					consoleDebug(DebugLevel::Verbose, "usedDeltaVars={} poolSize={}", addedVars, deltaPool.size());
+					DOMINIQS_ASSERT(distObj.size() == n + deltaPool.size());
 					DOMINIQS_ASSERT(distObj.size() == colIndices.size());
 				}
 			}
@@ -1491,7 +1774,7 @@ namespace dominiqs
 				std::vector<double> new_integer;
 				new_integer.resize(n, 0);
 
-				if (model->isSolutionFeasible(integer_x))
+				if (intFeasible)
 				{
 					new_integer = integer_x;
 					thisAlpha = 0.0;
@@ -1506,52 +1789,25 @@ namespace dominiqs
 					}
 					frac2int->apply(aggr_integers, new_integer);
 					// the new point may be already in cache!
-					bool sameAsLast = true;
+					bool sameAsLast = lastIntegerX.sameAsLast(new_integer);
+					intHashChanges.setAll();
 					bool inCache = false;
-					std::list<AlphaVector>::const_iterator itr = lastIntegerX.begin();
-					std::list<AlphaVector>::const_iterator end = lastIntegerX.end();
-					if (stage == 1)
-					{
-						if (!areSolutionsEqual(binaries, itr->second, new_integer, integralityEps))
-						{
-							sameAsLast = false;
-						}
-					}
-					else
-					{
-						if (!areSolutionsEqual(integers, itr->second, new_integer, integralityEps))
-						{
-							sameAsLast = false;
-						}
-					}
-					itr++; // to ignore first integer
 					if (!sameAsLast)
 					{
-						if (stage == 1)
-						{
-							while ((itr != end) && !inCache)
-							{
-								if ((fabs(thisAlpha - itr->first) < alphaDist) && areSolutionsEqual(binaries, itr->second, new_integer, integralityEps))
-									inCache = true;
-								++itr;
-							}
-						}
-						else
-						{
-							while ((itr != end) && !inCache)
-							{
-								if ((fabs(thisAlpha - itr->first) < alphaDist) && areSolutionsEqual(integers, itr->second, new_integer, integralityEps))
-									inCache = true;
-								++itr;
-							}
-						}
+						// the last point differs from new_integer, so we can look up the whole cache
+						inCache = lastIntegerX.contains(thisAlpha, new_integer);
 						if (inCache)
 						{
 							new_integer = integer_x;
 						}
-						else if (model->isSolutionFeasible(new_integer))
+						else
 						{
-							thisAlpha = 0.0;
+							// new_integer comes from a different point than integer_x
+							intActivityChanges.setAll();
+							updateIntActivity(new_integer);
+							intActivityChanges.setAll();
+							if (intActivity.isFeasible())
+								thisAlpha = 0.0;
 						}
 					}
 				}
@@ -1572,8 +1828,9 @@ namespace dominiqs
 
 				if (stage > 1)
 				{
-					for (int j : gintegers)
+					for (unsigned int k = 0; k < gintegers.size(); k++)
 					{
+						int j = gintegers[k];
 						if (equal(new_integer[j], lb[j], integralityEps))
 						{
 							distObj[j] = 1.0;
@@ -1584,27 +1841,15 @@ namespace dominiqs
 						}
 						else
 						{
-							// add auxiliary variable
-							std::string deltaName = xNames[j] + "_delta";
-							model->addEmptyCol(deltaName, 'C', 0.0, INFBOUND, 0.0);
-							int auxIdx = model->ncols() - 1;
-							colIndices.push_back(auxIdx);
-							distObj.push_back(1.0);
+							// auxiliary variable
+							int auxIdx = useDeltaSlot(0, k, new_integer[j], xNames, colIndices, distObj);
+							distObj[auxIdx] = 1.0;
 							addedVars++;
-							// add constraints
-							SparseVector vec;
-							vec.push(j, 1.0);
-							vec.push(auxIdx, -1.0);
-							model->addRow(xNames[j] + "_d1", vec.idx(), vec.coef(), 2, 'L', new_integer[j]);
-							addedConstrs++;
-							vec.coef()[1] = 1.0;
-							model->addRow(xNames[j] + "_d2", vec.idx(), vec.coef(), 2, 'G', new_integer[j]);
-							addedConstrs++;
 						}
 					}
 
-					consoleDebug(DebugLevel::Verbose, "addedVars={} addedConstrs={}", addedVars, addedConstrs);
-					DOMINIQS_ASSERT(distObj.size() == (unsigned int)(n + addedVars));
+					consoleDebug(DebugLevel::Verbose, "usedDeltaVars={} poolSize={}", addedVars, deltaPool.size());
+					DOMINIQS_ASSERT(distObj.size() == n + deltaPool.size());
 					DOMINIQS_ASSERT(distObj.size() == colIndices.size());
 				}
 			}
@@ -1612,7 +1857,7 @@ namespace dominiqs
 			// randomize distance coefficients
 			if (randomizeLP)
 			{
-				for (int j = 0; j < (n + addedVars); j++)
+				for (int j = 0; j < (int)distObj.size(); j++)
 				{
 					double randMult = rnd.getFloat() * 0.1 + 0.9; //< random float in [0.9,1.0)
 					distObj[j] *= randMult;
@@ -1654,7 +1899,7 @@ namespace dominiqs
 				}
 
 				// scale distance objective by (1-thisAlpha)
-				for (int j = 0; j < (n + addedVars); j++)
+				for (int j = 0; j < (int)distObj.size(); j++)
 				{
 					distObj[j] *= (1.0 - thisAlpha);
 				}
@@ -1672,8 +1917,20 @@ namespace dominiqs
 				double weight = (thisAlpha * distScale) / objScale;
 				accumulate(&distObj[0], &obj[0], n, weight);
 			}
-			// set objective
-			model->objcoefs(colIndices.size(), &colIndices[0], &distObj[0]);
+			// update the reference values of the delta vars of the pool
+			flushDeltaRhs();
+
+			// set objective: only send the coefficients that changed w.r.t. the objective
+			// installed at the previous iteration (delta vars added since then have a null cost)
+			if (installedObj.size() >= (unsigned int)n)
+			{
+				installedObj.resize(colIndices.size(), 0.0);
+				[[maybe_unused]] int changed = model->objcoefsDiff(colIndices.size(), &colIndices[0], &installedObj[0], &distObj[0]);
+				consoleDebug(DebugLevel::Verbose, "objcoefs changed={}/{}", changed, colIndices.size());
+			}
+			else
+				model->objcoefs(colIndices.size(), &colIndices[0], &distObj[0]);
+			installedObj = distObj;
 
 			// solve LP
 			if (lpIterLimit > 0)
@@ -1682,9 +1939,18 @@ namespace dominiqs
 			timeLeft = std::max(std::min(timeLimit, pumpTimeLimit) - chrono.getElapsed(), 0.0);
 			model->dblParam(DblParam::TimeLimit, timeLeft);
 
+			installStartBasis();
 			// StopWatch tp2;
 			// tp2.start();
-			model->lpopt(reOptMethod, false, false);
+			if (pipelineLP)
+			{
+				// the next iteration's alternative roundings are prepared while the LP is being solved
+				std::future<bool> lpDone = model->lpoptAsync(reOptMethod, false, false);
+				prepareAlternativeRoundings(intSubset);
+				lpDone.get();
+			}
+			else
+				model->lpopt(reOptMethod, false, false);
 			// if (greaterThan(tp2.getElapsed(), timeLeft))
 			// 	std::cout << " * " << tp2.getElapsed() << " > " << timeLeft << std::endl;
 
@@ -1695,6 +1961,7 @@ namespace dominiqs
 			primalFeas = model->isPrimalFeas();
 			if (primalFeas)
 			{
+				saveLastBasis();
 				// get solution
 				model->sol(&frac_x[0], 0, n - 1);
 				// try to tighten the tolerance for pdlp
@@ -1721,20 +1988,6 @@ namespace dominiqs
 			{
 				// if lpopt was interrupted because of the timelimit postsolve the model manually and exit the current stage
 				model->postsolve();
-				// cleanup added vars and constraints
-				if (addedConstrs)
-				{
-					int begin = model->nrows() - addedConstrs;
-					model->delRows(begin, begin + addedConstrs - 1);
-				}
-				if (addedVars)
-				{
-					int begin = model->ncols() - addedVars;
-					model->delCols(begin, begin + addedVars - 1);
-				}
-				colIndices.resize(n);
-				distObj.resize(n);
-				DOMINIQS_ASSERT(model->ncols() == n);
 				consoleInfo("Reached FP time limit");
 				break;
 			}
@@ -1743,27 +1996,7 @@ namespace dominiqs
 						 lpWatch.getPartial(), primalFeas, model->intAttr(IntAttr::SimplexIterations), model->intAttr(IntAttr::PDLPIterations));
 			double projObj = model->objval();
 
-			dominiqs::StopWatch chronoDelRows;
-			chronoDelRows.start();
-
-			// cleanup added vars and constraints
-			if (addedConstrs)
-			{
-				int begin = model->nrows() - addedConstrs;
-				model->delRows(begin, begin + addedConstrs - 1);
-			}
-			if (addedVars)
-			{
-				int begin = model->ncols() - addedVars;
-				model->delCols(begin, begin + addedVars - 1);
-			}
-
-			chronoDelRows.stop();
-			chronoDelRows.getElapsed();
-
-			colIndices.resize(n);
-			distObj.resize(n);
-			DOMINIQS_ASSERT(model->ncols() == n);
+			DOMINIQS_ASSERT(model->ncols() == n + (int)deltaPool.size());
 
 			// get some statistics
 			double origObj = dotProduct(&obj[0], &frac_x[0], n) + objOffset;
@@ -1781,7 +2014,7 @@ namespace dominiqs
 				double intViolation = 0.0;
 				for (auto c : *rows)
 				{
-					intViolation += std::max(0.0, c->violation(&integer_afterProj[0]));
+					intViolation += std::max(0.0, c.violation(&integer_afterProj[0]));
 				}
 				itrIntegers->first = intViolation;
 				if (bestObjIntegers)
@@ -1831,7 +2064,7 @@ namespace dominiqs
 				// 	// how much does the integer violate the constraints?
 				// 	for (auto c: rows)
 				// 	{
-				// 		scoreIntS3 += std::max(0.0, c->violation(&integer_x[0]));
+				// 		scoreIntS3 += std::max(0.0, c.violation(&integer_x[0]));
 				// 	}
 				// 	scoreIntS3 *= (dotProduct(&obj[0], &integer_x[0], n) + objOffset);
 
@@ -1845,7 +2078,7 @@ namespace dominiqs
 					// how much does the integer violate the constraints?
 					for (auto c : *rows)
 					{
-						scoreIntS3 += std::max(0.0, c->violation(&integer_afterProj[0]));
+						scoreIntS3 += std::max(0.0, c.violation(&integer_afterProj[0]));
 					}
 					if (stage3bestObjIntegers)
 					{
@@ -1870,15 +2103,15 @@ namespace dominiqs
 						scoreIntS3 *= (1 + abs(currentObjValue - dualBound));
 					}
 				}
-				std::list<DistVector> *p;
+				std::list<DistPoint> *p;
 
 				if (stage == 1)
 					p = &closestIntegerXs1;
 				else
 					p = &closestIntegerXs2;
 
-				std::list<DistVector>::const_iterator itr_cl = p->begin();
-				std::list<DistVector>::const_iterator end_cl = p->end();
+				std::list<DistPoint>::const_iterator itr_cl = p->begin();
+				std::list<DistPoint>::const_iterator end_cl = p->end();
 
 				bool pointAdded = false;
 				while ((itr_cl != end_cl))
@@ -1887,14 +2120,14 @@ namespace dominiqs
 					if (lessEqualThan(scoreIntS3, itr_cl->first))
 					{
 						pointAdded = true;
-						p->insert(itr_cl, DistVector(scoreIntS3, integer_x));
+						p->insert(itr_cl, DistPoint(scoreIntS3, IntegerPoint(pointLayout, integer_x)));
 						break;
 					}
 					itr_cl++;
 				}
 				if ((p->size() < stage3IntegersObj) && (!pointAdded))
 				{
-					p->push_back(DistVector(scoreIntS3, integer_x));
+					p->push_back(DistPoint(scoreIntS3, IntegerPoint(pointLayout, integer_x)));
 				}
 				if (p->size() > stage3IntegersObj)
 					p->resize(stage3IntegersObj);
@@ -1924,7 +2157,6 @@ namespace dominiqs
 			else
 				iterationsNoImpr++;
 
-			// ToDo this check is done twice per iteration. Remove one.
 			lpfeasible = model->isSolutionFeasible(frac_x);
 			if (lpfeasible)
 			{
@@ -1972,6 +2204,10 @@ namespace dominiqs
 			}
 		}
 
+		// remove the delta vars and their linking constraints
+		clearDeltaPool();
+		DOMINIQS_ASSERT(model->ncols() == n);
+
 		// update the limit of iterations for the possible next calls of the feasibility (when within kernel pump).
 		int niter_pump = (nitr - oldIterCnt);
 		if (stage == 1)
@@ -1991,7 +2227,7 @@ namespace dominiqs
 
 	bool FeasibilityPump::stage3()
 	{
-		if (model->aborted())
+		if (model->aborted() || stopRequested())
 			return false;
 		if (closestPoint.empty())
 			return false;
@@ -2129,15 +2365,15 @@ namespace dominiqs
 		if (newStage3)
 		{
 
-			std::list<DistVector> *p;
+			std::list<DistPoint> *p;
 
 			if (closestIntegerXs2.size() >= 1)
 				p = &closestIntegerXs2;
 			else
 				p = &closestIntegerXs1;
 
-			std::list<DistVector>::const_iterator itrInt = p->begin();
-			std::list<DistVector>::const_iterator itrInt_end = p->end();
+			std::list<DistPoint>::const_iterator itrInt = p->begin();
+			std::list<DistPoint>::const_iterator itrInt_end = p->end();
 
 			// scales-weights of the integers in the objective
 			std::vector<double> scaleIntVec;
@@ -2296,57 +2532,125 @@ namespace dominiqs
 		incumbent = x;
 		primalBound = objval;
 		hasIncumbent = true;
+		if (stopFlag)
+			stopFlag->store(true);
 		frac2int->newIncumbent(incumbent, primalBound);
 		lastIntegerX.clear();
 	}
 
-	bool FeasibilityPump::isInCache(double a, const std::vector<double> &x, bool ignoreGeneralIntegers)
+	int FeasibilityPump::useDeltaSlot(int point, int k, double ref, const std::vector<std::string> &xNames, std::vector<int> &colIndices, std::vector<double> &distObj)
 	{
-		bool found = false;
-		std::list<AlphaVector>::const_iterator itr = lastIntegerX.begin();
-		std::list<AlphaVector>::const_iterator end = lastIntegerX.end();
-		if (ignoreGeneralIntegers)
+		DOMINIQS_ASSERT(point * gintegers.size() + k < deltaPoolIdx.size());
+		int &slot = deltaPoolIdx[point * gintegers.size() + k];
+		if (slot < 0)
 		{
-			while ((itr != end) && !found)
-			{
-				if ((fabs(a - itr->first) < alphaDist) && areSolutionsEqual(binaries, itr->second, integer_x, integralityEps))
-					found = true;
-				++itr;
-			}
+			// first use: add the auxiliary variable and its linking constraints
+			int j = gintegers[k];
+			std::string deltaName = xNames[j] + "_delta_" + std::to_string(point);
+			model->addEmptyCol(deltaName, 'C', 0.0, INFBOUND, 0.0);
+			int auxIdx = model->ncols() - 1;
+			DOMINIQS_ASSERT(auxIdx == (int)colIndices.size());
+			colIndices.push_back(auxIdx);
+			distObj.push_back(0.0);
+			SparseVector vec;
+			vec.push(j, 1.0);
+			vec.push(auxIdx, -1.0);
+			model->addRow(xNames[j] + "_d1p" + std::to_string(point), vec.idx(), vec.coef(), 2, 'L', ref);
+			vec.coef()[1] = 1.0;
+			model->addRow(xNames[j] + "_d2p" + std::to_string(point), vec.idx(), vec.coef(), 2, 'G', ref);
+			slot = deltaPool.size();
+			deltaPool.push_back(DeltaSlot{auxIdx, model->nrows() - 2, ref});
 		}
-		else
+		else if (deltaPool[slot].ref != ref)
 		{
-			while ((itr != end) && !found)
-			{
-				if ((fabs(a - itr->first) < alphaDist) && areSolutionsEqual(integers, itr->second, integer_x, integralityEps))
-					found = true;
-				++itr;
-			}
+			// just move the reference value
+			DeltaSlot &ds = deltaPool[slot];
+			ds.ref = ref;
+			deltaRhsIdx.push_back(ds.row);
+			deltaRhsIdx.push_back(ds.row + 1);
+			deltaRhsVal.push_back(ref);
+			deltaRhsVal.push_back(ref);
 		}
-		return found;
+		return deltaPool[slot].col;
+	}
+
+	void FeasibilityPump::flushDeltaRhs()
+	{
+		if (deltaRhsIdx.size())
+			model->rhs(deltaRhsIdx.size(), &deltaRhsIdx[0], &deltaRhsVal[0]);
+		deltaRhsIdx.clear();
+		deltaRhsVal.clear();
+	}
+
+	void FeasibilityPump::clearDeltaPool()
+	{
+		int size = deltaPool.size();
+		if (size)
+		{
+			// the pool is always at the end of the model
+			int begin = model->nrows() - 2 * size;
+			model->delRows(begin, begin + 2 * size - 1);
+			begin = model->ncols() - size;
+			model->delCols(begin, begin + size - 1);
+		}
+		deltaPool.clear();
+		std::fill(deltaPoolIdx.begin(), deltaPoolIdx.end(), -1);
+		deltaRhsIdx.clear();
+		deltaRhsVal.clear();
+	}
+
+	void FeasibilityPump::trackRounding()
+	{
+		// integer_x has just been rounded: the rounder knows which of its columns changed, if anything
+		const std::vector<int> *changed = frac2int->changedColumns();
+		if (!changed)
+		{
+			integerXChanged();
+			return;
+		}
+		intActivityChanges.add(*changed);
+		intHashChanges.add(*changed);
+	}
+
+	void FeasibilityPump::integerXChanged()
+	{
+		intActivityChanges.setAll();
+		intHashChanges.setAll();
+	}
+
+	void FeasibilityPump::updateIntActivity(const std::vector<double> &x)
+	{
+		// unless x is no longer the point intActivity follows (integer_x), only the columns touched since the last update are looked at
+		if (intActivityChanges.all)
+		{
+			intActivity.update(x, nonIntegers);
+			intActivity.update(x, integers);
+		}
+		else
+			intActivity.update(x, intActivityChanges.cols);
+		intActivityChanges.reset();
+	}
+
+	uint64_t FeasibilityPump::integerXHash()
+	{
+		uint64_t h = intHashChanges.all ? lastIntegerX.hash(integer_x) : lastIntegerX.hash(integer_x, intHashChanges.cols);
+		intHashChanges.reset();
+		return h;
 	}
 
 	void FeasibilityPump::infeasibleSupport(const std::vector<double> &x, std::set<int> &supp, bool ignoreGeneralIntegers)
 	{
 		if (supp.empty())
 		{
-			// find set of infeasible constraints
-			std::set<int> infeas;
-			int m = model->nrows();
-			// ToDo check value of nrows() in all stages of feaspump
-			for (int i = 0; i < rows->size(); i++)
-			{
-				ConstraintPtr c = (*rows)[i];
-				if (!c->satisfiedBy(&x[0]))
-					infeas.insert(i);
-			}
+			// infeasible constraints (x is usually close to the last point seen by intActivity)
+			updateIntActivity(x);
 			// find support of infeasible constraints
 			supp.clear();
-			for (auto i : infeas)
+			for (int i : intActivity.violatedRows())
 			{
-				ConstraintPtr c = (*rows)[i];
-				const int *idx = c->row.idx();
-				for (int k = 0; k < c->row.size(); k++)
+				RowView c = (*rows)[i];
+				const int *idx = c.idx;
+				for (int k = 0; k < c.size(); k++)
 				{
 					int j = idx[k];
 					if ((xType[j] == 'B') || ((xType[j] == 'I') && !ignoreGeneralIntegers))
@@ -2425,7 +2729,7 @@ namespace dominiqs
 				intViolation = 0.0;
 				for (auto c : *rows)
 				{
-					intViolation = std::max(intViolation, c->violation(&currentInt[0]));
+					intViolation = std::max(intViolation, c.violation(&currentInt[0]));
 				}
 				// choose integer with the smallest total constraint violation
 				if (intViolation < smallestViolation)
@@ -2459,15 +2763,15 @@ namespace dominiqs
 	bool FeasibilityPump::isComponentSameS3(int idx)
 	{
 		bool isSame = true;
-		std::list<DistVector> *p;
+		std::list<DistPoint> *p;
 
 		if (closestIntegerXs2.size() >= 1)
 			p = &closestIntegerXs2;
 		else
 			p = &closestIntegerXs1;
 
-		std::list<DistVector>::const_iterator itrInt = p->begin();
-		std::list<DistVector>::const_iterator itrIntEnd = p->end();
+		std::list<DistPoint>::const_iterator itrInt = p->begin();
+		std::list<DistPoint>::const_iterator itrIntEnd = p->end();
 		double value = itrInt->second[idx];
 		while ((itrInt != itrIntEnd) && isSame)
 		{
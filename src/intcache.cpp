@@ -0,0 +1,283 @@
+/**
+ * @file intcache.cpp
+ * @brief Compact integer points and hash-indexed cache of the points visited by the Feasibility Pump
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <utils/asserter.h>
+#include <utils/floats.h>
+
+#include "kernelpump/intcache.h"
+
+using namespace dominiqs;
+
+/** splitmix64 finalizer */
+static inline uint64_t mix64(uint64_t z)
+{
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/** random key of the pair (variable j, value v) */
+static inline uint64_t componentKey(int j, long long v)
+{
+	return mix64(((uint64_t)j * 0x9e3779b97f4a7c15ULL) ^ (uint64_t)v);
+}
+
+/** key in the index: combine the point hash with its alpha bucket */
+static inline uint64_t indexKey(uint64_t h, int64_t bucket)
+{
+	return h ^ mix64((uint64_t)bucket + 0x632be59bd9b4e019ULL);
+}
+
+namespace dominiqs
+{
+
+	const int PointLayout::NO_POS = std::numeric_limits<int>::min();
+	const int IntegerPointCache::HISTORY_PER_POINT = 16;
+
+	PointLayout::PointLayout(int n, const std::vector<int> &_binaries, const std::vector<int> &_gintegers,
+							 const std::vector<double> &lb, const std::vector<double> &ub)
+		: binaries(_binaries), gintegers(_gintegers), pos(n, NO_POS)
+	{
+		int nbins = binaries.size();
+		int ngints = gintegers.size();
+		numWords = (nbins + 63) / 64;
+		for (int k = 0; k < nbins; k++)
+			pos[binaries[k]] = k;
+		ref.resize(ngints);
+		for (int k = 0; k < ngints; k++)
+		{
+			int j = gintegers[k];
+			pos[j] = -k - 1;
+			if (greaterThan(lb[j], -INFBOUND))
+				ref[k] = lb[j];
+			else if (lessThan(ub[j], INFBOUND))
+				ref[k] = ub[j];
+			else
+				ref[k] = 0.0;
+		}
+	}
+
+	IntegerPoint::IntegerPoint(PointLayoutPtr _layout, const std::vector<double> &x) : layout(_layout)
+	{
+		DOMINIQS_ASSERT(layout);
+		bits.resize(layout->numWords, 0);
+		const std::vector<int> &binaries = layout->binaries;
+		unsigned int size = binaries.size();
+		for (unsigned int k = 0; k < size; k++)
+		{
+			if (x[binaries[k]] > 0.5)
+				bits[k >> 6] |= (uint64_t(1) << (k & 63));
+		}
+		const std::vector<int> &gintegers = layout->gintegers;
+		size = gintegers.size();
+		for (unsigned int k = 0; k < size; k++)
+		{
+			long long offset = std::llround(x[gintegers[k]] - layout->ref[k]);
+			if (offset)
+			{
+				gpos.push_back(k);
+				gval.push_back(offset);
+			}
+		}
+	}
+
+	double IntegerPoint::operator[](int j) const
+	{
+		int p = layout->pos[j];
+		DOMINIQS_ASSERT(p != PointLayout::NO_POS);
+		if (p >= 0)
+			return (bits[p >> 6] >> (p & 63)) & 1 ? 1.0 : 0.0;
+		int k = -p - 1;
+		auto itr = std::lower_bound(gpos.begin(), gpos.end(), k);
+		if ((itr != gpos.end()) && (*itr == k))
+			return layout->ref[k] + gval[itr - gpos.begin()];
+		return layout->ref[k];
+	}
+
+	void IntegerPoint::unpack(std::vector<double> &x) const
+	{
+		const std::vector<int> &binaries = layout->binaries;
+		unsigned int size = binaries.size();
+		for (unsigned int k = 0; k < size; k++)
+			x[binaries[k]] = (bits[k >> 6] >> (k & 63)) & 1 ? 1.0 : 0.0;
+		const std::vector<int> &gintegers = layout->gintegers;
+		size = gintegers.size();
+		for (unsigned int k = 0; k < size; k++)
+			x[gintegers[k]] = layout->ref[k];
+		size = gpos.size();
+		for (unsigned int i = 0; i < size; i++)
+			x[gintegers[gpos[i]]] += gval[i];
+	}
+
+	bool IntegerPoint::equals(const IntegerPoint &other, bool ignoreGeneralIntegers) const
+	{
+		if (bits != other.bits)
+			return false;
+		if (ignoreGeneralIntegers)
+			return true;
+		return (gpos == other.gpos) && (gval == other.gval);
+	}
+
+	IntegerPointCache::IntegerPointCache() : ignoreGenerals(true), alphaDist(0.0), capacity(0), currHash(0), numHistoryHits(0)
+	{
+	}
+
+	void IntegerPointCache::setup(PointLayoutPtr _layout, bool ignoreGeneralIntegers, double _alphaDist, int _capacity)
+	{
+		layout = _layout;
+		ignoreGenerals = ignoreGeneralIntegers;
+		alphaDist = _alphaDist;
+		capacity = _capacity;
+		subset = layout->binaries;
+		if (!ignoreGenerals)
+			subset.insert(subset.end(), layout->gintegers.begin(), layout->gintegers.end());
+		// start hashing from the all-zero vector
+		hashedVals.assign(subset.size(), 0);
+		currHash = 0;
+		for (int j : subset)
+			currHash ^= componentKey(j, 0);
+		clear();
+	}
+
+	void IntegerPointCache::clear()
+	{
+		points.clear();
+		index.clear();
+		history.clear();
+		historyOrder.clear();
+		numHistoryHits = 0;
+	}
+
+	void IntegerPointCache::rehash(int k, long long v)
+	{
+		if (v != hashedVals[k])
+		{
+			currHash ^= componentKey(subset[k], hashedVals[k]);
+			currHash ^= componentKey(subset[k], v);
+			hashedVals[k] = v;
+		}
+	}
+
+	uint64_t IntegerPointCache::hash(const std::vector<double> &x)
+	{
+		unsigned int size = subset.size();
+		for (unsigned int k = 0; k < size; k++)
+			rehash(k, std::llround(x[subset[k]]));
+		return currHash;
+	}
+
+	uint64_t IntegerPointCache::hash(const std::vector<double> &x, const std::vector<int> &changed)
+	{
+		// subset is binaries followed (in stage 2) by general integers, in layout order
+		int nbins = layout->binaries.size();
+		for (int j : changed)
+		{
+			int p = layout->pos[j];
+			if (p == PointLayout::NO_POS)
+				continue;
+			if (p >= 0)
+				rehash(p, std::llround(x[j]));
+			else if (!ignoreGenerals)
+				rehash(nbins - p - 1, std::llround(x[j]));
+		}
+		return currHash;
+	}
+
+	void IntegerPointCache::push_front(double alpha, const std::vector<double> &x, uint64_t h)
+	{
+		points.push_front(Point{alpha, h, IntegerPoint(layout, x)});
+		uint64_t key = indexKey(h, alphaBucket(alpha));
+		index.emplace(key, points.cbegin());
+		// evict the oldest point: only its hash and alpha are kept
+		if ((capacity > 0) && (points.size() > (std::size_t)capacity))
+		{
+			const_iterator last = std::prev(points.cend());
+			auto range = index.equal_range(indexKey(last->hash, alphaBucket(last->alpha)));
+			for (auto itr = range.first; itr != range.second; ++itr)
+			{
+				if (itr->second == last)
+				{
+					index.erase(itr);
+					break;
+				}
+			}
+			history.emplace(last->hash, last->alpha);
+			historyOrder.emplace_back(last->hash, last->alpha);
+			points.pop_back();
+			// forget the oldest evicted point
+			if (historyOrder.size() > (std::size_t)capacity * HISTORY_PER_POINT)
+			{
+				auto oldest = historyOrder.front();
+				auto range = history.equal_range(oldest.first);
+				for (auto itr = range.first; itr != range.second; ++itr)
+				{
+					if (itr->second == oldest.second)
+					{
+						history.erase(itr);
+						break;
+					}
+				}
+				historyOrder.pop_front();
+			}
+		}
+	}
+
+	bool IntegerPointCache::sameAsLast(const std::vector<double> &x, uint64_t h) const
+	{
+		if (points.empty())
+			return false;
+		if (h != points.front().hash)
+			return false;
+		return points.front().x.equals(IntegerPoint(layout, x), ignoreGenerals);
+	}
+
+	bool IntegerPointCache::contains(double alpha, const std::vector<double> &x, uint64_t h)
+	{
+		int64_t bucket = alphaBucket(alpha);
+		std::unique_ptr<IntegerPoint> packed; //< packed only on a hash hit
+		// |alpha - a| < alphaDist implies the buckets differ by at most one
+		for (int64_t b = bucket - 1; b <= bucket + 1; b++)
+		{
+			auto range = index.equal_range(indexKey(h, b));
+			for (auto itr = range.first; itr != range.second; ++itr)
+			{
+				const Point &p = *(itr->second);
+				if ((p.hash != h) || !(fabs(alpha - p.alpha) < alphaDist))
+					continue;
+				if (!packed)
+					packed.reset(new IntegerPoint(layout, x));
+				if (p.x.equals(*packed, ignoreGenerals))
+					return true;
+			}
+		}
+		// not in the cache: check the evicted points (same alpha window, points compared by hash only)
+		auto range = history.equal_range(h);
+		for (auto itr = range.first; itr != range.second; ++itr)
+		{
+			if (fabs(alpha - itr->second) < alphaDist)
+			{
+				numHistoryHits++;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	int64_t IntegerPointCache::alphaBucket(double a) const
+	{
+		if (alphaDist <= 0.0)
+			return 0;
+		return (int64_t)floor(a / alphaDist);
+	}
+
+} // namespace dominiqs
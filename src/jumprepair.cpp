@@ -0,0 +1,168 @@
+/**
+ * @file jumprepair.cpp
+ * @brief Feasibility Jump style local search repair of rounded points
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <utils/asserter.h>
+
+#include "kernelpump/jumprepair.h"
+
+using namespace dominiqs;
+
+// candidate variables evaluated per move, taken from at most SAMPLE_ROWS violated rows
+static const int SAMPLE_ROWS = 4;
+static const int SAMPLE_VARS = 25;
+// a variable just moved cannot move again for the next TABU_TENURE moves
+static const int TABU_TENURE = 3;
+
+namespace dominiqs
+{
+
+	void JumpRepair::init(ConstraintStorePtr rows, const std::vector<char> &_xType, uint64_t seed, double _eps)
+	{
+		store = rows;
+		cols = &(store->columns());
+		xType = _xType;
+		eps = _eps;
+		weight.assign(store->nrows(), 1.0);
+		lastMoved.assign(store->ncols(), -TABU_TENURE);
+		moves = 0;
+		rnd.setSeed(seed);
+		rnd.warmUp();
+	}
+
+	bool JumpRepair::repair(std::vector<double> &x, RowActivity &activity, const std::vector<double> &lb, const std::vector<double> &ub, int maxMoves)
+	{
+		for (int m = 0; (m < maxMoves) && !activity.isFeasible(); m++)
+		{
+			const std::vector<int> &violated = activity.violatedRows();
+			int bestVar = -1;
+			double bestValue = 0.0;
+			double bestScore = -std::numeric_limits<double>::infinity();
+			int sampled = 0;
+			for (int t = 0; (t < SAMPLE_ROWS) && (sampled < SAMPLE_VARS); t++)
+			{
+				RowView row = (*store)[violated[rnd(violated.size())]];
+				if (!row.size())
+					continue;
+				int offset = rnd(row.size());
+				for (int k = 0; (k < row.size()) && (sampled < SAMPLE_VARS); k++)
+				{
+					int j = row.idx[(offset + k) % row.size()];
+					if ((lb[j] == ub[j]) || (moves - lastMoved[j] < TABU_TENURE))
+						continue;
+					sampled++;
+					double target = jumpTarget(activity, j, x[j], lb[j], ub[j]);
+					// the weighted violation is convex in x_j: the best integer value is next to the target
+					// (if that is the current value, the best move is one step away from it)
+					double values[2] = {target, target};
+					if (xType[j] != 'C')
+					{
+						values[0] = floor(target + eps);
+						values[1] = ceil(target - eps);
+						if (values[0] == x[j])
+							values[0] = x[j] - 1.0;
+						if (values[1] == x[j])
+							values[1] = x[j] + 1.0;
+					}
+					for (double value : values)
+					{
+						if ((value == x[j]) || (value < lb[j]) || (value > ub[j]))
+							continue;
+						double score = moveScore(activity, j, x[j], value);
+						if (score > bestScore)
+						{
+							bestVar = j;
+							bestValue = value;
+							bestScore = score;
+						}
+					}
+				}
+			}
+			// local minimum: make the violated rows heavier (the best move is taken anyway)
+			if (bestScore <= 0.0)
+			{
+				for (int i : violated)
+					weight[i] += 1.0;
+			}
+			if (bestVar < 0)
+				continue;
+			x[bestVar] = bestValue;
+			activity.update(bestVar, bestValue);
+			lastMoved[bestVar] = moves++;
+		}
+		return activity.isFeasible();
+	}
+
+	double JumpRepair::jumpTarget(const RowActivity &activity, int j, double xj, double lb, double ub)
+	{
+		// each row contributes w_i*|a_ij| to the slope of the weighted violation below the value
+		// at which it becomes satisfied from below (down), and above the value at which it becomes
+		// violated again (up): the minimum is where the total slope gets non-negative
+		events.clear();
+		double slope = 0.0;
+		for (int k = cols->start[j]; k < cols->start[j + 1]; k++)
+		{
+			int i = cols->rowIdx[k];
+			double a = cols->coef[k];
+			double rest = activity.activity(i) - a * xj;
+			double down = (a > 0.0) ? activity.lower(i) : activity.upper(i);
+			double up = (a > 0.0) ? activity.upper(i) : activity.lower(i);
+			double c = weight[i] * fabs(a);
+			if (std::isfinite(down))
+			{
+				slope -= c;
+				events.emplace_back((down - rest) / a, c);
+			}
+			if (std::isfinite(up))
+				events.emplace_back((up - rest) / a, c);
+		}
+		double target = -std::numeric_limits<double>::infinity();
+		if (isNegative(slope))
+		{
+			std::sort(events.begin(), events.end());
+			target = std::numeric_limits<double>::infinity();
+			for (const auto &e : events)
+			{
+				slope += e.second;
+				if (!isNegative(slope))
+				{
+					target = e.first;
+					break;
+				}
+			}
+		}
+		// never jump to an infinite bound
+		if ((target <= lb) && (lb > -INFBOUND))
+			return lb;
+		if ((target >= ub) && (ub < INFBOUND))
+			return ub;
+		return std::isfinite(target) ? target : xj;
+	}
+
+	double JumpRepair::moveScore(const RowActivity &activity, int j, double xj, double value) const
+	{
+		// weight of the rows that get satisfied minus weight of the rows that get violated
+		double score = 0.0;
+		double delta = value - xj;
+		for (int k = cols->start[j]; k < cols->start[j + 1]; k++)
+		{
+			int i = cols->rowIdx[k];
+			double act = activity.activity(i) + cols->coef[k] * delta;
+			bool before = isPositive(activity.violation(i), eps);
+			bool after = isPositive(std::max(act - activity.upper(i), activity.lower(i) - act), eps);
+			if (before != after)
+				score += before ? weight[i] : -weight[i];
+		}
+		return score;
+	}
+
+} // namespace dominiqs
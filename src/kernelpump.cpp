@@ -9,6 +9,43 @@ using namespace dominiqs;
 // DEFAULT Kernel Search parameters.
 static const int K_KP_DEFAULT_NUM_BUCKET_LAYERS = 10;
 static const int K_KP_DEFAULT_NAX_SIZE_BUCKETS = 100;
+static const int K_KP_DEFAULT_DEPENDENCY_MAX_ROW_LENGTH = 0;
+static const int K_KP_DEFAULT_SPECULATIVE_BUCKETS = 0;
+static const double K_KP_DEFAULT_SCHEDULE_BOOST = 2.0;
+static const int K_KP_DEFAULT_SCHEDULE_MIN_ITERATIONS = 10;
+static const double K_KP_DEFAULT_SCHEDULE_IMPR_THRESHOLD = 0.05;
+static const int K_KP_BASE_MODEL_SPACE = -2; // model space of the presolved pump base model (see PumpModelSpace()).
+
+// init the pump on a model that is going to be re-entered with tighter bounds: presolve it with primal reductions only,
+// which stay valid for any restriction of the bounds (a dual reduction might cut off all the solutions of a bucket).
+static bool InitPumpPrimalPresolve(FeasibilityPump &pump, MIPModelPtr model)
+{
+    int dual_reductions = model->intParam(IntParam::DualReductions);
+    model->intParam(IntParam::DualReductions, 0);
+    bool ok = pump.init(model);
+    model->intParam(IntParam::DualReductions, dual_reductions);
+    return ok;
+}
+
+// model space of a pump (on_base: initialized on the pump base model). Presolve is deterministic: all the presolves of
+// the pump base model give the same space, also in different pumps. The space of any other presolve is its own.
+static int PumpModelSpace(const FeasibilityPump &pump, bool on_base)
+{
+    int space = pump.getModelSpace();
+    return (on_base && space > 0) ? K_KP_BASE_MODEL_SPACE : space;
+}
+
+// a basis of this model space fits any pump with the same one (and not only the pump it comes from).
+static bool SharedModelSpace(int space)
+{
+    return (space == 0) || (space == K_KP_BASE_MODEL_SPACE);
+}
+
+// random stream of the pump on a bucket: the same whether the serial pump or a speculative one pumps it.
+static uint64_t BucketSeed(uint64_t seed, int bucket_index)
+{
+    return seed + bucket_index + 1;
+}
 
 void KernelPump::Reset()
 {
@@ -21,6 +58,13 @@ void KernelPump::Reset()
     has_presolve_ = false;
     solution_.clear();
     cols_dependency_.reset();
+    pump_base_model_.reset();
+    pristine_model_.reset();
+    binaries_lb_.clear();
+    pump_on_base_ = false;
+    kernel_basis_space_ = -1;
+    speculative_iterations_ = 0;
+    scheduler_.reset();
     first_bucket_to_iter_pump_ = -1;
 }
 
@@ -59,6 +103,15 @@ void KernelPump::readConfig()
     buckets_by_variable_dependency_ = gConfig().get("kp.buildBucketsConsideringVariableDependency", false);
     num_bucket_layers_ = gConfig().get("kp.numBucketLayers", K_KP_DEFAULT_NUM_BUCKET_LAYERS);
     max_size_buckets_ = gConfig().get("kp.maxBucketSize", K_KP_DEFAULT_NAX_SIZE_BUCKETS);
+    dependency_max_row_length_ = gConfig().get("kp.dependencyMaxRowLength", K_KP_DEFAULT_DEPENDENCY_MAX_ROW_LENGTH);
+    presolve_once_ = gConfig().get("kp.presolveOnce", true);
+    speculative_buckets_ = gConfig().get("kp.speculativeBuckets", K_KP_DEFAULT_SPECULATIVE_BUCKETS);
+    adaptive_schedule_ = gConfig().get("kp.adaptiveSchedule", false);
+    warm_start_basis_ = gConfig().get("kp.warmStartBasis", true);
+    double schedule_boost = gConfig().get("kp.scheduleBoost", K_KP_DEFAULT_SCHEDULE_BOOST);
+    int schedule_min_iterations = gConfig().get("kp.scheduleMinIterations", K_KP_DEFAULT_SCHEDULE_MIN_ITERATIONS);
+    double schedule_impr_threshold = gConfig().get("kp.scheduleImprThreshold", K_KP_DEFAULT_SCHEDULE_IMPR_THRESHOLD);
+    scheduler_.setup(schedule_boost, schedule_min_iterations, schedule_impr_threshold);
 
     // log.
     consoleInfo("[config kp]");
@@ -74,6 +127,14 @@ void KernelPump::readConfig()
     LOG_ITEM("kp.buildBucketsConsideringVariableDependency", buckets_by_variable_dependency_);
     LOG_ITEM("kp.numBucketLayers", num_bucket_layers_);
     LOG_ITEM("kp.maxBucketSize", max_size_buckets_);
+    LOG_ITEM("kp.dependencyMaxRowLength", dependency_max_row_length_);
+    LOG_ITEM("kp.presolveOnce", presolve_once_);
+    LOG_ITEM("kp.speculativeBuckets", speculative_buckets_);
+    LOG_ITEM("kp.adaptiveSchedule", adaptive_schedule_);
+    LOG_ITEM("kp.warmStartBasis", warm_start_basis_);
+    LOG_ITEM("kp.scheduleBoost", schedule_boost);
+    LOG_ITEM("kp.scheduleMinIterations", schedule_min_iterations);
+    LOG_ITEM("kp.scheduleImprThreshold", schedule_impr_threshold);
 }
 
 bool KernelPump::Init(MIPModelPtr model)
@@ -206,7 +267,7 @@ bool KernelPump::BuildKernelAndBuckets(double time_limit)
     if (buckets_by_variable_dependency_)
     {
         consoleInfo("[computing vars dependency]");
-        cols_dependency_ = model_->colsDependency();
+        cols_dependency_ = model_->colsDependency(dependency_max_row_length_);
         // model_->printDependencies();
     }
 
@@ -679,8 +740,9 @@ int KernelPump::addVarToBucket(int var_index, const std::vector<double> &var_val
         // also add dependent variables if the case.
         if (buckets_by_variable_dependency_)
         {
-            auto &var_dependency = (*cols_dependency_)[var_index];
-            for (int dependent_var = var_dependency.find_first(); dependent_var != boost::dynamic_bitset<>::npos; dependent_var = var_dependency.find_next(dependent_var))
+            std::vector<int> var_dependency;
+            cols_dependency_->neighbors(var_index, var_dependency);
+            for (int dependent_var : var_dependency)
             {
                 // only add binary variables not yet added and with relaxation value greater than zero.
                 if (!total_added_vars_bitset[dependent_var] && binaries_[dependent_var] && greaterThan(var_values[dependent_var], 0))
@@ -695,11 +757,215 @@ int KernelPump::addVarToBucket(int var_index, const std::vector<double> &var_val
     return num_vars_added;
 }
 
+// bounds of the binaries for a reference kernel (as set in model_ by updateModelVarBounds).
+void KernelPump::ReferenceKernelBounds(const boost::dynamic_bitset<> &active_binaries, std::vector<int> &cols, std::vector<double> &lbs, std::vector<double> &ubs) const
+{
+    cols.clear();
+    lbs.clear();
+    ubs.clear();
+    for (int var_index = binaries_.find_first(); var_index != boost::dynamic_bitset<>::npos; var_index = binaries_.find_next(var_index))
+    {
+        cols.push_back(var_index);
+        lbs.push_back(binaries_lb_[var_index]);
+        ubs.push_back(active_binaries[var_index] ? 1.0 : 0.0);
+    }
+}
+
+bool KernelPump::InitPump(const boost::dynamic_bitset<> &active_binaries)
+{
+    if (!presolve_once_)
+        return feasibility_pump_.init(model_);
+
+    std::vector<int> cols;
+    std::vector<double> lbs;
+    std::vector<double> ubs;
+    ReferenceKernelBounds(active_binaries, cols, lbs, ubs);
+
+    if (!pump_on_base_)
+    {
+        // first call, or the last bucket had to be presolved on its own: presolve the model with all the binaries active.
+        pump_base_model_ = pristine_model_->clone();
+        pump_on_base_ = InitPumpPrimalPresolve(feasibility_pump_, pump_base_model_);
+    }
+    if (pump_on_base_ && feasibility_pump_.updateBounds(cols, lbs, ubs))
+        return true;
+
+    // bucket bounds invalidate the presolve reductions: presolve from scratch a copy of the pristine model with the bucket bounds
+    // (model_ itself might carry other changes). The pump is not re-entered on it, so all the reductions are fine.
+    consoleLog("bucket bounds not compatible with the presolved model: presolving again");
+    MIPModelPtr bucket_model = pristine_model_->clone();
+    for (unsigned int k = 0; k < cols.size(); k++)
+    {
+        bucket_model->lb(cols[k], lbs[k]);
+        bucket_model->ub(cols[k], ubs[k]);
+    }
+    pump_on_base_ = false;
+    return feasibility_pump_.init(bucket_model);
+}
+
+KernelPump::BucketResult KernelPump::PumpBucket(FeasibilityPump &pump, double time_limit, bool stop_with_no_impr_limit, const std::vector<double> &closest_frac, double closest_dist) const
+{
+    BucketResult result;
+    // give warm start to FP (with best frac basis found so far) only if a basis exists AND reset_fp_initial_basis_at_new_loop_ == false.
+    std::vector<double> xStartFrac;
+    double xStartDist = INFBOUND;
+    bool lp_primal_feas = false;
+    if (!reset_fp_initial_basis_at_new_loop_ && !closest_frac.empty())
+    {
+        xStartFrac = closest_frac;
+        xStartDist = closest_dist;
+        lp_primal_feas = true;
+    }
+
+    // the pump statistics are cumulative over its calls.
+    IterBudget budget_before = pump.getIterBudget();
+    int iterations_before = pump.getIterations();
+    int cycles_before = pump.getCycles();
+    StopWatch pump_watch(true);
+
+    auto pump_result = pump.pump(time_limit, stop_with_no_impr_limit, xStartFrac, xStartDist, lp_primal_feas);
+
+    result.found_int_feasible_solution = std::get<0>(pump_result);
+    result.feasible_fp = std::get<1>(pump_result);
+    result.closest_dist = pump.getClosestDist();
+    result.time = pump_watch.getElapsed();
+    result.iterations = pump.getIterations() - iterations_before;
+    result.cycles = pump.getCycles() - cycles_before;
+    result.used = budget_before.used(pump.getIterBudget());
+    if (result.found_int_feasible_solution)
+    {
+        pump.getSolution(result.solution);
+        result.primal_bound = pump.getPrimalBound();
+    }
+    else if (result.feasible_fp && lessThan(result.closest_dist, closest_dist))
+        pump.getClosestFrac(result.closest_frac);
+    return result;
+}
+
+void KernelPump::LaunchSpeculativeBuckets(int curr_bucket_index, const boost::dynamic_bitset<> &curr_reference_kernel, double time_per_bucket, double time_limit)
+{
+    // clones share the solver environment of model_: each speculative pump loads a copy of the problem into a model of its own.
+    if (!model_factory_)
+        return;
+    int total_num_buckets = buckets_bitsets_.size();
+    int last_bucket_index = std::min(curr_bucket_index + speculative_buckets_, total_num_buckets - 1);
+    std::shared_ptr<const ModelData> data;
+    for (int bucket_index = curr_bucket_index + 1; bucket_index <= last_bucket_index; ++bucket_index)
+    {
+        if (FindSpeculativeBucket(bucket_index))
+            continue;
+
+        if (!data)
+        {
+            // with presolve_once_, the pristine model (each pump sets the bucket bounds as InitPump does); otherwise, model_ with the bounds of curr_reference_kernel.
+            auto model_data = std::make_shared<ModelData>();
+            (presolve_once_ ? pristine_model_ : model_)->getModelData(*model_data);
+            data = model_data;
+        }
+
+        // the reference kernel the serial loop would use if the kernel did not change until then.
+        auto spec_reference_kernel = curr_kernel_bitset_ | buckets_bitsets_[bucket_index];
+        auto spec = std::make_unique<SpeculativeBucket>();
+        spec->bucket_index = bucket_index;
+        spec->kernel = curr_kernel_bitset_;
+        spec->closest_dist = closest_dist_;
+        spec->pump = std::make_unique<FeasibilityPump>();
+        spec->pump->readConfig();
+        spec->pump->setStopFlag(&(spec->stop));
+        // the same iteration limits and random stream as the serial pump: the limits left now are an upper bound on the
+        // ones left once the turn of the bucket comes, so the result is checked against those before it is used.
+        spec->budget = feasibility_pump_.getIterBudget();
+        spec->pump->setIterBudget(spec->budget);
+        if (warm_start_basis_ && SharedModelSpace(kernel_basis_space_))
+        {
+            spec->start_basis = kernel_basis_;
+            spec->start_basis_space = kernel_basis_space_;
+        }
+        std::vector<int> cols;
+        std::vector<double> lbs;
+        std::vector<double> ubs;
+        if (presolve_once_)
+            ReferenceKernelBounds(spec_reference_kernel, cols, lbs, ubs);
+
+        bool stop_with_no_impr_limit = (bucket_index != total_num_buckets - 1);
+        // a guess of the budget of the bucket: checked against the actual one when the result is used.
+        spec->time_limit = stop_with_no_impr_limit ? time_per_bucket : std::max(time_limit - kp_watch_.getElapsed(), 0.0);
+        SpeculativeBucket *s = spec.get();
+        spec->result = std::async(std::launch::async, [this, s, data, entering = spec_reference_kernel - curr_reference_kernel, leaving = curr_reference_kernel - spec_reference_kernel,
+                                                       cols = std::move(cols), lbs = std::move(lbs), ubs = std::move(ubs), stop_with_no_impr_limit, closest_frac = closest_frac_, closest_dist = closest_dist_]()
+                                  {
+                                      BucketResult result;
+                                      if (s->stop)
+                                          return result;
+                                      s->model = model_factory_();
+                                      s->model->loadModel(*data);
+                                      bool ok = false;
+                                      if (!presolve_once_)
+                                      {
+                                          s->model->updateModelVarBounds(entering, leaving);
+                                          ok = !s->stop && s->pump->init(s->model);
+                                      }
+                                      else if (!s->stop)
+                                      {
+                                          // same steps as InitPump: the pump base model re-entered with the bucket bounds, or else the bucket presolved on its own.
+                                          s->on_base = InitPumpPrimalPresolve(*s->pump, s->model) && s->pump->updateBounds(cols, lbs, ubs);
+                                          ok = s->on_base;
+                                          if (!ok && !s->stop)
+                                          {
+                                              s->model = model_factory_();
+                                              s->model->loadModel(*data);
+                                              for (unsigned int k = 0; k < cols.size(); k++)
+                                              {
+                                                  s->model->lb(cols[k], lbs[k]);
+                                                  s->model->ub(cols[k], ubs[k]);
+                                              }
+                                              ok = s->pump->init(s->model);
+                                          }
+                                      }
+                                      if (ok && !s->stop)
+                                      {
+                                          if ((s->start_basis_space != -1) && (s->start_basis_space == PumpModelSpace(*s->pump, s->on_base)))
+                                              s->pump->setStartBasis(s->start_basis);
+                                          s->pump->reseed(BucketSeed(s->pump->getSeed(), s->bucket_index));
+                                          result = PumpBucket(*s->pump, s->time_limit, stop_with_no_impr_limit, closest_frac, closest_dist);
+                                      }
+                                      return result; });
+        consoleLog("speculative pump launched on bucket {}/{}", bucket_index + 1, total_num_buckets);
+        speculative_.push_back(std::move(spec));
+    }
+}
+
+KernelPump::SpeculativeBucket *KernelPump::FindSpeculativeBucket(int bucket_index)
+{
+    for (auto &spec : speculative_)
+    {
+        if (spec->bucket_index == bucket_index)
+            return spec.get();
+    }
+    return nullptr;
+}
+
+void KernelPump::StopSpeculativeBuckets()
+{
+    for (auto &spec : speculative_)
+        spec->stop = true;
+    for (auto &spec : discarded_)
+        spec->stop = true;
+    for (auto &spec : speculative_)
+        spec->result.wait();
+    for (auto &spec : discarded_)
+        spec->result.wait();
+    speculative_.clear();
+    discarded_.clear();
+}
+
 bool KernelPump::Run(double time_limit)
 {
     if (!model_)
         return false;
     kp_watch_.start();
+    if ((speculative_buckets_ > 0) && !model_factory_)
+        consoleWarn("kp.speculativeBuckets ignored: no model factory set");
 
     auto num_vars = model_->ncols();
     double curr_fp_closet_dist = INFBOUND;
@@ -717,6 +983,14 @@ bool KernelPump::Run(double time_limit)
         // init feasibility pump.
         feasibility_pump_.readConfig();
 
+        // the pump is presolved once on the model with all the binaries active, and then re-entered with the bounds of each bucket.
+        if (presolve_once_)
+        {
+            pristine_model_ = model_->clone();
+            binaries_lb_.resize(num_vars);
+            model_->lbs(&binaries_lb_[0]);
+        }
+
         // initially, deactivate all the binary variables.
         model_->updateModelVarBounds(std::nullopt, binaries_);
 
@@ -733,7 +1007,11 @@ bool KernelPump::Run(double time_limit)
         for (curr_bucket_index = -1; curr_bucket_index < total_num_buckets; ++curr_bucket_index)
         {
             // if last bucket, leave running for all the remaining time left.
-            curr_time_limit_iteration = (curr_bucket_index == total_num_buckets - 1) ? std::max(time_limit - kp_watch_.getElapsed(), 0.0) : min_time_per_bucket;
+            time_left = std::max(time_limit - kp_watch_.getElapsed(), 0.0);
+            if (adaptive_schedule_)
+                curr_time_limit_iteration = scheduler_.budget(time_left, total_num_buckets - curr_bucket_index);
+            else
+                curr_time_limit_iteration = (curr_bucket_index == total_num_buckets - 1) ? time_left : min_time_per_bucket;
 
             if (model_->aborted() || lessEqualThan(curr_time_limit_iteration, 0.0))
                 break;
@@ -786,35 +1064,80 @@ bool KernelPump::Run(double time_limit)
                 consoleInfo("[Kp bucket {}/{}]", curr_bucket_index + 1, total_num_buckets);
 
             consoleLog("#active bin vars : {}/{}", curr_reference_kernel.count(), binaries_.count());
-            bool found_int_feasible_solution = false;
-            bool feasible_fp = false;
-            // if init fails, means that the proble is already infeasible for the current bucket.
-            if (feasibility_pump_.init(model_)) // at fp.init, the original MIP problem is possibly presolved and linearly relaxed into an LP.
+
+            // speculative pumps started from a kernel (or a starting point) that is not the current one are useless.
+            for (auto itr = speculative_.begin(); itr != speculative_.end();)
             {
-                // for the last bucket, disable stopping criteria of FP related to max number of iterations without at least x% improvements.
-                bool stop_with_no_impr_limit = (curr_bucket_index != total_num_buckets - 1);
-                // give warm start to FP (with best frac basis found so far) only if a basis exists AND reset_fp_initial_basis_at_new_loop_ == false.
-                std::vector<double> xStartPoint, xStartFrac;
-                double xStartDist = INFBOUND;
-                bool lp_primal_feas = false;
-                if (!reset_fp_initial_basis_at_new_loop_ && !closest_frac_.empty())
+                if (((*itr)->kernel != curr_kernel_bitset_) || (!reset_fp_initial_basis_at_new_loop_ && ((*itr)->closest_dist != closest_dist_)))
                 {
-                    xStartFrac = closest_frac_;
-                    xStartDist = closest_dist_;
-                    lp_primal_feas = true;
+                    (*itr)->stop = true;
+                    discarded_.push_back(std::move(*itr));
+                    itr = speculative_.erase(itr);
                 }
+                else
+                    ++itr;
+            }
+            SpeculativeBucket *spec = FindSpeculativeBucket(curr_bucket_index);
+            if (speculative_buckets_ > 0)
+                LaunchSpeculativeBuckets(curr_bucket_index, curr_reference_kernel, curr_time_limit_iteration, time_limit);
 
-                StopWatch tp1;
-                tp1.start();
-
-                auto result = feasibility_pump_.pump(curr_time_limit_iteration, stop_with_no_impr_limit, xStartFrac, xStartDist, lp_primal_feas);
-
-                // if (greaterThan(tp1.getElapsed(), curr_time_limit_iteration))
-                // std::cout << " * KP  bckt " << curr_bucket_index << " " << tp1.getElapsed() << " x " << curr_time_limit_iteration << std::endl;
-
-                found_int_feasible_solution = std::get<0>(result);
-                feasible_fp = std::get<1>(result);
+            BucketResult result;
+            bool pumped = false;
+            if (spec)
+            {
+                // this bucket has already been pumped (or is being pumped) on exactly the same input: take its outcome,
+                // provided it is the one the budget of this bucket would have given.
+                result = spec->result.get();
+                bool hit_time_limit = !lessThan(result.time, spec->time_limit);
+                IterBudget budget = feasibility_pump_.getIterBudget();
+                if (!lessEqualThan(result.time, curr_time_limit_iteration) || (hit_time_limit && !equal(spec->time_limit, curr_time_limit_iteration)))
+                {
+                    consoleLog("speculative pump of bucket {}/{} ran with a different time budget: pumping again", curr_bucket_index + 1, total_num_buckets);
+                    result = BucketResult();
+                }
+                else if (!spec->budget.sameRun(result.used, budget))
+                {
+                    consoleLog("speculative pump of bucket {}/{} went past the iteration limits left: pumping again", curr_bucket_index + 1, total_num_buckets);
+                    result = BucketResult();
+                }
+                else
+                {
+                    consoleLog("using speculative pump of bucket {}/{}", curr_bucket_index + 1, total_num_buckets);
+                    speculative_iterations_ += result.iterations;
+                    // as if the serial pump did the iterations.
+                    feasibility_pump_.setIterBudget(budget.charged(result.used));
+                    int space = PumpModelSpace(*spec->pump, spec->on_base);
+                    if (warm_start_basis_ && SharedModelSpace(space) && spec->pump->getLastBasis(kernel_basis_))
+                        kernel_basis_space_ = space;
+                    pumped = true;
+                }
+                speculative_.erase(std::find_if(speculative_.begin(), speculative_.end(), [spec](const auto &other)
+                                                { return other.get() == spec; }));
+            }
+            // if init fails, means that the proble is already infeasible for the current bucket.
+            if (!pumped && InitPump(curr_reference_kernel)) // at fp.init, the original MIP problem is possibly presolved and linearly relaxed into an LP.
+            {
+                // for the last bucket, disable stopping criteria of FP related to max number of iterations without at least x% improvements.
+                bool stop_with_no_impr_limit = (curr_bucket_index != total_num_buckets - 1);
+                // moving to the next reference kernel mostly relaxes upper bounds, which keeps the previous optimal basis dual feasible.
+                if (warm_start_basis_ && (kernel_basis_space_ == PumpModelSpace(feasibility_pump_, pump_on_base_)))
+                    feasibility_pump_.setStartBasis(kernel_basis_);
+                feasibility_pump_.reseed(BucketSeed(feasibility_pump_.getSeed(), curr_bucket_index));
+                result = PumpBucket(feasibility_pump_, curr_time_limit_iteration, stop_with_no_impr_limit, closest_frac_, closest_dist_);
+                if (warm_start_basis_ && feasibility_pump_.getLastBasis(kernel_basis_))
+                    kernel_basis_space_ = PumpModelSpace(feasibility_pump_, pump_on_base_);
             }
+            bool found_int_feasible_solution = result.found_int_feasible_solution;
+            bool feasible_fp = result.feasible_fp;
+
+            BucketProgress progress;
+            progress.lpFeasible = feasible_fp;
+            progress.startDist = closest_dist_;
+            progress.endDist = result.closest_dist;
+            progress.time = result.time;
+            progress.iterations = result.iterations;
+            progress.cycles = result.cycles;
+            scheduler_.record(progress);
 
             if (feasible_fp && first_bucket_to_iter_pump_ == -1)
                 first_bucket_to_iter_pump_ = curr_bucket_index + 1;
@@ -822,9 +1145,9 @@ bool KernelPump::Run(double time_limit)
             if (found_int_feasible_solution)
             {
                 found_int_feasible_solution_ = true;
-                feasibility_pump_.getSolution(solution_);
-                primal_bound_ = feasibility_pump_.getPrimalBound();
-                closest_dist_ = feasibility_pump_.getClosestDist();
+                solution_ = result.solution;
+                primal_bound_ = result.primal_bound;
+                closest_dist_ = result.closest_dist;
                 ++curr_bucket_index;
                 curr_kernel_bitset_ = curr_reference_kernel;
                 num_binary_vars_with_value_1_in_solution_ = 0;
@@ -848,14 +1171,14 @@ bool KernelPump::Run(double time_limit)
                 {
                     bool found_new_closest_point = false;
                     // if found a new better basis (i.e., a basis with smaller dist from integer), update best basis.
-                    curr_fp_closet_dist = feasibility_pump_.getClosestDist();
+                    curr_fp_closet_dist = result.closest_dist;
                     // std::cout << curr_fp_closet_dist << " x " << closest_dist_ << std::endl;
 
                     if (lessThan(curr_fp_closet_dist, closest_dist_))
                     {
 
                         closest_dist_ = curr_fp_closet_dist;
-                        feasibility_pump_.getClosestFrac(closest_frac_);
+                        closest_frac_ = result.closest_frac;
                         found_new_closest_point = true;
                     }
 
@@ -899,6 +1222,7 @@ bool KernelPump::Run(double time_limit)
             }
         }
 
+        StopSpeculativeBuckets();
         last_bucket_visited_ = curr_bucket_index;
         consoleLog("");
         consoleInfo("[kp results]");
@@ -23,9 +23,11 @@
 #include <utils/path.h>
 
 #include "kernelpump/feaspump.h"
+#include "kernelpump/portfolio.h"
 #include "kernelpump/version.h"
 #include "kernelpump/kernelpump.h"
 #include "kernelpump/solution.h"
+#include "kernelpump/snapshot.h"
 
 #ifdef HAS_CPLEX
 #include "kernelpump/cpxmodel.h"
@@ -48,6 +50,59 @@ using namespace dominiqs;
 
 static const uint64_t DEF_SEED = 0;
 
+/** create an empty model object (with its own environment) for the given solver */
+static MIPModelPtr createModel(const std::string &solver)
+{
+	MIPModelPtr model;
+#ifdef HAS_CPLEX
+	if (solver == "cpx")
+		model = MIPModelPtr(new CPXModel());
+#else
+	if (solver == "cpx")
+		throw std::runtime_error(fmt::format("Did not compile support for solver {}", solver));
+#endif
+#ifdef HAS_XPRESS
+	if (solver == "xprs")
+		model = MIPModelPtr(new XPRSModel());
+#else
+	if (solver == "xprs")
+		throw std::runtime_error(fmt::format("Did not compile support for solver {}", solver));
+#endif
+#ifdef HAS_SCIP
+	if (solver == "scip")
+		model = MIPModelPtr(new SCIPModel());
+#else
+	if (solver == "scip")
+		throw std::runtime_error(fmt::format("Did not compile support for solver {}", solver));
+#endif
+#if defined(HAS_SCIP) && defined(HAS_ORTOOLS)
+	if (solver == "pdlp")
+		model = MIPModelPtr(new PDLPModel());
+#else
+	if (solver == "pdlp")
+		throw std::runtime_error(fmt::format("Did not compile support for solver {}", solver));
+#endif
+	return model;
+}
+
+/**
+ * read the problem with the in-tree MPS/LP reader (if enabled and the format is supported) or the solver one.
+ * With a non-empty snapshotFile, the in-tree reader goes through the binary snapshot of the model.
+ */
+static void readProblem(MIPModelPtr model, const std::string &filename, bool nativeReader, int readerThreads, const std::string &snapshotFile)
+{
+	if (!snapshotFile.empty() && canReadModelFile(filename))
+	{
+		ModelData data;
+		readModelCached(filename, snapshotFile, data, readerThreads);
+		model->loadModelNative(data);
+	}
+	else if (nativeReader && canReadModelFile(filename))
+		model->readModelNative(filename, readerThreads);
+	else
+		model->readModel(filename);
+}
+
 int main(int argc, char const *argv[])
 {
 	// config/options
@@ -73,8 +128,22 @@ int main(int argc, char const *argv[])
 	double pdlpTol = gConfig().get("fp.pdlpTol", 1.0e-6);
 	double pdlpTolDecreaseFactor = gConfig().get("fp.pdlpTolDecreaseFactor", 1.0);
 	double pdlpWarmStart = gConfig().get("fp.pdlpWarmStart", 0);
+	int portfolioWorkers = gConfig().get("portfolio.workers", 1);
+	bool nativeReader = gConfig().get("nativeReader", false);
+	int readerThreads = gConfig().get("readerThreads", 0);
+	bool snapshot = gConfig().get("snapshot", false);
+	std::string snapshotFolder = gConfig().get("snapshotFolder", std::string(""));
 
 	std::string probName = getProbName(Path(args.input[0]).getBasename());
+	// snapshots live next to the model file, unless a folder is given
+	std::string snapshotFile;
+	if (snapshot)
+	{
+		if (snapshotFolder.empty())
+			snapshotFile = args.input[0] + ".kpbin";
+		else
+			snapshotFile = (Path(snapshotFolder) / (Path(args.input[0]).getBasename() + ".kpbin")).getPath();
+	}
 	// logger
 	consoleInfo("Timestamp: {}", currentDateTime());
 	consoleInfo("[config]");
@@ -87,6 +156,9 @@ int main(int argc, char const *argv[])
 	LOG_ITEM("presolve", mipPresolve);
 	LOG_ITEM("mipFeasEmphasis", mipFeasEmphasis);
 	LOG_ITEM("multiThreading", multiThreading);
+	LOG_ITEM("portfolio.workers", portfolioWorkers);
+	LOG_ITEM("nativeReader", nativeReader);
+	LOG_ITEM("snapshot", snapshot);
 	LOG_ITEM("gitHash", KP_GIT_HASH);
 	LOG_ITEM("kpVersion", KP_VERSION);
 	LOG_ITEM("printSol", printSol);
@@ -112,38 +184,9 @@ int main(int argc, char const *argv[])
 	else
 		throw std::runtime_error(fmt::format("Selected invalid method {}", method));
 
-	MIPModelPtr model;
 	StopWatch watch;
 	watch.start();
-#ifdef HAS_CPLEX
-	if (solver == "cpx")
-		model = MIPModelPtr(new CPXModel());
-#else
-	if (solver == "cpx")
-		throw std::runtime_error(fmt::format("Did not compile support for solver {}", solver));
-#endif
-#ifdef HAS_XPRESS
-	if (solver == "xprs")
-		model = MIPModelPtr(new XPRSModel());
-#else
-	if (solver == "xprs")
-		throw std::runtime_error(fmt::format("Did not compile support for solver {}", solver));
-#endif
-#ifdef HAS_SCIP
-	if (solver == "scip")
-		model = MIPModelPtr(new SCIPModel());
-#else
-	if (solver == "scip")
-		throw std::runtime_error(fmt::format("Did not compile support for solver {}", solver));
-#endif
-#if defined(HAS_SCIP) && defined(HAS_ORTOOLS)
-	if (solver == "pdlp")
-		model = MIPModelPtr(new PDLPModel());
-#else
-	if (solver == "pdlp")
-		throw std::runtime_error(fmt::format("Did not compile support for solver {}", solver));
-#endif
-
+	MIPModelPtr model = createModel(solver);
 	if (!model)
 		throw std::runtime_error("No solver available");
 
@@ -159,7 +202,7 @@ int main(int argc, char const *argv[])
 		model->intParam(IntParam::Threads, 1); // IntParam::Threads is solver-agnostic!
 	try
 	{
-		model->readModel(args.input[0]);
+		readProblem(model, args.input[0], nativeReader, readerThreads, snapshotFile);
 
 		// std::vector<double> incumbent{0.3, 0.4, 0.5, 10.0001};
 		// auto result = model->computeRelativeIntegralityGap(incumbent);
@@ -223,6 +266,16 @@ int main(int argc, char const *argv[])
 			// kernel pump
 			KernelPump kp;
 			kp.readConfig();
+			// speculative pumps load the problem into models of their own (with the same settings of model)
+			kp.setModelFactory([&]()
+							   {
+				MIPModelPtr specModel = createModel(solver);
+#ifndef SILENT_EXEC
+				specModel->logging(modelLogging);
+#endif //< SILENT_EXEC
+				if (!multiThreading)
+					specModel->intParam(IntParam::Threads, 1);
+				return specModel; });
 
 			auto result = kp.Init(model);
 			if (result)
@@ -265,6 +318,52 @@ int main(int argc, char const *argv[])
 
 			kp.Reset();
 		}
+		else if (solveFeasPump && (portfolioWorkers != 1))
+		{
+			// portfolio of diversified pumps, each on its own copy of the problem
+			FeasibilityPumpPortfolio portfolio;
+			portfolio.readConfig();
+			auto makeModel = [&]()
+			{
+				MIPModelPtr workerModel = createModel(solver);
+#ifndef SILENT_EXEC
+				workerModel->logging(modelLogging);
+#endif //< SILENT_EXEC
+				if (!multiThreading)
+					workerModel->intParam(IntParam::Threads, 1);
+				if (solver == "pdlp")
+				{
+					workerModel->dblParam(DblParam::PdlpTolerance, pdlpTol);
+					workerModel->dblParam(DblParam::PdlpToleranceDecreaseFactor, pdlpTolDecreaseFactor);
+					workerModel->intParam(IntParam::PdlpWarmStart, pdlpWarmStart);
+				}
+				readProblem(workerModel, args.input[0], nativeReader, readerThreads, snapshotFile);
+				return workerModel;
+			};
+
+			auto timeLeft = std::max(timeLimit - watch.getElapsed(), 0.0);
+			foundSolution = portfolio.run(makeModel, timeLeft);
+			if (foundSolution)
+				portfolio.getSolution(x);
+			watch.stop();
+
+			solution.is_feasible_ = foundSolution;
+			solution.num_iterations_ = portfolio.getIterations();
+			solution.projection_integrality_gap_ = portfolio.getClosestDist();
+			if (foundSolution)
+			{
+				std::tie(solution.real_integrality_gap_, solution.num_frac_) = model->computeIntegralityGap(x, 0.001);
+				DOMINIQS_ASSERT(solution.num_frac_ == 0);
+			}
+			else
+			{
+				std::vector<double> closest_frac;
+				portfolio.getClosestFrac(closest_frac);
+				std::tie(solution.real_integrality_gap_, solution.num_frac_) = model->computeIntegralityGap(closest_frac, 0.001);
+			}
+			std::cout << "gap = " << solution.real_integrality_gap_ << " | num frac= " << solution.num_frac_ << std::endl;
+			solution.total_time_spent_ = watch.getTotal();
+		}
 		else if (solveFeasPump)
 		{
 			// set tolerance for PDLP and warm start parameter
@@ -331,12 +430,11 @@ int main(int argc, char const *argv[])
 			auto rows = model->rows();
 			for (int i = 0; i < m; i++)
 			{
-				const ConstraintPtr &c = (*rows)[i];
-				// model->row(i, c->row, c->sense, c->rhs, c->range);
-				if (c->sense == 'N')
+				RowView c = (*rows)[i];
+				if (c.sense == 'N')
 					continue;
-				if (!c->satisfiedBy(&x[0], 0.001))
-					throw std::runtime_error(fmt::format("Constraint {} violated by {}", rNames[i], c->violation(&x[0])));
+				if (!c.satisfiedBy(&x[0], 0.001))
+					throw std::runtime_error(fmt::format("Constraint {} violated by {}", rNames[i], c.violation(&x[0])));
 			}
 			consoleLog("Double check feasibility done.");
 
@@ -0,0 +1,1215 @@
+/**
+ * @file modelreader.cpp
+ * @brief Native MPS/LP model reader
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <cmath>
+#include <cstring>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+#include <exception>
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include <utils/floats.h>
+#include <fmt/format.h>
+
+#include "kernelpump/modelreader.h"
+
+using namespace dominiqs;
+
+namespace
+{
+
+	typedef std::unordered_map<std::string_view, int> NameMap;
+
+	[[noreturn]] void parseError(const std::string &filename, const std::string &what)
+	{
+		throw std::runtime_error(fmt::format("Error reading {}: {}", filename, what));
+	}
+
+	bool endsWith(const std::string &s, const std::string &suffix)
+	{
+		if (s.size() < suffix.size())
+			return false;
+		return std::equal(suffix.rbegin(), suffix.rend(), s.rbegin(),
+						  [](char a, char b) { return std::tolower((unsigned char)a) == std::tolower((unsigned char)b); });
+	}
+
+	bool equalNoCase(std::string_view a, const char *b)
+	{
+		std::size_t n = std::strlen(b);
+		if (a.size() != n)
+			return false;
+		for (std::size_t k = 0; k < n; k++)
+			if (std::tolower((unsigned char)a[k]) != b[k])
+				return false;
+		return true;
+	}
+
+	inline bool isBlank(char c) { return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\f') || (c == '\v'); }
+
+	/** return the line starting at p (without the line terminator) and move p to the next one */
+	inline std::string_view nextLine(const char *&p, const char *end)
+	{
+		const char *q = (const char *)std::memchr(p, '\n', end - p);
+		if (!q)
+			q = end;
+		std::string_view line(p, q - p);
+		p = (q < end) ? q + 1 : end;
+		if (!line.empty() && (line.back() == '\r'))
+			line.remove_suffix(1);
+		return line;
+	}
+
+	/** split a line into (at most maxTok) whitespace separated tokens */
+	inline int tokenize(std::string_view line, std::string_view *tok, int maxTok)
+	{
+		int n = 0;
+		std::size_t i = 0;
+		std::size_t len = line.size();
+		while (n < maxTok)
+		{
+			while ((i < len) && isBlank(line[i]))
+				i++;
+			if (i == len)
+				break;
+			std::size_t s = i;
+			while ((i < len) && !isBlank(line[i]))
+				i++;
+			tok[n++] = line.substr(s, i - s);
+		}
+		return n;
+	}
+
+	/** parse a number (values beyond INFBOUND are infinite), return false on error */
+	inline bool parseNumber(std::string_view tok, double &value)
+	{
+		const char *first = tok.data();
+		const char *last = first + tok.size();
+		if ((first < last) && (*first == '+'))
+			first++;
+		auto res = std::from_chars(first, last, value);
+		if ((res.ec != std::errc()) || (res.ptr != last))
+			return false;
+		if (value >= INFBOUND)
+			value = INFBOUND;
+		else if (value <= -INFBOUND)
+			value = -INFBOUND;
+		return true;
+	}
+
+	/** integer columns with bounds [0,1] are binaries */
+	void finalizeTypes(ModelData &data)
+	{
+		for (int j = 0; j < data.ncols(); j++)
+		{
+			if ((data.ctype[j] == 'I') && (data.lb[j] == 0.0) && (data.ub[j] == 1.0))
+				data.ctype[j] = 'B';
+		}
+	}
+
+	/** build the CSC matrix from the CSR one */
+	void buildColumns(ModelData &data)
+	{
+		int n = data.ncols();
+		int m = data.nrows();
+		data.colBeg.assign(n + 1, 0);
+		for (int j : data.rowIdx)
+			data.colBeg[j + 1]++;
+		for (int j = 0; j < n; j++)
+			data.colBeg[j + 1] += data.colBeg[j];
+		data.colIdx.resize(data.rowIdx.size());
+		data.colVal.resize(data.rowIdx.size());
+		std::vector<int> next(data.colBeg.begin(), data.colBeg.end() - 1);
+		for (int i = 0; i < m; i++)
+		{
+			for (int k = data.rowBeg[i]; k < data.rowBeg[i + 1]; k++)
+			{
+				int pos = next[data.rowIdx[k]]++;
+				data.colIdx[pos] = i;
+				data.colVal[pos] = data.rowVal[k];
+			}
+		}
+	}
+
+	/** build the CSR matrix from the CSC one */
+	void buildRows(ModelData &data)
+	{
+		int n = data.ncols();
+		int m = data.nrows();
+		data.rowBeg.assign(m + 1, 0);
+		for (int i : data.colIdx)
+			data.rowBeg[i + 1]++;
+		for (int i = 0; i < m; i++)
+			data.rowBeg[i + 1] += data.rowBeg[i];
+		data.rowIdx.resize(data.colIdx.size());
+		data.rowVal.resize(data.colIdx.size());
+		std::vector<int> next(data.rowBeg.begin(), data.rowBeg.end() - 1);
+		for (int j = 0; j < n; j++)
+		{
+			for (int k = data.colBeg[j]; k < data.colBeg[j + 1]; k++)
+			{
+				int pos = next[data.colIdx[k]]++;
+				data.rowIdx[pos] = j;
+				data.rowVal[pos] = data.colVal[k];
+			}
+		}
+	}
+
+	// MPS
+
+	static const int ROW_OBJECTIVE = -1;
+	static const int ROW_FREE = -2; //< N rows other than the objective are dropped
+
+	/** the entries of a piece of the COLUMNS section */
+	struct ColumnChunk
+	{
+		const char *beg;
+		const char *end;
+		// runs of consecutive entries of the same column (or markers)
+		std::vector<std::string_view> names;
+		std::vector<int> runBeg;
+		std::vector<char> marker; //< 0 column, 1 INTORG, 2 INTEND
+		std::vector<int> entryRow;
+		std::vector<double> entryVal;
+		std::exception_ptr error;
+	};
+
+	void parseColumnChunk(const std::string &filename, const NameMap &rowMap, ColumnChunk &chunk)
+	{
+		try
+		{
+			std::string_view tok[6];
+			const char *p = chunk.beg;
+			while (p < chunk.end)
+			{
+				std::string_view line = nextLine(p, chunk.end);
+				if (line.empty() || (line[0] == '*'))
+					continue;
+				int n = tokenize(line, tok, 6);
+				if (n == 0)
+					continue;
+				if ((n >= 3) && ((tok[1] == "'MARKER'") || (tok[1] == "MARKER")))
+				{
+					char type = 0;
+					if ((tok[2] == "'INTORG'") || (tok[2] == "INTORG"))
+						type = 1;
+					else if ((tok[2] == "'INTEND'") || (tok[2] == "INTEND"))
+						type = 2;
+					else
+						parseError(filename, fmt::format("unknown marker {}", tok[2]));
+					chunk.names.push_back(std::string_view());
+					chunk.runBeg.push_back(chunk.entryRow.size());
+					chunk.marker.push_back(type);
+					continue;
+				}
+				if ((n != 3) && (n != 5))
+					parseError(filename, fmt::format("invalid COLUMNS line '{}'", line));
+				if (chunk.names.empty() || chunk.marker.back() || (chunk.names.back() != tok[0]))
+				{
+					chunk.names.push_back(tok[0]);
+					chunk.runBeg.push_back(chunk.entryRow.size());
+					chunk.marker.push_back(0);
+				}
+				for (int k = 1; k < n; k += 2)
+				{
+					auto itr = rowMap.find(tok[k]);
+					if (itr == rowMap.end())
+						parseError(filename, fmt::format("unknown row {} in column {}", tok[k], tok[0]));
+					double value;
+					if (!parseNumber(tok[k + 1], value))
+						parseError(filename, fmt::format("invalid number {}", tok[k + 1]));
+					if (itr->second == ROW_FREE)
+						continue;
+					chunk.entryRow.push_back(itr->second);
+					chunk.entryVal.push_back(value);
+				}
+			}
+			chunk.runBeg.push_back(chunk.entryRow.size());
+		}
+		catch (...)
+		{
+			chunk.error = std::current_exception();
+		}
+	}
+
+	/** RHS and RANGES sections (they only need the rows) */
+	void parseRhsRanges(const std::string &filename, const NameMap &rowMap, std::string_view rhsSection, std::string_view rangesSection,
+						ModelData &data, std::vector<double> &rangeVal, std::vector<char> &hasRange)
+	{
+		std::string_view tok[6];
+		for (int pass = 0; pass < 2; pass++)
+		{
+			std::string_view section = (pass == 0) ? rhsSection : rangesSection;
+			const char *p = section.data();
+			const char *end = p + section.size();
+			while (p < end)
+			{
+				std::string_view line = nextLine(p, end);
+				if (line.empty() || (line[0] == '*'))
+					continue;
+				int n = tokenize(line, tok, 6);
+				if (n == 0)
+					continue;
+				// the set name is optional
+				int first = (n % 2);
+				if (n < 2)
+					parseError(filename, fmt::format("invalid line '{}'", line));
+				for (int k = first; k + 1 < n; k += 2)
+				{
+					auto itr = rowMap.find(tok[k]);
+					if (itr == rowMap.end())
+						parseError(filename, fmt::format("unknown row {}", tok[k]));
+					double value;
+					if (!parseNumber(tok[k + 1], value))
+						parseError(filename, fmt::format("invalid number {}", tok[k + 1]));
+					int i = itr->second;
+					if (pass == 0)
+					{
+						if (i == ROW_OBJECTIVE)
+							data.objOffset = -value;
+						else if (i >= 0)
+							data.rhs[i] = value;
+					}
+					else if (i >= 0)
+					{
+						rangeVal[i] = value;
+						hasRange[i] = true;
+					}
+				}
+			}
+		}
+	}
+
+	void readMPS(const std::string &filename, const FileBuffer &buf, ModelData &data, int threads)
+	{
+		// locate the sections: their headers start in the first column
+		static const char *KNOWN[] = {"NAME", "OBJSENSE", "OBJSENCE", "OBJNAME", "ROWS", "COLUMNS", "RHS", "RANGES", "BOUNDS", "ENDATA",
+									  "SOS", "QMATRIX", "QUADOBJ", "QSECTION", "QCMATRIX", "INDICATORS", "USERCUTS", "LAZYCONS", "CSECTION"};
+		std::unordered_map<std::string_view, std::string_view> sections;
+		std::unordered_map<std::string_view, std::string_view> headerArgs;
+		std::string_view tok[6];
+		const char *p = buf.begin();
+		const char *end = buf.end();
+		const char *open = nullptr;
+		std::string_view openName;
+		while (p < end)
+		{
+			const char *lineBeg = p;
+			std::string_view line = nextLine(p, end);
+			if (line.empty() || isBlank(line[0]) || (line[0] == '*'))
+				continue;
+			int n = tokenize(line, tok, 2);
+			std::string_view key = tok[0];
+			if (std::none_of(std::begin(KNOWN), std::end(KNOWN), [&](const char *s) { return key == s; }))
+				parseError(filename, fmt::format("unknown section {}", key));
+			if (open)
+				sections[openName] = std::string_view(open, lineBeg - open);
+			if (key == "ENDATA")
+			{
+				open = nullptr;
+				break;
+			}
+			if ((key == "SOS") || (key[0] == 'Q') || (key == "INDICATORS") || (key == "USERCUTS") || (key == "LAZYCONS") || (key == "CSECTION"))
+				parseError(filename, fmt::format("section {} is not supported", key));
+			open = p;
+			openName = key;
+			// the argument of a header (NAME, OBJSENSE, ...) is the rest of the line
+			if (n > 1)
+			{
+				std::size_t pos = tok[1].data() - line.data();
+				std::string_view arg = line.substr(pos);
+				while (!arg.empty() && isBlank(arg.back()))
+					arg.remove_suffix(1);
+				headerArgs[key] = arg;
+			}
+		}
+		if (open)
+			sections[openName] = std::string_view(open, end - open);
+		if (!sections.count("ROWS"))
+			parseError(filename, "missing ROWS section");
+		if (headerArgs.count("NAME"))
+			data.name = std::string(headerArgs["NAME"]);
+		// objective sense and name: on the header line (free MPS) or in the section
+		for (const char *key : {"OBJSENSE", "OBJSENCE", "OBJNAME"})
+		{
+			if (!sections.count(key))
+				continue;
+			std::string_view arg = headerArgs[key];
+			if (arg.empty())
+			{
+				std::string_view section = sections[key];
+				const char *q = section.data();
+				while (q < section.data() + section.size() && arg.empty())
+				{
+					int n = tokenize(nextLine(q, section.data() + section.size()), tok, 1);
+					if (n)
+						arg = tok[0];
+				}
+			}
+			if (std::string_view(key) == "OBJNAME")
+				data.objName = std::string(arg);
+			else if (equalNoCase(arg, "max") || equalNoCase(arg, "maximize"))
+				data.objSense = -1;
+			else if (equalNoCase(arg, "min") || equalNoCase(arg, "minimize"))
+				data.objSense = 1;
+			else
+				parseError(filename, fmt::format("invalid objective sense {}", arg));
+		}
+
+		// ROWS
+		NameMap rowMap;
+		{
+			std::string_view section = sections["ROWS"];
+			rowMap.reserve(section.size() / 8);
+			const char *q = section.data();
+			const char *qend = q + section.size();
+			bool hasObjective = false;
+			while (q < qend)
+			{
+				std::string_view line = nextLine(q, qend);
+				if (line.empty() || (line[0] == '*'))
+					continue;
+				int n = tokenize(line, tok, 3);
+				if (n == 0)
+					continue;
+				if ((n != 2) || (tok[0].size() != 1))
+					parseError(filename, fmt::format("invalid ROWS line '{}'", line));
+				char type = std::toupper((unsigned char)tok[0][0]);
+				int idx;
+				if (type == 'N')
+				{
+					bool isObjective = data.objName.empty() ? !hasObjective : (tok[1] == data.objName);
+					idx = isObjective ? ROW_OBJECTIVE : ROW_FREE;
+					if (isObjective)
+					{
+						hasObjective = true;
+						data.objName = std::string(tok[1]);
+					}
+				}
+				else if ((type == 'L') || (type == 'G') || (type == 'E'))
+				{
+					idx = data.sense.size();
+					data.rowNames.push(tok[1]);
+					data.sense.push_back(type);
+				}
+				else
+					parseError(filename, fmt::format("invalid row type {}", tok[0]));
+				if (!rowMap.emplace(tok[1], idx).second)
+					parseError(filename, fmt::format("duplicate row {}", tok[1]));
+			}
+		}
+		int m = data.sense.size();
+		data.rhs.assign(m, 0.0);
+		data.range.assign(m, 0.0);
+		std::vector<double> rangeVal(m, 0.0);
+		std::vector<char> hasRange(m, false);
+
+		// COLUMNS (in parallel chunks) and RHS/RANGES (in parallel with them)
+		std::vector<ColumnChunk> chunks;
+		std::string_view columns = sections["COLUMNS"];
+		if (threads <= 0)
+			threads = std::max((int)std::thread::hardware_concurrency(), 1);
+		const std::size_t MIN_CHUNK = 1 << 20;
+		int nChunks = std::max(1, std::min(threads, (int)(columns.size() / MIN_CHUNK)));
+		const char *cbeg = columns.data();
+		const char *cend = cbeg + columns.size();
+		for (int c = 0; c < nChunks; c++)
+		{
+			const char *e = (c == nChunks - 1) ? cend : cbeg + columns.size() * (c + 1) / nChunks;
+			const char *nl = (e < cend) ? (const char *)std::memchr(e, '\n', cend - e) : nullptr;
+			e = nl ? nl + 1 : cend;
+			if (!chunks.empty() && (e <= chunks.back().end))
+				continue;
+			chunks.emplace_back();
+			chunks.back().beg = chunks.size() > 1 ? chunks[chunks.size() - 2].end : cbeg;
+			chunks.back().end = e;
+		}
+		std::string_view rhsSection = sections["RHS"];
+		std::string_view rangesSection = sections["RANGES"];
+		std::exception_ptr rhsError;
+		auto rhsJob = [&]()
+		{
+			try
+			{
+				parseRhsRanges(filename, rowMap, rhsSection, rangesSection, data, rangeVal, hasRange);
+			}
+			catch (...)
+			{
+				rhsError = std::current_exception();
+			}
+		};
+		std::vector<std::thread> workers;
+		if (threads > 1)
+		{
+			workers.emplace_back(rhsJob);
+			for (unsigned int c = 1; c < chunks.size(); c++)
+				workers.emplace_back(parseColumnChunk, std::cref(filename), std::cref(rowMap), std::ref(chunks[c]));
+		}
+		else
+		{
+			rhsJob();
+			for (unsigned int c = 1; c < chunks.size(); c++)
+				parseColumnChunk(filename, rowMap, chunks[c]);
+		}
+		if (!chunks.empty())
+			parseColumnChunk(filename, rowMap, chunks[0]);
+		for (std::thread &t : workers)
+			t.join();
+		if (rhsError)
+			std::rethrow_exception(rhsError);
+		for (const ColumnChunk &chunk : chunks)
+			if (chunk.error)
+				std::rethrow_exception(chunk.error);
+
+		// merge the chunks: columns are interned in order of appearance
+		NameMap colMap;
+		colMap.reserve(columns.size() / 64);
+		std::vector<int> colCount;
+		std::vector<std::vector<int>> runCol(chunks.size());
+		bool intSection = false;
+		std::size_t nameChars = 0;
+		for (unsigned int c = 0; c < chunks.size(); c++)
+		{
+			const ColumnChunk &chunk = chunks[c];
+			runCol[c].resize(chunk.names.size(), -1);
+			for (unsigned int r = 0; r < chunk.names.size(); r++)
+			{
+				if (chunk.marker[r])
+				{
+					intSection = (chunk.marker[r] == 1);
+					continue;
+				}
+				auto ins = colMap.emplace(chunk.names[r], (int)data.ctype.size());
+				int j = ins.first->second;
+				if (ins.second)
+				{
+					data.ctype.push_back(intSection ? 'I' : 'C');
+					colCount.push_back(0);
+					nameChars += chunk.names[r].size() + 1;
+				}
+				runCol[c][r] = j;
+				for (int k = chunk.runBeg[r]; k < chunk.runBeg[r + 1]; k++)
+					colCount[j] += (chunk.entryRow[k] != ROW_OBJECTIVE);
+			}
+		}
+		int n = data.ctype.size();
+		data.colNames.reserve(n, nameChars);
+		{
+			std::vector<std::string_view> names(n);
+			for (auto &kv : colMap)
+				names[kv.second] = kv.first;
+			for (std::string_view name : names)
+				data.colNames.push(name);
+		}
+		data.obj.assign(n, 0.0);
+		data.lb.assign(n, 0.0);
+		data.ub.assign(n, INFBOUND);
+		data.colBeg.assign(n + 1, 0);
+		for (int j = 0; j < n; j++)
+			data.colBeg[j + 1] = data.colBeg[j] + colCount[j];
+		data.colIdx.resize(data.colBeg[n]);
+		data.colVal.resize(data.colBeg[n]);
+		std::vector<int> next(data.colBeg.begin(), data.colBeg.end() - 1);
+		for (unsigned int c = 0; c < chunks.size(); c++)
+		{
+			const ColumnChunk &chunk = chunks[c];
+			for (unsigned int r = 0; r < chunk.names.size(); r++)
+			{
+				int j = runCol[c][r];
+				if (j < 0)
+					continue;
+				for (int k = chunk.runBeg[r]; k < chunk.runBeg[r + 1]; k++)
+				{
+					if (chunk.entryRow[k] == ROW_OBJECTIVE)
+						data.obj[j] += chunk.entryVal[k];
+					else
+					{
+						int pos = next[j]++;
+						data.colIdx[pos] = chunk.entryRow[k];
+						data.colVal[pos] = chunk.entryVal[k];
+					}
+				}
+			}
+		}
+
+		// ranges
+		for (int i = 0; i < m; i++)
+		{
+			if (!hasRange[i])
+				continue;
+			double r = rangeVal[i];
+			double lo = data.rhs[i];
+			double hi = data.rhs[i];
+			if (data.sense[i] == 'E')
+			{
+				if (r > 0.0)
+					hi += r;
+				else
+					lo += r;
+			}
+			else if (data.sense[i] == 'L')
+				lo -= std::fabs(r);
+			else
+				hi += std::fabs(r);
+			data.sense[i] = 'R';
+			data.rhs[i] = lo;
+			data.range[i] = hi - lo;
+		}
+
+		// BOUNDS
+		std::string_view bounds = sections["BOUNDS"];
+		const char *q = bounds.data();
+		const char *qend = q + bounds.size();
+		while (q < qend)
+		{
+			std::string_view line = nextLine(q, qend);
+			if (line.empty() || (line[0] == '*'))
+				continue;
+			int nt = tokenize(line, tok, 5);
+			if (nt == 0)
+				continue;
+			std::string_view type = tok[0];
+			bool needsValue = !((type == "FR") || (type == "MI") || (type == "PL") || (type == "BV"));
+			// the bound set name is optional
+			int colTok = -1;
+			if (needsValue)
+				colTok = (nt == 4) ? 2 : ((nt == 3) ? 1 : -1);
+			else if (nt == 2)
+				colTok = 1;
+			else if (nt == 4)
+				colTok = 2;
+			else if (nt == 3)
+			{
+				double dummy;
+				colTok = (colMap.count(tok[1]) && !colMap.count(tok[2]) && parseNumber(tok[2], dummy)) ? 1 : 2;
+			}
+			if (colTok < 0)
+				parseError(filename, fmt::format("invalid BOUNDS line '{}'", line));
+			auto itr = colMap.find(tok[colTok]);
+			if (itr == colMap.end())
+				parseError(filename, fmt::format("unknown column {}", tok[colTok]));
+			int j = itr->second;
+			double value = 0.0;
+			if (needsValue && !parseNumber(tok[colTok + 1], value))
+				parseError(filename, fmt::format("invalid number {}", tok[colTok + 1]));
+			if (type == "UP")
+			{
+				// CPLEX convention: a negative upper bound on a column with default lower bound makes it free
+				if ((value < 0.0) && (data.lb[j] == 0.0))
+					data.lb[j] = -INFBOUND;
+				data.ub[j] = value;
+			}
+			else if (type == "LO")
+				data.lb[j] = value;
+			else if (type == "FX")
+				data.lb[j] = data.ub[j] = value;
+			else if (type == "FR")
+			{
+				data.lb[j] = -INFBOUND;
+				data.ub[j] = INFBOUND;
+			}
+			else if (type == "MI")
+				data.lb[j] = -INFBOUND;
+			else if (type == "PL")
+				data.ub[j] = INFBOUND;
+			else if (type == "BV")
+			{
+				data.ctype[j] = 'B';
+				data.lb[j] = 0.0;
+				data.ub[j] = 1.0;
+			}
+			else if (type == "LI")
+			{
+				data.ctype[j] = 'I';
+				data.lb[j] = value;
+			}
+			else if (type == "UI")
+			{
+				data.ctype[j] = 'I';
+				if ((value < 0.0) && (data.lb[j] == 0.0))
+					data.lb[j] = -INFBOUND;
+				data.ub[j] = value;
+			}
+			else
+				parseError(filename, fmt::format("bound type {} is not supported", type));
+		}
+		finalizeTypes(data);
+		buildRows(data);
+	}
+
+	// CPLEX LP
+
+	enum class LPToken
+	{
+		Number,
+		Name,
+		Sign,
+		Cmp,
+		Colon,
+		End
+	};
+
+	struct LPTok
+	{
+		LPToken type;
+		std::string_view text;
+		double value = 0.0; //< number value, sign (+1/-1), or comparison (-1 <=, 0 =, +1 >=)
+		bool lineStart = false;
+	};
+
+	class LPReader
+	{
+	public:
+		LPReader(const std::string &fn, const FileBuffer &buf, ModelData &d) : filename(fn), data(d)
+		{
+			tokenize(buf.begin(), buf.end());
+		}
+		void read();
+
+	private:
+		enum Section
+		{
+			NONE,
+			OBJECTIVE,
+			CONSTRAINTS,
+			BOUNDS,
+			GENERALS,
+			BINARIES,
+			END
+		};
+		const std::string &filename;
+		ModelData &data;
+		std::vector<LPTok> toks;
+		std::size_t pos = 0;
+		NameMap colMap;
+		std::vector<std::string> colNameStore; //< names in order of appearance
+		// current linear expression
+		std::vector<int> exprIdx;
+		std::vector<double> exprVal;
+		std::vector<int> posInExpr;
+		double exprConst = 0.0;
+		// helpers
+		void tokenize(const char *p, const char *end);
+		const LPTok &peek(std::size_t k = 0) const { return toks[std::min(pos + k, toks.size() - 1)]; }
+		Section keyword(std::size_t &len) const;
+		int column(std::string_view name);
+		void parseExpression();
+		bool parseValue(double &value);
+		void parseObjective();
+		void parseConstraint();
+		void parseBound();
+		[[noreturn]] void error(const std::string &what) const { parseError(filename, what); }
+	};
+
+	void LPReader::tokenize(const char *p, const char *end)
+	{
+		bool lineStart = true;
+		while (p < end)
+		{
+			char c = *p;
+			if (c == '\n')
+			{
+				lineStart = true;
+				p++;
+				continue;
+			}
+			if (isBlank(c))
+			{
+				p++;
+				continue;
+			}
+			if (c == '\\')
+			{
+				// comment until the end of the line
+				const char *nl = (const char *)std::memchr(p, '\n', end - p);
+				p = nl ? nl : end;
+				continue;
+			}
+			LPTok t;
+			t.lineStart = lineStart;
+			lineStart = false;
+			const char *s = p;
+			if (std::isdigit((unsigned char)c) || ((c == '.') && (p + 1 < end) && std::isdigit((unsigned char)p[1])))
+			{
+				t.type = LPToken::Number;
+				auto res = std::from_chars(p, end, t.value);
+				if (res.ec != std::errc())
+					error(fmt::format("invalid number '{}'", std::string_view(p, std::min<std::size_t>(end - p, 20))));
+				p = res.ptr;
+			}
+			else if ((c == '+') || (c == '-'))
+			{
+				t.type = LPToken::Sign;
+				t.value = (c == '+') ? 1.0 : -1.0;
+				p++;
+			}
+			else if ((c == '<') || (c == '>') || (c == '='))
+			{
+				t.type = LPToken::Cmp;
+				p++;
+				char d = (p < end) ? *p : 0;
+				if (c == '=')
+				{
+					t.value = (d == '<') ? -1.0 : ((d == '>') ? 1.0 : 0.0);
+					if ((d == '<') || (d == '>') || (d == '='))
+						p++;
+				}
+				else
+				{
+					t.value = (c == '<') ? -1.0 : 1.0;
+					if (d == '=')
+						p++;
+				}
+			}
+			else if (c == ':')
+			{
+				t.type = LPToken::Colon;
+				p++;
+			}
+			else if ((c == '[') || (c == ']') || (c == '^'))
+				error("quadratic terms are not supported");
+			else
+			{
+				t.type = LPToken::Name;
+				while ((p < end) && !isBlank(*p) && !std::strchr("\n\\+-<>=:[]^", *p))
+					p++;
+			}
+			t.text = std::string_view(s, p - s);
+			toks.push_back(t);
+		}
+		LPTok t;
+		t.type = LPToken::End;
+		t.lineStart = true;
+		toks.push_back(t);
+	}
+
+	LPReader::Section LPReader::keyword(std::size_t &len) const
+	{
+		const LPTok &t = peek();
+		len = 1;
+		if (t.type == LPToken::End)
+			return END;
+		if ((t.type != LPToken::Name) || !t.lineStart)
+			return NONE;
+		std::string_view w = t.text;
+		for (const char *k : {"minimize", "minimum", "min", "maximize", "maximum", "max"})
+			if (equalNoCase(w, k))
+				return OBJECTIVE;
+		if (equalNoCase(w, "st") || equalNoCase(w, "s.t.") || equalNoCase(w, "st."))
+			return CONSTRAINTS;
+		if ((equalNoCase(w, "subject") || equalNoCase(w, "such")) && (peek(1).type == LPToken::Name) &&
+			(equalNoCase(peek(1).text, "to") || equalNoCase(peek(1).text, "that")))
+		{
+			len = 2;
+			return CONSTRAINTS;
+		}
+		if (equalNoCase(w, "bounds") || equalNoCase(w, "bound"))
+			return BOUNDS;
+		for (const char *k : {"general", "generals", "gen", "integer", "integers"})
+			if (equalNoCase(w, k))
+				return GENERALS;
+		for (const char *k : {"binary", "binaries", "bin"})
+			if (equalNoCase(w, k))
+				return BINARIES;
+		if (equalNoCase(w, "end"))
+			return END;
+		for (const char *k : {"semi-continuous", "semis", "semi", "sos", "lazy", "user"})
+			if (equalNoCase(w, k))
+				error(fmt::format("section {} is not supported", w));
+		return NONE;
+	}
+
+	int LPReader::column(std::string_view name)
+	{
+		auto ins = colMap.emplace(name, (int)data.ctype.size());
+		if (ins.second)
+		{
+			data.ctype.push_back('C');
+			data.obj.push_back(0.0);
+			data.lb.push_back(0.0);
+			data.ub.push_back(INFBOUND);
+			colNameStore.emplace_back(name);
+			posInExpr.push_back(-1);
+		}
+		return ins.first->second;
+	}
+
+	void LPReader::parseExpression()
+	{
+		for (int j : exprIdx)
+			posInExpr[j] = -1;
+		exprIdx.clear();
+		exprVal.clear();
+		exprConst = 0.0;
+		bool first = true;
+		while (true)
+		{
+			std::size_t len;
+			if (keyword(len) != NONE)
+				break;
+			const LPTok &t = peek();
+			if ((t.type == LPToken::Cmp) || (t.type == LPToken::Colon) || (t.type == LPToken::End))
+				break;
+			double coef = 1.0;
+			bool hasSign = false;
+			while (peek().type == LPToken::Sign)
+			{
+				coef *= peek().value;
+				hasSign = true;
+				pos++;
+			}
+			if (!first && !hasSign)
+				error(fmt::format("missing operator before '{}'", peek().text));
+			first = false;
+			// indicator constraints: "->" is tokenized as a sign followed by a comparison
+			if (peek().type == LPToken::Cmp)
+				error("indicator constraints are not supported");
+			bool hasNumber = false;
+			if (peek().type == LPToken::Number)
+			{
+				coef *= peek().value;
+				hasNumber = true;
+				pos++;
+			}
+			std::size_t len2;
+			if ((peek().type == LPToken::Name) && (keyword(len2) == NONE))
+			{
+				int j = column(peek().text);
+				pos++;
+				if (posInExpr[j] < 0)
+				{
+					posInExpr[j] = exprIdx.size();
+					exprIdx.push_back(j);
+					exprVal.push_back(coef);
+				}
+				else
+					exprVal[posInExpr[j]] += coef;
+			}
+			else if (hasNumber)
+				exprConst += coef;
+			else
+				error(fmt::format("unexpected token '{}'", peek().text));
+		}
+	}
+
+	bool LPReader::parseValue(double &value)
+	{
+		std::size_t save = pos;
+		double sign = 1.0;
+		while (peek().type == LPToken::Sign)
+		{
+			sign *= peek().value;
+			pos++;
+		}
+		const LPTok &t = peek();
+		if (t.type == LPToken::Number)
+			value = sign * t.value;
+		else if ((t.type == LPToken::Name) && (equalNoCase(t.text, "inf") || equalNoCase(t.text, "infinity")))
+			value = sign * INFBOUND;
+		else
+		{
+			pos = save;
+			return false;
+		}
+		pos++;
+		value = std::max(std::min(value, INFBOUND), -INFBOUND);
+		return true;
+	}
+
+	void LPReader::parseObjective()
+	{
+		if ((peek().type == LPToken::Name) && (peek(1).type == LPToken::Colon))
+		{
+			data.objName = std::string(peek().text);
+			pos += 2;
+		}
+		parseExpression();
+		for (unsigned int k = 0; k < exprIdx.size(); k++)
+			data.obj[exprIdx[k]] += exprVal[k];
+		data.objOffset += exprConst;
+	}
+
+	void LPReader::parseConstraint()
+	{
+		std::string name;
+		if ((peek().type == LPToken::Name) && (peek(1).type == LPToken::Colon))
+		{
+			name = std::string(peek().text);
+			pos += 2;
+		}
+		else
+			name = fmt::format("c{}", data.nrows() + 1);
+		// optional left hand side of a ranged row: value <= expression <= value
+		double lhs = -INFBOUND;
+		int lhsCmp = 0;
+		bool ranged = false;
+		{
+			std::size_t save = pos;
+			double value;
+			if (parseValue(value) && (peek().type == LPToken::Cmp))
+			{
+				lhs = value;
+				lhsCmp = (int)peek().value;
+				ranged = true;
+				pos++;
+			}
+			else
+				pos = save;
+		}
+		parseExpression();
+		if (peek().type != LPToken::Cmp)
+			error(fmt::format("missing comparison in constraint {}", name));
+		int cmp = (int)peek().value;
+		pos++;
+		double rhs;
+		if (!parseValue(rhs))
+			error(fmt::format("invalid right hand side in constraint {}", name));
+		rhs -= exprConst;
+		char sense;
+		double range = 0.0;
+		if (ranged)
+		{
+			lhs -= exprConst;
+			if ((lhsCmp != cmp) || (cmp == 0))
+				error(fmt::format("invalid ranged constraint {}", name));
+			double lo = (cmp < 0) ? lhs : rhs;
+			double hi = (cmp < 0) ? rhs : lhs;
+			sense = (lo == hi) ? 'E' : 'R';
+			rhs = lo;
+			range = hi - lo;
+		}
+		else
+			sense = (cmp < 0) ? 'L' : ((cmp > 0) ? 'G' : 'E');
+		data.rowNames.push(name);
+		data.sense.push_back(sense);
+		data.rhs.push_back(rhs);
+		data.range.push_back(range);
+		for (unsigned int k = 0; k < exprIdx.size(); k++)
+		{
+			data.rowIdx.push_back(exprIdx[k]);
+			data.rowVal.push_back(exprVal[k]);
+		}
+		data.rowBeg.push_back(data.rowIdx.size());
+	}
+
+	void LPReader::parseBound()
+	{
+		double value;
+		if (parseValue(value))
+		{
+			// value <= x [<= value]
+			if ((peek().type != LPToken::Cmp) || (peek(1).type != LPToken::Name))
+				error("invalid bound");
+			int cmp = (int)peek().value;
+			int j = column(peek(1).text);
+			pos += 2;
+			if (cmp < 0)
+				data.lb[j] = value;
+			else if (cmp > 0)
+				data.ub[j] = value;
+			else
+				data.lb[j] = data.ub[j] = value;
+			if (peek().type == LPToken::Cmp)
+			{
+				int cmp2 = (int)peek().value;
+				pos++;
+				if (!parseValue(value))
+					error(fmt::format("invalid bound on {}", colNameStore[j]));
+				if (cmp2 < 0)
+					data.ub[j] = value;
+				else if (cmp2 > 0)
+					data.lb[j] = value;
+				else
+					data.lb[j] = data.ub[j] = value;
+			}
+			return;
+		}
+		if (peek().type != LPToken::Name)
+			error(fmt::format("invalid bound '{}'", peek().text));
+		int j = column(peek().text);
+		pos++;
+		if ((peek().type == LPToken::Name) && equalNoCase(peek().text, "free"))
+		{
+			pos++;
+			data.lb[j] = -INFBOUND;
+			data.ub[j] = INFBOUND;
+			return;
+		}
+		if (peek().type != LPToken::Cmp)
+			error(fmt::format("invalid bound on {}", colNameStore[j]));
+		int cmp = (int)peek().value;
+		pos++;
+		if (!parseValue(value))
+			error(fmt::format("invalid bound on {}", colNameStore[j]));
+		if (cmp < 0)
+			data.ub[j] = value;
+		else if (cmp > 0)
+			data.lb[j] = value;
+		else
+			data.lb[j] = data.ub[j] = value;
+	}
+
+	void LPReader::read()
+	{
+		data.rowBeg.assign(1, 0);
+		Section section = NONE;
+		while (true)
+		{
+			std::size_t len;
+			Section next = keyword(len);
+			if (next == END)
+				break;
+			if (next != NONE)
+			{
+				if (next == OBJECTIVE)
+				{
+					std::string_view w = peek().text;
+					data.objSense = (std::tolower((unsigned char)w[1]) == 'a') ? -1 : 1;
+				}
+				pos += len;
+				section = next;
+				if (section == OBJECTIVE)
+					parseObjective();
+				continue;
+			}
+			switch (section)
+			{
+			case CONSTRAINTS:
+				parseConstraint();
+				break;
+			case BOUNDS:
+				parseBound();
+				break;
+			case GENERALS:
+			case BINARIES:
+			{
+				if (peek().type != LPToken::Name)
+					error(fmt::format("unexpected token '{}'", peek().text));
+				int j = column(peek().text);
+				pos++;
+				if (section == BINARIES)
+				{
+					data.ctype[j] = 'B';
+					data.lb[j] = 0.0;
+					data.ub[j] = 1.0;
+				}
+				else
+					data.ctype[j] = 'I';
+				break;
+			}
+			default:
+				error(fmt::format("unexpected token '{}'", peek().text));
+			}
+		}
+		if (data.objName.empty())
+			data.objName = "obj";
+		std::size_t nameChars = 0;
+		for (const std::string &name : colNameStore)
+			nameChars += name.size() + 1;
+		data.colNames.reserve(colNameStore.size(), nameChars);
+		for (const std::string &name : colNameStore)
+			data.colNames.push(name);
+		finalizeTypes(data);
+		buildColumns(data);
+	}
+
+} // namespace
+
+namespace dominiqs
+{
+
+	FileBuffer::FileBuffer(const std::string &filename, bool inflate)
+	{
+		if (inflate && endsWith(filename, ".gz"))
+		{
+			gzFile file = gzopen(filename.c_str(), "rb");
+			if (!file)
+				parseError(filename, "cannot open file");
+			gzbuffer(file, 1 << 20);
+			const std::size_t CHUNK = 1 << 22;
+			int read = 0;
+			do
+			{
+				std::size_t old = inflated.size();
+				inflated.resize(old + CHUNK);
+				read = gzread(file, &inflated[old], CHUNK);
+				inflated.resize(old + std::max(read, 0));
+			} while (read > 0);
+			gzclose(file);
+			if (read < 0)
+				parseError(filename, "corrupted gzip stream");
+			ptr = inflated.data();
+			len = inflated.size();
+			return;
+		}
+		int fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0)
+			parseError(filename, "cannot open file");
+		struct stat st;
+		if (fstat(fd, &st) < 0)
+		{
+			close(fd);
+			parseError(filename, "cannot stat file");
+		}
+		len = st.st_size;
+		if (len > 0)
+		{
+			mapped = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapped == MAP_FAILED)
+			{
+				close(fd);
+				parseError(filename, "cannot map file");
+			}
+			madvise(mapped, len, MADV_SEQUENTIAL);
+			ptr = (const char *)mapped;
+		}
+		close(fd);
+	}
+
+	FileBuffer::~FileBuffer()
+	{
+		if (mapped)
+			munmap(mapped, len);
+	}
+
+	bool canReadModelFile(const std::string &filename)
+	{
+		std::string name = filename;
+		if (endsWith(name, ".gz"))
+			name.resize(name.size() - 3);
+		return endsWith(name, ".mps") || endsWith(name, ".lp");
+	}
+
+	void readModelFile(const std::string &filename, ModelData &data, int threads)
+	{
+		if (!canReadModelFile(filename))
+			parseError(filename, "unknown file format");
+		data = ModelData();
+		FileBuffer buf(filename);
+		std::string name = filename;
+		if (endsWith(name, ".gz"))
+			name.resize(name.size() - 3);
+		if (endsWith(name, ".mps"))
+			readMPS(filename, buf, data, threads);
+		else
+		{
+			LPReader reader(filename, buf, data);
+			reader.read();
+		}
+	}
+
+} // namespace dominiqs
@@ -86,6 +86,7 @@ PDLPModel::~PDLPModel()
 /* Read/Write */
 void PDLPModel::readModel(const std::string &filename)
 {
+	matrixChanged();
 	// read problem from file
 	DOMINIQS_ASSERT(scip);
 	DOMINIQS_ASSERT(SCIPreadProb(scip, filename.c_str(), NULL));
@@ -113,44 +114,59 @@ double PDLPModel::lpopt(char method, bool decrease_tol, bool initial)
 		solver->EnableOutput();
 	else
 		solver->SuppressOutput();
-	absl::lts_20211102::StatusOr<operations_research::pdlp::QuadraticProgram> qp;
 	double current_tol = getPdlpTolerance();
 	setPdlpTolerance(current_tol, pdlpTolDecreaseFactor);
 	if (decrease_tol)
 	{
 		setPdlpTolerance(current_tol, 0.1);
 	}
-	operations_research::MPModelProto output_model;
-
 	dominiqs::StopWatch chrono;
 	chrono.start();
 
-	solver->ExportModelToProto(&output_model);
-	qp = operations_research::pdlp::QpFromMpModelProto(output_model, true, false);
-	DOMINIQS_ASSERT(qp.ok());
-	operations_research::pdlp::QuadraticProgram real_qp = *qp;
+	// rebuild the QP only if the structure of the model changed since the last solve
+	bool rebuilt = false;
+	if (!qp || qpDirty)
+	{
+		operations_research::MPModelProto output_model;
+		solver->ExportModelToProto(&output_model);
+		auto newQp = operations_research::pdlp::QpFromMpModelProto(output_model, true, false);
+		DOMINIQS_ASSERT(newQp.ok());
+		qp = std::move(*newQp);
+		qpDirty = false;
+		rebuilt = true;
+	}
 	double time_model = chrono.getElapsed();
 	if (pdlpWarmStart && !initial)
 	{
-		initial_solution = {output.primal_solution, output.dual_solution};
-		initial_solution->primal_solution.resize(ncols());
-		initial_solution->dual_solution.resize(nrows());
-		// for the added cols and rows we initialize by zero since they may be different cols and rows
-		// than those from the previous iteration
-		for (int i = numRowsPresolved; i < nrows(); i++)
+		int n = qp->variable_lower_bounds.size();
+		int m = qp->constraint_lower_bounds.size();
+		if (!rebuilt && (output.primal_solution.size() == n) && (output.dual_solution.size() == m))
 		{
-			initial_solution->dual_solution[i] = 0;
+			// same structure as the last solve: the previous point can be used as is
+			initial_solution = {output.primal_solution, output.dual_solution};
 		}
-		for (int i = numColsPresolved; i < ncols(); i++)
+		else
 		{
-			initial_solution->primal_solution[i] = 0;
+			initial_solution = {output.primal_solution, output.dual_solution};
+			initial_solution->primal_solution.conservativeResize(n);
+			initial_solution->dual_solution.conservativeResize(m);
+			// for the added cols and rows we initialize by zero since they may be different cols and rows
+			// than those from the previous iteration
+			for (int i = numRowsPresolved; i < m; i++)
+			{
+				initial_solution->dual_solution[i] = 0;
+			}
+			for (int i = numColsPresolved; i < n; i++)
+			{
+				initial_solution->primal_solution[i] = 0;
+			}
 		}
 		output = operations_research::pdlp::PrimalDualHybridGradient(
-			real_qp, params, initial_solution);
+			*qp, params, initial_solution);
 	}
 	else
 		output = operations_research::pdlp::PrimalDualHybridGradient(
-			real_qp, params);
+			*qp, params);
 
 	result_status = output.solve_log.termination_reason();
 	return time_model;
@@ -345,6 +361,10 @@ int PDLPModel::intParam(IntParam which) const
 		case IntParam::IterLimit:
 			SCIPlpiGetIntpar(lpi, SCIP_LPPAR_LPITLIM, &value);
 			break;
+		case IntParam::DualReductions:
+			// no presolve at the LP stage
+			value = 1;
+			break;
 		default:
 			throw std::runtime_error("Unknown integer parameter");
 		}
@@ -367,6 +387,13 @@ int PDLPModel::intParam(IntParam which) const
 		case IntParam::IterLimit:
 			// not needed atm
 			break;
+		case IntParam::DualReductions:
+		{
+			SCIP_Bool allow = TRUE;
+			SCIPgetBoolParam(scip, "misc/allowstrongdualreds", &allow);
+			value = allow ? 1 : 0;
+			break;
+		}
 		default:
 			throw std::runtime_error("Unknown integer parameter");
 		}
@@ -392,6 +419,8 @@ void PDLPModel::intParam(IntParam which, int value)
 			params.mutable_termination_criteria()->set_iteration_limit(value);
 			SCIPlpiSetIntpar(lpi, SCIP_LPPAR_LPITLIM, value);
 			break;
+		case IntParam::DualReductions:
+			break;
 		case IntParam::PdlpWarmStart:
 			if (value > 0)
 				pdlpWarmStart = true;
@@ -420,6 +449,10 @@ void PDLPModel::intParam(IntParam which, int value)
 		case IntParam::IterLimit:
 			// not needed atm
 			break;
+		case IntParam::DualReductions:
+			SCIPsetBoolParam(scip, "misc/allowstrongdualreds", value ? TRUE : FALSE);
+			SCIPsetBoolParam(scip, "misc/allowweakdualreds", value ? TRUE : FALSE);
+			break;
 		case IntParam::PdlpWarmStart:
 			if (value > 0)
 				pdlpWarmStart = true;
@@ -1046,20 +1079,24 @@ void PDLPModel::rowNames(std::vector<std::string> &names, int first, int last) c
 /* Data modifications */
 void PDLPModel::addEmptyCol(const std::string &name, char ctype, double lb, double ub, double obj)
 {
+	matrixChanged();
 	// ToDo for PDLP
 	double pdlpinft = solver->infinity();
 	if (ub >= 1e20)
 		ub = pdlpinft;
 	variables.push_back(solver->MakeNumVar(lb, ub, name));
+	qpDirty = true;
 }
 
 void PDLPModel::addCol(const std::string &name, const int *idx, const double *val, int cnt, char ctype, double lb, double ub, double obj)
 {
+	matrixChanged();
 	// not needed...
 }
 
 void PDLPModel::addRow(const std::string &name, const int *idx, const double *val, int cnt, char sense, double rhs, double rngval)
 {
+	matrixChanged();
 	// ToDo for PDLP
 	if (stageLP)
 	{
@@ -1091,21 +1128,25 @@ void PDLPModel::addRow(const std::string &name, const int *idx, const double *va
 		{
 			con->SetCoefficient(variables[idx[j]], val[j]);
 		}
+		qpDirty = true;
 	}
 }
 
 void PDLPModel::delRow(int ridx)
 {
+	matrixChanged();
 	// not needed
 }
 
 void PDLPModel::delCol(int cidx)
 {
+	matrixChanged();
 	// not needed
 }
 
 void PDLPModel::delRows(int first, int last)
 {
+	matrixChanged();
 	// ToDo for PDLP
 	// Just delete the whole problem and copy the lpi again...
 	DOMINIQS_ASSERT(scip);
@@ -1114,6 +1155,7 @@ void PDLPModel::delRows(int first, int last)
 
 	// clear solver
 	solver->Clear();
+	qpDirty = true;
 
 	// Create model for PDLP
 	double inft = SCIPlpiInfinity(lpi);
@@ -1185,6 +1227,7 @@ void PDLPModel::delRows(int first, int last)
 
 void PDLPModel::delCols(int first, int last)
 {
+	matrixChanged();
 	// ToDo for PDLP
 }
 
@@ -1192,6 +1235,7 @@ void PDLPModel::objSense(ObjSense objsen)
 {
 	// ToDo remove lpi
 	MPObjective *const objective = solver->MutableObjective();
+	qpDirty = true; //< changes the scaling of the whole QP objective
 	if (objsen == ObjSense::MIN)
 	{
 		SCIPlpiChgObjsen(lpi, SCIP_OBJSEN_MINIMIZE);
@@ -1238,6 +1282,34 @@ void PDLPModel::ubs(int cnt, const int *cols, const double *values)
 	// not needed
 }
 
+void PDLPModel::rhs(int cnt, const int *rows, const double *values)
+{
+	matrixChanged();
+	if (stageLP)
+	{
+		double pdlpinft = solver->infinity();
+		for (int i = 0; i < cnt; i++)
+		{
+			MPConstraint *const con = solver->constraint(rows[i]);
+			if (con->lb() <= -pdlpinft)
+				con->SetUB(values[i]);
+			else if (con->ub() >= pdlpinft)
+				con->SetLB(values[i]);
+			else
+			{
+				// equality or ranged row: shift both sides
+				double rngval = con->ub() - con->lb();
+				con->SetBounds(values[i] - rngval, values[i]);
+			}
+			if (qp && !qpDirty)
+			{
+				qp->constraint_lower_bounds[rows[i]] = con->lb();
+				qp->constraint_upper_bounds[rows[i]] = con->ub();
+			}
+		}
+	}
+}
+
 void PDLPModel::fixCol(int cidx, double val)
 {
 	// not needed
@@ -1253,9 +1325,13 @@ void PDLPModel::objcoefs(int cnt, const int *cols, const double *values)
 	if (stageLP)
 	{
 		MPObjective *const objective = solver->MutableObjective();
-		for (int i = 0; i < ncols(); i++)
+		bool inPlace = (qp && !qpDirty);
+		for (int i = 0; i < cnt; i++)
 		{
-			objective->SetCoefficient(variables[i], values[i]);
+			objective->SetCoefficient(variables[cols[i]], values[i]);
+			// the QP stores the objective multiplied by its scaling factor (-1 for maximization)
+			if (inPlace)
+				qp->objective_vector[cols[i]] = values[i] * qp->objective_scaling_factor;
 		}
 	}
 }
@@ -0,0 +1,213 @@
+/**
+ * @file portfolio.cpp
+ * @brief Parallel multi-start Feasibility Pump portfolio
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <thread>
+#include <algorithm>
+#include <exception>
+
+#include <utils/asserter.h>
+#include <utils/fileconfig.h>
+#include <utils/consolelog.h>
+#include <utils/str_utils.h>
+#include <utils/timer.h>
+#include <fmt/format.h>
+
+#include "kernelpump/portfolio.h"
+
+using namespace dominiqs;
+
+// macro type savers
+#define LOG_ITEM(name, value) consoleLog("{} = {}", name, value)
+
+static const int DEF_WORKERS = 1;
+static const uint64_t DEF_SEED = 0;
+static const std::string DEF_ROUNDERS = "propround,std";
+static const std::string DEF_RANKERS = "FRAC,RND,LR";
+static const std::string DEF_ALPHAS = "0.0,1.0";
+static const std::string DEF_ALPHA_FACTORS = "0.9";
+
+static std::string errorMessage(std::exception_ptr error)
+{
+	try
+	{
+		std::rethrow_exception(error);
+	}
+	catch (const std::exception &e)
+	{
+		return e.what();
+	}
+	catch (...)
+	{
+		return "unknown error";
+	}
+}
+
+namespace dominiqs
+{
+
+	FeasibilityPumpPortfolio::FeasibilityPumpPortfolio() : nWorkers(DEF_WORKERS), seed(DEF_SEED), stop(false), winner(-1) {}
+
+	void FeasibilityPumpPortfolio::readConfig()
+	{
+		nWorkers = gConfig().get("portfolio.workers", DEF_WORKERS);
+		if (nWorkers <= 0)
+			nWorkers = std::max((int)std::thread::hardware_concurrency(), 1);
+		seed = gConfig().get<uint64_t>("seed", DEF_SEED);
+		std::string rounderList = gConfig().get("portfolio.rounders", DEF_ROUNDERS);
+		std::string rankerList = gConfig().get("portfolio.rankers", DEF_RANKERS);
+		std::string alphaList = gConfig().get("portfolio.alphas", DEF_ALPHAS);
+		std::string alphaFactorList = gConfig().get("portfolio.alphaFactors", DEF_ALPHA_FACTORS);
+		rounders = split<std::string>(rounderList, ",");
+		rankers = split<std::string>(rankerList, ",");
+		alphas = split<double>(alphaList, ",");
+		alphaFactors = split<double>(alphaFactorList, ",");
+		consoleInfo("[config portfolio]");
+		LOG_ITEM("portfolio.workers", nWorkers);
+		LOG_ITEM("portfolio.rounders", rounderList);
+		LOG_ITEM("portfolio.rankers", rankerList);
+		LOG_ITEM("portfolio.alphas", alphaList);
+		LOG_ITEM("portfolio.alphaFactors", alphaFactorList);
+	}
+
+	void FeasibilityPumpPortfolio::setupWorker(int w)
+	{
+		// the FP and its rounders read their parameters from the global config:
+		// override them for this worker, read, and then put the original ones back
+		FileConfig base = gConfig();
+		if (w > 0)
+		{
+			int k = w - 1;
+			gConfig().set<uint64_t>("seed", seed + w);
+			if (!rounders.empty())
+				gConfig().set("fp.frac2int", rounders[k % rounders.size()]);
+			if (!rankers.empty())
+				gConfig().set("fp.ranker", rankers[(k / std::max((int)rounders.size(), 1)) % rankers.size()]);
+			if (!alphas.empty())
+				gConfig().set("fp.alpha", fmt::format("{}", alphas[k % alphas.size()]));
+			if (!alphaFactors.empty())
+				gConfig().set("fp.alphaFactor", fmt::format("{}", alphaFactors[k % alphaFactors.size()]));
+		}
+		consoleInfo("[portfolio worker {}]", w);
+		LOG_ITEM("seed", gConfig().get<uint64_t>("seed", DEF_SEED));
+		workers[w].fp.reset(new FeasibilityPump());
+		workers[w].fp->readConfig();
+		workers[w].fp->setStopFlag(&stop);
+		gConfig() = base;
+	}
+
+	void FeasibilityPumpPortfolio::runWorker(int w, ModelFactory makeModel, double timeLimit)
+	{
+		Worker &worker = workers[w];
+		try
+		{
+			StopWatch watch(true);
+			worker.model = makeModel();
+			DOMINIQS_ASSERT(worker.model);
+			if (!stop && worker.fp->init(worker.model))
+			{
+				double timeLeft = std::max(timeLimit - watch.getElapsed(), 0.0);
+				worker.fp->pump(timeLeft, false);
+				worker.found = worker.fp->foundSolution();
+			}
+		}
+		catch (...)
+		{
+			worker.error = std::current_exception();
+			// an error in one worker should not hold up the others
+		}
+	}
+
+	bool FeasibilityPumpPortfolio::run(ModelFactory makeModel, double timeLimit)
+	{
+		workers.clear();
+		workers.resize(nWorkers);
+		stop = false;
+		winner = -1;
+		// configuration is read sequentially (global config), pumping is done in parallel
+		for (int w = 0; w < nWorkers; w++)
+			setupWorker(w);
+		std::vector<std::thread> threads;
+		for (int w = 0; w < nWorkers; w++)
+			threads.emplace_back(&FeasibilityPumpPortfolio::runWorker, this, w, makeModel, timeLimit);
+		for (std::thread &t : threads)
+			t.join();
+
+		// pick the worker that found a solution or, failing that, the one with the closest point
+		double bestDist = INFBOUND;
+		std::exception_ptr error;
+		for (int w = 0; w < nWorkers; w++)
+		{
+			const Worker &worker = workers[w];
+			if (worker.error)
+			{
+				// the run may still succeed thanks to the other workers, but the failure must not go unnoticed
+				consoleWarn("portfolio worker {} failed: {}", w, errorMessage(worker.error));
+				if (!error)
+					error = worker.error;
+				continue;
+			}
+			consoleLog("worker {}: found = {} closestDist = {} iterations = {}", w, worker.found,
+					   worker.fp->getClosestDist(), worker.fp->getIterations());
+			if (worker.found)
+			{
+				if ((winner < 0) || !workers[winner].found)
+					winner = w;
+			}
+			else if (((winner < 0) || !workers[winner].found) && (worker.fp->getClosestDist() < bestDist))
+			{
+				bestDist = worker.fp->getClosestDist();
+				winner = w;
+			}
+		}
+		if (winner < 0)
+		{
+			// every worker failed or gave up without a single pumping iteration
+			if (error)
+				std::rethrow_exception(error);
+			for (int w = 0; w < nWorkers; w++)
+				if (workers[w].model)
+					winner = w;
+		}
+		LOG_ITEM("portfolio.winner", winner);
+		return foundSolution();
+	}
+
+	void FeasibilityPumpPortfolio::getSolution(std::vector<double> &x) const
+	{
+		DOMINIQS_ASSERT(foundSolution());
+		workers[winner].fp->getSolution(x);
+	}
+
+	void FeasibilityPumpPortfolio::getClosestFrac(std::vector<double> &frac) const
+	{
+		if (winner < 0)
+		{
+			frac.clear();
+			return;
+		}
+		workers[winner].fp->getClosestFrac(frac);
+	}
+
+	double FeasibilityPumpPortfolio::getClosestDist() const
+	{
+		if (winner < 0)
+			return INFBOUND;
+		return workers[winner].fp->getClosestDist();
+	}
+
+	int FeasibilityPumpPortfolio::getIterations() const
+	{
+		int iterations = 0;
+		for (const Worker &worker : workers)
+			if (worker.fp)
+				iterations += worker.fp->getIterations();
+		return iterations;
+	}
+
+} // namespace dominiqs
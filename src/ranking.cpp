@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 #include <utils/sorting.h>
 #include <utils/fileconfig.h>
@@ -95,33 +96,122 @@ void FractionalityRanker::readConfig()
 	LOG_CONFIG(noiseAfter);
 }
 
+void FractionalityRanker::diversify(bool reverseOrder, uint64_t seed)
+{
+	rnd.setSeed(seed);
+	rnd.warmUp();
+	if (reverseOrder)
+		reverse = !reverse;
+	else
+	{
+		// noise from the very first call
+		rankNoise = std::max(rankNoise, FRAC_RANKER_RANK_NOISE_DEF);
+		noiseAfter = -1;
+	}
+}
+
+void FractionalityRanker::reseed(uint64_t seed)
+{
+	rnd.setSeed(seed);
+	rnd.warmUp();
+}
+
 void FractionalityRanker::ignoreGeneralIntegers(bool flag)
 {
 	Ranker::ignoreGeneralIntegers(flag);
-	// reserve memory for scores and permutation
-	scores.resize(integers.size());
-	perm.resize(integers.size());
+	// start over: the next call looks at all the values
+	unsigned int n = integers.size();
+	nBinaries = flag ? n : binaries.size();
+	lastX.assign(n, std::numeric_limits<double>::quiet_NaN());
+	viol.assign(n, 0.0);
+	fracPos.assign(n, -1);
+	fracList.clear();
+	fracOrder.clear();
+	fracBinaries = 0;
+	perm.clear();
+	noisy = false;
+	segment = 0;
+	nextItr = 0;
+}
+
+void FractionalityRanker::sortFractionals()
+{
+	// bucket sort on (class, violation), with binaries before general integers
+	unsigned int nFrac = fracList.size();
+	int nb = nFrac + 1; //< buckets per class
+	bucketBeg.assign(2 * nb + 1, 0);
+	auto bucket = [&](int i) {
+		int b = std::min((int)(viol[i] * 2.0 * nb), nb - 1);
+		return ((unsigned int)i < nBinaries) ? b : nb + b;
+	};
+	for (int i : fracList)
+		bucketBeg[bucket(i) + 1]++;
+	for (int b = 0; b < 2 * nb; b++)
+		bucketBeg[b + 1] += bucketBeg[b];
+	fracBinaries = bucketBeg[nb];
+	fracOrder.resize(nFrac);
+	for (int i : fracList)
+		fracOrder[bucketBeg[bucket(i)]++] = i;
+	// bucketBeg[b] is now the end of bucket b: sort within the buckets, ties broken by index as before
+	auto less = [&](int i1, int i2) { return (viol[i1] < viol[i2]) || ((viol[i1] == viol[i2]) && (i1 < i2)); };
+	int beg = 0;
+	for (int b = 0; b < 2 * nb; b++)
+	{
+		int end = bucketBeg[b];
+		if (end - beg > 16)
+			std::sort(fracOrder.begin() + beg, fracOrder.begin() + end, less);
+		else
+		{
+			for (int k = beg + 1; k < end; k++)
+			{
+				int tmp = fracOrder[k];
+				int h = k;
+				while ((h > beg) && less(tmp, fracOrder[h - 1]))
+				{
+					fracOrder[h] = fracOrder[h - 1];
+					h--;
+				}
+				fracOrder[h] = tmp;
+			}
+		}
+		beg = end;
+	}
+	if (reverse)
+		std::reverse(fracOrder.begin(), fracOrder.end());
 }
 
 void FractionalityRanker::setCurrentState(const std::vector<double> &x)
 {
-	// calculate scores
+	// update the set of fractional variables (integral ones need no score)
 	for (unsigned int i = 0; i < integers.size(); i++)
 	{
-		double s = integralityViolation(x[integers[i]]); // number between 0 and 0.5
-		if (domain->varType(integers[i]) == 'B')
-			s -= 10; // binaries score is always less than general integers
-		scores[i] = Score(s, integers[i]);
-		perm[i] = i;
+		double xi = x[integers[i]];
+		if (xi == lastX[i])
+			continue;
+		lastX[i] = xi;
+		viol[i] = integralityViolation(xi); // number between 0 and 0.5
+		bool isFrac = (viol[i] > 0.0);
+		if (isFrac && (fracPos[i] < 0))
+		{
+			fracPos[i] = fracList.size();
+			fracList.push_back(i);
+		}
+		else if (!isFrac && (fracPos[i] >= 0))
+		{
+			int last = fracList.back();
+			fracList[fracPos[i]] = last;
+			fracPos[last] = fracPos[i];
+			fracList.pop_back();
+			fracPos[i] = -1;
+		}
 	}
 	// sort
-	if (reverse)
-		permShellSort(&scores[0], &perm[0], scores.size(), std::greater<Score>(), true);
-	else
-		permShellSort(&scores[0], &perm[0], scores.size(), std::less<Score>(), true);
-	// perturbe sorting
-	if (isNotNull(rankNoise) && (nCalled > noiseAfter))
+	sortFractionals();
+	// perturbe sorting: swaps are over the whole order, so it must be built explicitly
+	noisy = (isNotNull(rankNoise) && (nCalled > noiseAfter));
+	if (noisy)
 	{
+		buildOrder();
 		int n = perm.size();
 		int nSwaps = int(rankNoise * n);
 		for (int i = 0; i < nSwaps; i++)
@@ -131,16 +221,89 @@ void FractionalityRanker::setCurrentState(const std::vector<double> &x)
 			std::swap(perm[fromIdx], perm[toIdx]);
 		}
 	}
+	segment = 0;
 	nextItr = 0;
 	nCalled++;
 }
 
+void FractionalityRanker::buildOrder()
+{
+	// same segments as next()
+	unsigned int nFrac = fracOrder.size();
+	perm.clear();
+	for (int seg = 0; seg < 4; seg++)
+	{
+		bool fractional = ((seg % 2) == (reverse ? 0 : 1));
+		bool binary = ((seg < 2) != reverse);
+		if (fractional)
+		{
+			unsigned int beg;
+			if (binary)
+				beg = reverse ? nFrac - fracBinaries : 0;
+			else
+				beg = reverse ? 0 : fracBinaries;
+			unsigned int size = binary ? fracBinaries : nFrac - fracBinaries;
+			perm.insert(perm.end(), fracOrder.begin() + beg, fracOrder.begin() + beg + size);
+		}
+		else
+		{
+			unsigned int lo = binary ? 0 : nBinaries;
+			unsigned int size = (binary ? nBinaries : integers.size()) - lo;
+			for (unsigned int k = 0; k < size; k++)
+			{
+				unsigned int i = reverse ? lo + size - 1 - k : lo + k;
+				if (fracPos[i] < 0)
+					perm.push_back(i);
+			}
+		}
+	}
+}
+
 int FractionalityRanker::next()
 {
-	while (nextItr < integers.size() && domain->isVarFixed(integers[perm[nextItr]]))
-		nextItr++;
-	if (nextItr < integers.size())
-		return integers[perm[nextItr]];
+	if (noisy)
+	{
+		while (nextItr < perm.size() && domain->isVarFixed(integers[perm[nextItr]]))
+			nextItr++;
+		if (nextItr < perm.size())
+			return integers[perm[nextItr]];
+		return -1;
+	}
+	// segments: integral binaries, fractional binaries, integral general integers, fractional
+	// general integers (all reversed if reverse)
+	unsigned int nFrac = fracOrder.size();
+	while (segment < 4)
+	{
+		bool fractional = ((segment % 2) == (reverse ? 0 : 1));
+		bool binary = ((segment < 2) != reverse);
+		if (fractional)
+		{
+			unsigned int beg;
+			if (binary)
+				beg = reverse ? nFrac - fracBinaries : 0;
+			else
+				beg = reverse ? 0 : fracBinaries;
+			unsigned int size = binary ? fracBinaries : nFrac - fracBinaries;
+			while (nextItr < size && domain->isVarFixed(integers[fracOrder[beg + nextItr]]))
+				nextItr++;
+			if (nextItr < size)
+				return integers[fracOrder[beg + nextItr]];
+		}
+		else
+		{
+			unsigned int lo = binary ? 0 : nBinaries;
+			unsigned int size = (binary ? nBinaries : integers.size()) - lo;
+			while (nextItr < size)
+			{
+				unsigned int i = reverse ? lo + size - 1 - nextItr : lo + nextItr;
+				if ((fracPos[i] < 0) && !domain->isVarFixed(integers[i]))
+					return integers[i];
+				nextItr++;
+			}
+		}
+		segment++;
+		nextItr = 0;
+	}
 	return -1;
 }
 
@@ -153,6 +316,19 @@ void RandomRanker::readConfig()
 	rnd.warmUp();
 }
 
+void RandomRanker::diversify(bool, uint64_t seed)
+{
+	// a different random order in any case
+	rnd.setSeed(seed);
+	rnd.warmUp();
+}
+
+void RandomRanker::reseed(uint64_t seed)
+{
+	rnd.setSeed(seed);
+	rnd.warmUp();
+}
+
 void RandomRanker::ignoreGeneralIntegers(bool flag)
 {
 	Ranker::ignoreGeneralIntegers(flag);
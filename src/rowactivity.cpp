@@ -0,0 +1,141 @@
+/**
+ * @file rowactivity.cpp
+ * @brief Incremental row activities and feasibility status of a point
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <limits>
+#include <algorithm>
+
+#include <utils/asserter.h>
+
+#include "kernelpump/rowactivity.h"
+
+using namespace dominiqs;
+
+// activities are recomputed from scratch every so often to avoid drifting
+static const int REFRESH_INTERVAL = 100;
+
+namespace dominiqs
+{
+
+	void RowActivity::init(ConstraintStorePtr rows, double _eps)
+	{
+		eps = _eps;
+		store = rows;
+		cols = &(store->columns());
+		int m = store->nrows();
+		const double inf = std::numeric_limits<double>::infinity();
+		lo.resize(m);
+		hi.resize(m);
+		for (int i = 0; i < m; i++)
+		{
+			RowView c = (*store)[i];
+			switch (c.sense)
+			{
+			case 'L':
+				lo[i] = -inf;
+				hi[i] = c.rhs;
+				break;
+			case 'G':
+				lo[i] = c.rhs;
+				hi[i] = inf;
+				break;
+			case 'R':
+				lo[i] = c.rhs - c.range;
+				hi[i] = c.rhs;
+				break;
+			default:
+				// same as Constraint::violation
+				lo[i] = c.rhs;
+				hi[i] = c.rhs;
+			}
+		}
+		set(std::vector<double>(store->ncols(), 0.0));
+	}
+
+	void RowActivity::set(const std::vector<double> &_x)
+	{
+		int n = store->ncols();
+		DOMINIQS_ASSERT((int)_x.size() >= n);
+		x.assign(_x.begin(), _x.begin() + n);
+		refresh();
+	}
+
+	void RowActivity::refresh()
+	{
+		int n = x.size();
+		int m = lo.size();
+		act.assign(m, 0.0);
+		for (int j = 0; j < n; j++)
+		{
+			if (x[j] == 0.0)
+				continue;
+			for (int k = cols->start[j]; k < cols->start[j + 1]; k++)
+				act[cols->rowIdx[k]] += cols->coef[k] * x[j];
+		}
+		violated.clear();
+		violatedPos.assign(m, -1);
+		for (int i = 0; i < m; i++)
+			updateStatus(i);
+		updatesSinceRefresh = 0;
+	}
+
+	void RowActivity::update(const std::vector<double> &_x, const std::vector<int> &changed)
+	{
+		DOMINIQS_ASSERT((int)_x.size() >= store->ncols());
+		for (int j : changed)
+		{
+			if (_x[j] != x[j])
+				update(j, _x[j]);
+		}
+		if (++updatesSinceRefresh >= REFRESH_INTERVAL)
+			refresh();
+	}
+
+	void RowActivity::update(int j, double value)
+	{
+		double delta = value - x[j];
+		if (delta == 0.0)
+			return;
+		x[j] = value;
+		for (int k = cols->start[j]; k < cols->start[j + 1]; k++)
+		{
+			int i = cols->rowIdx[k];
+			act[i] += cols->coef[k] * delta;
+			updateStatus(i);
+		}
+	}
+
+	double RowActivity::maxViolation() const
+	{
+		double maxViol = 0.0;
+		for (int i : violated)
+			maxViol = std::max(maxViol, violation(i));
+		return maxViol;
+	}
+
+	void RowActivity::updateStatus(int i)
+	{
+		bool isViolated = isPositive(violation(i), eps);
+		if (isViolated && (violatedPos[i] < 0))
+		{
+			violatedPos[i] = violated.size();
+			violated.push_back(i);
+		}
+		else if (!isViolated && (violatedPos[i] >= 0))
+		{
+			// swap with last and pop
+			int pos = violatedPos[i];
+			int last = violated.back();
+			violated[pos] = last;
+			violatedPos[last] = pos;
+			violated.pop_back();
+			violatedPos[i] = -1;
+		}
+	}
+
+} // namespace dominiqs
@@ -72,6 +72,7 @@ SCIPModel::~SCIPModel()
 /* Read/Write */
 void SCIPModel::readModel(const std::string &filename)
 {
+	matrixChanged();
 	// Done
 	// read problem from file
 	DOMINIQS_ASSERT(scip);
@@ -272,6 +273,40 @@ bool SCIPModel::isPrimalFeas() const
 	}
 }
 
+bool SCIPModel::getBasis(LPBasis &basis) const
+{
+	// the basis is available only in the LP stage
+	if (!stageLP)
+		return false;
+	DOMINIQS_ASSERT(lpi);
+	if (!SCIPlpiWasSolved(lpi) || !SCIPlpiIsOptimal(lpi))
+		return false;
+	int n = ncols();
+	int m = nrows();
+	std::vector<int> cstat(n);
+	std::vector<int> rstat(m);
+	if (SCIPlpiGetBase(lpi, n ? &cstat[0] : NULL, m ? &rstat[0] : NULL) != SCIP_OKAY)
+		return false;
+	// SCIP_BASESTAT_LOWER, SCIP_BASESTAT_BASIC, SCIP_BASESTAT_UPPER and SCIP_BASESTAT_ZERO are the neutral codes
+	basis.cols.assign(cstat.begin(), cstat.end());
+	basis.rows.assign(rstat.begin(), rstat.end());
+	return true;
+}
+
+bool SCIPModel::setBasis(const LPBasis &basis)
+{
+	if (!stageLP)
+		return false;
+	DOMINIQS_ASSERT(lpi);
+	int n = ncols();
+	int m = nrows();
+	if (((int)basis.cols.size() != n) || ((int)basis.rows.size() != m))
+		return false;
+	std::vector<int> cstat(basis.cols.begin(), basis.cols.end());
+	std::vector<int> rstat(basis.rows.begin(), basis.rows.end());
+	return (SCIPlpiSetBase(lpi, n ? &cstat[0] : NULL, m ? &rstat[0] : NULL) == SCIP_OKAY);
+}
+
 /* Parameters */
 void SCIPModel::handleCtrlC(bool flag)
 {
@@ -324,6 +359,10 @@ int SCIPModel::intParam(IntParam which) const
 		case IntParam::IterLimit:
 			SCIPlpiGetIntpar(lpi, SCIP_LPPAR_LPITLIM, &value);
 			break;
+		case IntParam::DualReductions:
+			// no presolve at the LP stage
+			value = 1;
+			break;
 		default:
 			throw std::runtime_error("Unknown integer parameter");
 		}
@@ -346,6 +385,13 @@ int SCIPModel::intParam(IntParam which) const
 		case IntParam::IterLimit:
 			// not needed atm
 			break;
+		case IntParam::DualReductions:
+		{
+			SCIP_Bool allow = TRUE;
+			SCIPgetBoolParam(scip, "misc/allowstrongdualreds", &allow);
+			value = allow ? 1 : 0;
+			break;
+		}
 		default:
 			throw std::runtime_error("Unknown integer parameter");
 		}
@@ -371,6 +417,8 @@ void SCIPModel::intParam(IntParam which, int value)
 		case IntParam::IterLimit:
 			SCIPlpiSetIntpar(lpi, SCIP_LPPAR_LPITLIM, value);
 			break;
+		case IntParam::DualReductions:
+			break;
 		case IntParam::PdlpWarmStart:
 			break;
 		default:
@@ -395,6 +443,10 @@ void SCIPModel::intParam(IntParam which, int value)
 		case IntParam::IterLimit:
 			// not needed atm
 			break;
+		case IntParam::DualReductions:
+			SCIPsetBoolParam(scip, "misc/allowstrongdualreds", value ? TRUE : FALSE);
+			SCIPsetBoolParam(scip, "misc/allowweakdualreds", value ? TRUE : FALSE);
+			break;
 		default:
 			throw std::runtime_error("Unknown integer parameter");
 		}
@@ -977,6 +1029,7 @@ void SCIPModel::rowNames(std::vector<std::string> &names, int first, int last) c
 /* Data modifications */
 void SCIPModel::addEmptyCol(const std::string &name, char ctype, double lb, double ub, double obj)
 {
+	matrixChanged();
 	// Done
 	DOMINIQS_ASSERT(scip);
 	DOMINIQS_ASSERT(lpi);
@@ -1000,11 +1053,13 @@ void SCIPModel::addEmptyCol(const std::string &name, char ctype, double lb, doub
 
 void SCIPModel::addCol(const std::string &name, const int *idx, const double *val, int cnt, char ctype, double lb, double ub, double obj)
 {
+	matrixChanged();
 	// later...
 }
 
 void SCIPModel::addRow(const std::string &name, const int *idx, const double *val, int cnt, char sense, double rhs, double rngval)
 {
+	matrixChanged();
 
 	// Done
 	if (stageLP)
@@ -1090,6 +1145,7 @@ void SCIPModel::addRow(const std::string &name, const int *idx, const double *va
 
 void SCIPModel::delRow(int ridx)
 {
+	matrixChanged();
 	// later
 	DOMINIQS_ASSERT(lpi);
 	SCIPlpiDelRows(lpi, ridx, ridx);
@@ -1097,6 +1153,7 @@ void SCIPModel::delRow(int ridx)
 
 void SCIPModel::delCol(int cidx)
 {
+	matrixChanged();
 	// later
 	DOMINIQS_ASSERT(lpi);
 	SCIPlpiDelCols(lpi, cidx, cidx);
@@ -1104,6 +1161,7 @@ void SCIPModel::delCol(int cidx)
 
 void SCIPModel::delRows(int first, int last)
 {
+	matrixChanged();
 	// Done (not for stage 3...)
 	if (stageLP)
 	{
@@ -1126,6 +1184,7 @@ void SCIPModel::delRows(int first, int last)
 
 void SCIPModel::delCols(int first, int last)
 {
+	matrixChanged();
 	// Done (not possible for stage 3...)
 	if (stageLP)
 	{
@@ -1195,6 +1254,33 @@ void SCIPModel::ubs(int cnt, const int *cols, const double *values)
 	// later
 }
 
+void SCIPModel::rhs(int cnt, const int *rows, const double *values)
+{
+	matrixChanged();
+	// Done (only for the LP)
+	if (stageLP)
+	{
+		DOMINIQS_ASSERT(lpi);
+		for (int i = 0; i < cnt; i++)
+		{
+			double lhsval;
+			double rhsval;
+			SCIPlpiGetSides(lpi, rows[i], rows[i], &lhsval, &rhsval);
+			if (SCIPlpiIsInfinity(lpi, -lhsval))
+				rhsval = values[i];
+			else if (SCIPlpiIsInfinity(lpi, rhsval))
+				lhsval = values[i];
+			else
+			{
+				// equality or ranged row: shift both sides
+				lhsval = values[i] - (rhsval - lhsval);
+				rhsval = values[i];
+			}
+			SCIPlpiChgSides(lpi, 1, &rows[i], &lhsval, &rhsval);
+		}
+	}
+}
+
 void SCIPModel::fixCol(int cidx, double val)
 {
 	// later
@@ -1209,7 +1295,7 @@ void SCIPModel::objcoefs(int cnt, const int *cols, const double *values)
 {
 	// set new objective
 	if (stageLP)
-		SCIPlpiChgObj(lpi, ncols(), cols, values);
+		SCIPlpiChgObj(lpi, cnt, cols, values);
 	else
 	{
 		if (!postsolved)
@@ -1220,7 +1306,7 @@ void SCIPModel::objcoefs(int cnt, const int *cols, const double *values)
 			// set objective values for the variables
 			for (int idx = 0; idx < cnt; idx++)
 			{
-				SCIPchgVarObj(scip, vars[idx], values[idx]);
+				SCIPchgVarObj(scip, vars[cols[idx]], values[idx]);
 			}
 		}
 	}
@@ -0,0 +1,293 @@
+/**
+ * @file snapshot.cpp
+ * @brief Binary model snapshots (.kpbin)
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <functional>
+
+#include <unistd.h>
+
+#include <utils/consolelog.h>
+#include <fmt/format.h>
+
+#include "kernelpump/snapshot.h"
+
+using namespace dominiqs;
+
+namespace
+{
+
+	const char SNAPSHOT_MAGIC[8] = {'K', 'P', 'B', 'I', 'N', 0, 0, 0};
+	const uint32_t ENDIAN_CHECK = 0x01020304;
+
+	struct SnapshotHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t endian;
+		uint64_t sourceHash;
+		uint64_t fileSize; //< total size of the snapshot (detects truncated files)
+		int32_t objSense;
+		int32_t nrows;
+		int32_t ncols;
+		int32_t unused;
+		int64_t nnz;
+		double objOffset;
+	};
+
+	inline std::size_t align8(std::size_t bytes) { return (bytes + 7) & ~std::size_t(7); }
+
+	/** each array is written as its size in bytes followed by the (8-byte padded) data */
+	class SnapshotWriter
+	{
+	public:
+		SnapshotWriter(std::ofstream &_out) : out(_out) {}
+		template <class T>
+		void write(const T *ptr, std::size_t n)
+		{
+			uint64_t bytes = n * sizeof(T);
+			out.write((const char *)&bytes, sizeof(bytes));
+			if (bytes)
+				out.write((const char *)ptr, bytes);
+			static const char zeros[8] = {0};
+			out.write(zeros, align8(bytes) - bytes);
+		}
+		template <class T>
+		void write(const std::vector<T> &v) { write(v.data(), v.size()); }
+		void write(const std::string &s) { write(s.data(), s.size()); }
+
+	private:
+		std::ofstream &out;
+	};
+
+	class SnapshotReader
+	{
+	public:
+		SnapshotReader(const char *_p, const char *_end) : p(_p), end(_end) {}
+		/** raw view of the next array (in bytes) */
+		bool next(const char *&data, uint64_t &bytes)
+		{
+			if (end - p < (std::ptrdiff_t)sizeof(bytes))
+				return false;
+			std::memcpy(&bytes, p, sizeof(bytes));
+			p += sizeof(bytes);
+			if (bytes > (uint64_t)(end - p))
+				return false;
+			data = p;
+			p += std::min<std::size_t>(align8(bytes), end - p);
+			return true;
+		}
+		template <class T>
+		bool read(std::vector<T> &v, std::size_t expected)
+		{
+			const char *data;
+			uint64_t bytes;
+			if (!next(data, bytes) || (bytes != expected * sizeof(T)))
+				return false;
+			v.resize(expected);
+			if (bytes)
+				std::memcpy(v.data(), data, bytes);
+			return true;
+		}
+		bool read(std::string &s)
+		{
+			const char *data;
+			uint64_t bytes;
+			if (!next(data, bytes))
+				return false;
+			s.assign(data, bytes);
+			return true;
+		}
+		bool read(NameTable &names, int n)
+		{
+			const char *chars;
+			uint64_t charBytes;
+			const char *offsets;
+			uint64_t offsetBytes;
+			if (!next(chars, charBytes) || !next(offsets, offsetBytes) || (offsetBytes != (n + 1) * sizeof(std::size_t)))
+				return false;
+			std::vector<std::size_t> start(n + 1);
+			std::memcpy(start.data(), offsets, offsetBytes);
+			if ((start[0] != 0) || (start[n] != charBytes))
+				return false;
+			// every name is zero terminated
+			for (int i = 0; i < n; i++)
+				if ((start[i + 1] <= start[i]) || chars[start[i + 1] - 1])
+					return false;
+			names.assign(std::string_view(chars, charBytes), start.data(), n);
+			return true;
+		}
+
+	private:
+		const char *p;
+		const char *end;
+	};
+
+	/** beg must be a monotone partition of [0, nnz) and idx must be within [0, dim) */
+	bool validIndices(const std::vector<int> &beg, const std::vector<int> &idx, int dim)
+	{
+		if (beg.empty() || (beg.front() != 0) || ((std::size_t)beg.back() != idx.size()))
+			return false;
+		for (std::size_t k = 1; k < beg.size(); k++)
+			if (beg[k] < beg[k - 1])
+				return false;
+		return std::all_of(idx.begin(), idx.end(), [dim](int i) { return (i >= 0) && (i < dim); });
+	}
+
+	bool loadSnapshot(const FileBuffer &buf, ModelData &data, uint64_t sourceHash)
+	{
+		SnapshotHeader header;
+		if (buf.size() < sizeof(header))
+			return false;
+		std::memcpy(&header, buf.begin(), sizeof(header));
+		if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) || (header.version != SNAPSHOT_VERSION) ||
+			(header.endian != ENDIAN_CHECK) || (header.sourceHash != sourceHash) || (header.fileSize != buf.size()))
+			return false;
+		if ((header.nrows < 0) || (header.ncols < 0) || (header.nnz < 0))
+			return false;
+		int m = header.nrows;
+		int n = header.ncols;
+		std::size_t nnz = header.nnz;
+		data.objSense = header.objSense;
+		data.objOffset = header.objOffset;
+		SnapshotReader in(buf.begin() + sizeof(header), buf.end());
+		bool ok = in.read(data.name) && in.read(data.objName) &&
+				  in.read(data.colNames, n) && in.read(data.obj, n) && in.read(data.lb, n) && in.read(data.ub, n) && in.read(data.ctype, n) &&
+				  in.read(data.rowNames, m) && in.read(data.sense, m) && in.read(data.rhs, m) && in.read(data.range, m) &&
+				  in.read(data.rowBeg, m + 1) && in.read(data.rowIdx, nnz) && in.read(data.rowVal, nnz) &&
+				  in.read(data.colBeg, n + 1) && in.read(data.colIdx, nnz) && in.read(data.colVal, nnz);
+		// a corrupt snapshot must not index out of bounds later on
+		return ok && validIndices(data.rowBeg, data.rowIdx, n) && validIndices(data.colBeg, data.colIdx, m);
+	}
+
+} // namespace
+
+namespace dominiqs
+{
+
+	uint64_t fileContentHash(const std::string &filename)
+	{
+		FileBuffer buf(filename, false);
+		// FNV-1a on 8-byte words, with a final avalanche
+		const uint64_t PRIME = 0x100000001b3ULL;
+		uint64_t h = 0xcbf29ce484222325ULL ^ buf.size();
+		const char *p = buf.begin();
+		const char *end = buf.end();
+		for (; end - p >= 8; p += 8)
+		{
+			uint64_t w;
+			std::memcpy(&w, p, 8);
+			h = (h ^ w) * PRIME;
+		}
+		for (; p < end; p++)
+			h = (h ^ (unsigned char)*p) * PRIME;
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		return h;
+	}
+
+	void writeSnapshot(const std::string &filename, const ModelData &data, uint64_t sourceHash)
+	{
+		// write to a temporary file (one per process and thread) and rename it: concurrent runs never see partial snapshots
+		std::string tmpName = fmt::format("{}.tmp{}.{}", filename, getpid(), std::hash<std::thread::id>()(std::this_thread::get_id()));
+		{
+			std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+			if (!out)
+				throw std::runtime_error(fmt::format("cannot create {}", tmpName));
+			SnapshotHeader header;
+			std::memset(&header, 0, sizeof(header));
+			std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+			header.version = SNAPSHOT_VERSION;
+			header.endian = ENDIAN_CHECK;
+			header.sourceHash = sourceHash;
+			header.objSense = data.objSense;
+			header.nrows = data.nrows();
+			header.ncols = data.ncols();
+			header.nnz = data.nnz();
+			header.objOffset = data.objOffset;
+			out.write((const char *)&header, sizeof(header));
+			SnapshotWriter w(out);
+			w.write(data.name);
+			w.write(data.objName);
+			w.write(data.colNames.chars());
+			w.write(data.colNames.offsets());
+			w.write(data.obj);
+			w.write(data.lb);
+			w.write(data.ub);
+			w.write(data.ctype);
+			w.write(data.rowNames.chars());
+			w.write(data.rowNames.offsets());
+			w.write(data.sense);
+			w.write(data.rhs);
+			w.write(data.range);
+			w.write(data.rowBeg);
+			w.write(data.rowIdx);
+			w.write(data.rowVal);
+			w.write(data.colBeg);
+			w.write(data.colIdx);
+			w.write(data.colVal);
+			header.fileSize = out.tellp();
+			out.seekp(0);
+			out.write((const char *)&header, sizeof(header));
+			if (!out)
+			{
+				out.close();
+				std::remove(tmpName.c_str());
+				throw std::runtime_error(fmt::format("cannot write {}", tmpName));
+			}
+		}
+		if (std::rename(tmpName.c_str(), filename.c_str()))
+		{
+			std::remove(tmpName.c_str());
+			throw std::runtime_error(fmt::format("cannot rename {} to {}", tmpName, filename));
+		}
+	}
+
+	bool readSnapshot(const std::string &filename, ModelData &data, uint64_t sourceHash)
+	{
+		data = ModelData();
+		if (access(filename.c_str(), R_OK))
+			return false;
+		FileBuffer buf(filename, false);
+		if (!loadSnapshot(buf, data, sourceHash))
+		{
+			data = ModelData();
+			return false;
+		}
+		return true;
+	}
+
+	bool readModelCached(const std::string &filename, const std::string &snapshotFile, ModelData &data, int threads)
+	{
+		uint64_t hash = fileContentHash(filename);
+		if (readSnapshot(snapshotFile, data, hash))
+		{
+			consoleLog("loaded model snapshot {}", snapshotFile);
+			return true;
+		}
+		readModelFile(filename, data, threads);
+		try
+		{
+			writeSnapshot(snapshotFile, data, hash);
+			consoleLog("written model snapshot {}", snapshotFile);
+		}
+		catch (const std::exception &e)
+		{
+			// not being able to cache the model is not an error
+			consoleWarn("model snapshot not written: {}", e.what());
+		}
+		return false;
+	}
+
+} // namespace dominiqs
@@ -14,6 +14,8 @@
 #include <numeric>
 #include <iostream>
 #include <algorithm>
+#include <future>
+#include <thread>
 
 #include <utils/floats.h>
 #include <utils/fileconfig.h>
@@ -45,6 +47,12 @@ void SimpleRounding::readConfig()
 	roundGen.warmUp();
 }
 
+void SimpleRounding::reseed(uint64_t seed)
+{
+	roundGen.setSeed(seed);
+	roundGen.warmUp();
+}
+
 void SimpleRounding::init(MIPModelPtr model, bool ignoreGeneralInt)
 {
 	consoleInfo("[init propagator]");
@@ -87,13 +95,17 @@ void SimpleRounding::ignoreGeneralIntegers(bool flag)
 
 void SimpleRounding::apply(const std::vector<double> &in, std::vector<double> &out)
 {
-	copy(in.begin(), in.end(), out.begin());
+	changed.clear();
+	for (unsigned int j = 0; j < in.size(); j++)
+		setTracked(out, j, in[j], changed);
 	int rDn = 0;
 	int rUp = 0;
 	double t = getRoundingThreshold(randomizedRounding, roundGen);
 	for (int j : integers)
 	{
-		doRound(in[j], out[j], t);
+		double value;
+		doRound(in[j], value, t);
+		setTracked(out, j, value, changed);
 		if (lessThan(out[j], in[j]))
 			rDn++;
 		if (greaterThan(out[j], in[j]))
@@ -102,16 +114,20 @@ void SimpleRounding::apply(const std::vector<double> &in, std::vector<double> &o
 	consoleDebug(DebugLevel::VeryVerbose, "rounding: thr={} #down={} #up={}", t, rDn, rUp);
 }
 
-PropagatorRounding::PropagatorRounding() {}
+static const int DEF_MAX_BACKTRACKS = 0;
+
+PropagatorRounding::PropagatorRounding() : filterConstraints(true), maxBacktracks(DEF_MAX_BACKTRACKS) {}
 
 void PropagatorRounding::readConfig()
 {
 	SimpleRounding::readConfig();
 	std::string rankerName = gConfig().get("fp.ranker", std::string("FRAC"));
 	filterConstraints = gConfig().get("fp.filterConstraints", true);
+	maxBacktracks = gConfig().get("fp.maxBacktracks", DEF_MAX_BACKTRACKS);
 	consoleInfo("[config rounder]");
 	LOG_ITEM("fp.ranker", rankerName);
 	LOG_ITEM("fp.filterConstraints", filterConstraints);
+	LOG_ITEM("fp.maxBacktracks", maxBacktracks);
 	ranker = RankerPtr(RankerFactory::getInstance().create(rankerName));
 	ranker->readConfig();
 }
@@ -146,21 +162,22 @@ void PropagatorRounding::init(MIPModelPtr model, bool ignoreGeneralInt)
 
 	auto rows = model->rows();
 	int filteredOut = 0;
-	for (int i = 0; i < model->nrows(); i++)
+	Constraint c; //< scratch constraint handed to the analyzers (they copy what they need)
+	for (int i = 0; i < rows->nrows(); i++)
 	{
 		// consoleLog("row {}/{}",i,model->nrows());
 		std::map<int, PropagatorFactoryPtr>::iterator itr = factories.begin();
 		std::map<int, PropagatorFactoryPtr>::iterator end = factories.end();
-		ConstraintPtr &c = (*rows)[i];
+		RowView view = (*rows)[i];
 		// ignore nonbinding constraints
-		if (c->sense == 'N')
+		if (view.sense == 'N')
 			continue;
 		// constraint filter
 		if (filterConstraints)
 		{
-			const int *idx = c->row.idx();
-			const double *coef = c->row.coef();
-			unsigned int size = c->row.size();
+			const int *idx = view.idx;
+			const double *coef = view.coef;
+			unsigned int size = view.size();
 			bool allCont = true;
 			double largest = std::numeric_limits<double>::min();
 			double smallest = std::numeric_limits<double>::max();
@@ -183,9 +200,10 @@ void PropagatorRounding::init(MIPModelPtr model, bool ignoreGeneralInt)
 			}
 		}
 		// try analyzers
+		view.toConstraint(c);
 		while (itr != end)
 		{
-			PropagatorPtr p = itr->second->analyze(*(domain.get()), c.get());
+			PropagatorPtr p = itr->second->analyze(*(domain.get()), &c);
 			if (p)
 			{
 				prop.pushPropagator(p);
@@ -206,6 +224,27 @@ void PropagatorRounding::init(MIPModelPtr model, bool ignoreGeneralInt)
 	// prop.propagate();
 	state = prop.getStateMgr();
 	state->dump();
+	prop.dumpBase();
+}
+
+bool PropagatorRounding::updateBounds(MIPModelPtr model, bool ignoreGeneralInt)
+{
+	int ncols = model->ncols();
+	if (!domain || !state || ((int)domain->size() != ncols))
+		return false;
+	std::vector<double> xLb(ncols);
+	std::vector<double> xUb(ncols);
+	model->lbs(&xLb[0]);
+	model->ubs(&xUb[0]);
+	// back to the current root, and from there to the new one
+	state->restore();
+	if (!prop.rebase(xLb, xUb))
+		return false;
+	state->dump();
+	SimpleRounding::init(model, ignoreGeneralInt);
+	ranker->init(domain, ignoreGeneralInt);
+	consoleLog("rebased propagators on new bounds");
+	return true;
 }
 
 void PropagatorRounding::ignoreGeneralIntegers(bool flag)
@@ -216,12 +255,15 @@ void PropagatorRounding::ignoreGeneralIntegers(bool flag)
 
 void PropagatorRounding::apply(const std::vector<double> &in, std::vector<double> &out)
 {
-	copy(in.begin(), in.end(), out.begin());
+	changed.clear();
+	for (unsigned int j = 0; j < in.size(); j++)
+		setTracked(out, j, in[j], changed);
 	state->restore();
 	double t = getRoundingThreshold(randomizedRounding, roundGen);
 	ranker->setCurrentState(in);
 	// main loop
 	int next;
+	int backtracks = 0;
 	while ((next = ranker->next()) >= 0)
 	{
 		// int countBefore = 0;
@@ -232,6 +274,7 @@ void PropagatorRounding::apply(const std::vector<double> &in, std::vector<double
 		// }
 
 		// standard rounding
+		double before = out[next];
 		if (domain->varType(next) == 'B')
 			doRound(in[next], out[next], t);
 		else
@@ -246,11 +289,39 @@ void PropagatorRounding::apply(const std::vector<double> &in, std::vector<double
 				doRound(in[next], out[next], t);
 		}
 		// propagate
+		bool canRepair = (backtracks < maxBacktracks) && !prop.failed();
+		if (canRepair)
+			prop.mark();
 		prop.propagate(next, out[next]);
+		if (canRepair && prop.failed())
+		{
+			// limited discrepancy: take the decision back and try the other rounding direction
+			backtracks++;
+			prop.undoToMark();
+			double value = out[next];
+			double other = greaterEqualThan(value, in[next]) ? value - 1.0 : value + 1.0;
+			if (lessThan(other, domain->varLb(next)) || greaterThan(other, domain->varUb(next)))
+				other = 2.0 * value - other;
+			bool repaired = false;
+			if (greaterEqualThan(other, domain->varLb(next)) && lessEqualThan(other, domain->varUb(next)))
+			{
+				prop.propagate(next, other);
+				repaired = !prop.failed();
+				if (repaired)
+					out[next] = other;
+				else
+					prop.undoToMark();
+			}
+			// both directions fail: keep the original rounding and finish greedily
+			if (!repaired)
+				prop.propagate(next, value);
+		}
 		DOMINIQS_ASSERT(domain->isVarFixed(next));
+		if (out[next] != before)
+			changed.push_back(next);
 		// update with fixings
 		for (int j : prop.getLastFixed())
-			out[j] = domain->varLb(j);
+			setTracked(out, j, domain->varLb(j), changed);
 
 		// int countAfter = 0;
 		// for (int j = 0; j < domain->size(); ++j)
@@ -275,6 +346,149 @@ void PropagatorRounding::clear()
 	factories.clear();
 }
 
+void PropagatorRounding::diversify(int variant, uint64_t seed)
+{
+	if (variant <= 0)
+		return;
+	// every variant draws its own thresholds (if random)
+	roundGen.setSeed(seed + variant);
+	roundGen.warmUp();
+	if ((variant % 3) == 1)
+	{
+		// a different kind of ranker: random order (fractionality order if the base one is already random)
+		bool isRandom = (dynamic_cast<RandomRanker*>(ranker.get()) != nullptr);
+		ranker = RankerPtr(RankerFactory::getInstance().create(isRandom ? "FRAC" : "RND"));
+		ranker->readConfig();
+		if (!isRandom)
+			ranker->diversify(false, seed + variant);
+	}
+	else
+		ranker->diversify((variant % 3) == 0, seed + variant);
+}
+
+void PropagatorRounding::reseed(uint64_t seed)
+{
+	SimpleRounding::reseed(seed);
+	if (ranker)
+		ranker->reseed(seed);
+}
+
+static const int DEF_BATCH_CANDIDATES = 4;
+static const int DEF_BATCH_THREADS = 0;
+
+BatchRounding::BatchRounding() : numCandidates(DEF_BATCH_CANDIDATES), numThreads(DEF_BATCH_THREADS) {}
+
+void BatchRounding::readConfig()
+{
+	numCandidates = std::max(gConfig().get("fp.batchCandidates", DEF_BATCH_CANDIDATES), 1);
+	numThreads = gConfig().get("fp.batchThreads", DEF_BATCH_THREADS);
+	consoleInfo("[config batch rounder]");
+	LOG_ITEM("fp.batchCandidates", numCandidates);
+	LOG_ITEM("fp.batchThreads", numThreads);
+	uint64_t seed = gConfig().get<uint64_t>("seed", DEF_SEED);
+	candidates.clear();
+	for (int k = 0; k < numCandidates; k++)
+	{
+		candidates.push_back(std::make_unique<Candidate>());
+		candidates.back()->rounder.readConfig();
+		candidates.back()->rounder.diversify(k, seed);
+	}
+}
+
+void BatchRounding::reseed(uint64_t seed)
+{
+	for (int k = 0; k < (int)candidates.size(); k++)
+		candidates[k]->rounder.reseed(seed + k);
+}
+
+void BatchRounding::init(MIPModelPtr model, bool ignoreGeneralInt)
+{
+	for (auto &c : candidates)
+	{
+		c->rounder.init(model, ignoreGeneralInt);
+		c->activity.init(model->rows());
+		c->x.assign(model->ncols(), 0.0);
+	}
+}
+
+bool BatchRounding::updateBounds(MIPModelPtr model, bool ignoreGeneralInt)
+{
+	for (auto &c : candidates)
+	{
+		if (!c->rounder.updateBounds(model, ignoreGeneralInt))
+			return false;
+	}
+	return true;
+}
+
+void BatchRounding::ignoreGeneralIntegers(bool flag)
+{
+	for (auto &c : candidates)
+		c->rounder.ignoreGeneralIntegers(flag);
+}
+
+void BatchRounding::round(int k, const std::vector<double> &in)
+{
+	Candidate &c = *candidates[k];
+	c.x.resize(in.size());
+	c.rounder.apply(in, c.x);
+	// the activities follow c.x, so only the columns the rounder changed need a look
+	c.activity.update(c.x, *c.rounder.changedColumns());
+}
+
+void BatchRounding::apply(const std::vector<double> &in, std::vector<double> &out)
+{
+	DOMINIQS_ASSERT(!candidates.empty());
+	int threads = numThreads;
+	if (threads <= 0)
+		threads = std::max((int)std::thread::hardware_concurrency(), 1);
+	threads = std::min(threads, numCandidates);
+	// thread t rounds the candidates t, t + threads, ... (the calling thread is thread 0)
+	std::vector<std::future<void>> running;
+	for (int t = 1; t < threads; t++)
+	{
+		running.push_back(std::async(std::launch::async, [this, t, threads, &in]()
+									 {
+										 for (int k = t; k < numCandidates; k += threads)
+											 round(k, in); }));
+	}
+	for (int k = 0; k < numCandidates; k += threads)
+		round(k, in);
+	for (auto &f : running)
+		f.get();
+	// pick the best candidate
+	int best = -1;
+	int bestViolated = 0;
+	double bestDist = 0.0;
+	for (int k = 0; k < numCandidates; k++)
+	{
+		const Candidate &c = *candidates[k];
+		int violated = c.activity.numViolated();
+		if ((best >= 0) && (violated > bestViolated))
+			continue;
+		double dist = 0.0;
+		for (unsigned int j = 0; j < in.size(); j++)
+			dist += fabs(c.x[j] - in[j]);
+		if ((best < 0) || (violated < bestViolated) || lessThan(dist, bestDist))
+		{
+			best = k;
+			bestViolated = violated;
+			bestDist = dist;
+		}
+	}
+	consoleDebug(DebugLevel::VeryVerbose, "batch rounding: best candidate={} #violated={} dist={}", best, bestViolated, bestDist);
+	const std::vector<double> &x = candidates[best]->x;
+	changed.clear();
+	for (unsigned int j = 0; j < x.size(); j++)
+		setTracked(out, j, x[j], changed);
+}
+
+void BatchRounding::clear()
+{
+	for (auto &c : candidates)
+		c->rounder.clear();
+}
+
 // auto registration
 // please register your class here with an appropriate name
 
@@ -288,6 +502,7 @@ public:
 #endif //< SILENT_EXEC
 		TransformersFactory::getInstance().registerClass<SimpleRounding>("std");
 		TransformersFactory::getInstance().registerClass<PropagatorRounding>("propround");
+		TransformersFactory::getInstance().registerClass<BatchRounding>("batchround");
 #ifndef SILENT_EXEC
 		std::cout << "done" << std::endl;
 #endif //< SILENT_EXEC
@@ -0,0 +1,45 @@
+/**
+ * @file vargraph.cpp
+ * @brief Sparse variable interaction (co-occurrence) graph
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <algorithm>
+
+#include <utils/asserter.h>
+
+#include "kernelpump/vargraph.h"
+
+using namespace dominiqs;
+
+namespace dominiqs
+{
+
+	VariableGraph::VariableGraph(ConstraintStorePtr rows, int maxRowLength) : store(rows), maxLen(maxRowLength)
+	{
+		DOMINIQS_ASSERT(store);
+		cols = &(store->columns());
+	}
+
+	void VariableGraph::neighbors(int j, std::vector<int> &out) const
+	{
+		DOMINIQS_ASSERT((j >= 0) && (j < size()));
+		out.clear();
+		for (int k = cols->start[j]; k < cols->start[j + 1]; k++)
+		{
+			RowView row = (*store)[cols->rowIdx[k]];
+			if ((maxLen > 0) && (row.size() > maxLen))
+				continue;
+			out.insert(out.end(), row.idx, row.idx + row.size());
+		}
+		std::sort(out.begin(), out.end());
+		out.erase(std::unique(out.begin(), out.end()), out.end());
+		auto itr = std::lower_bound(out.begin(), out.end(), j);
+		if ((itr != out.end()) && (*itr == j))
+			out.erase(itr);
+	}
+
+} // namespace dominiqs
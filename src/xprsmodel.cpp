@@ -89,6 +89,7 @@ XPRSModel::~XPRSModel()
 void XPRSModel::readModel(const std::string &filename)
 {
 	DOMINIQS_ASSERT(prob);
+	matrixChanged();
 	XPRS_CALL(XPRSreadprob, prob, filename.c_str(), "");
 }
 
@@ -274,6 +275,37 @@ bool XPRSModel::isPrimalFeas() const
 	return 1;
 }
 
+bool XPRSModel::getBasis(LPBasis &basis) const
+{
+	DOMINIQS_ASSERT(prob);
+	int lpstat = 0;
+	XPRS_CALL(XPRSgetintattrib, prob, XPRS_LPSTATUS, &lpstat);
+	if (lpstat != XPRS_LP_OPTIMAL)
+		return false;
+	int n = ncols();
+	int m = nrows();
+	std::vector<int> cstat(n);
+	std::vector<int> rstat(m);
+	XPRS_CALL(XPRSgetbasis, prob, m ? &rstat[0] : nullptr, n ? &cstat[0] : nullptr);
+	// nonbasic at lower (0), basic (1), nonbasic at upper (2) and superbasic (3) are the neutral codes
+	basis.cols.assign(cstat.begin(), cstat.end());
+	basis.rows.assign(rstat.begin(), rstat.end());
+	return true;
+}
+
+bool XPRSModel::setBasis(const LPBasis &basis)
+{
+	DOMINIQS_ASSERT(prob);
+	int n = ncols();
+	int m = nrows();
+	if (((int)basis.cols.size() != n) || ((int)basis.rows.size() != m))
+		return false;
+	std::vector<int> cstat(basis.cols.begin(), basis.cols.end());
+	std::vector<int> rstat(basis.rows.begin(), basis.rows.end());
+	XPRS_CALL(XPRSloadbasis, prob, m ? &rstat[0] : nullptr, n ? &cstat[0] : nullptr);
+	return true;
+}
+
 /* Parameters */
 void XPRSModel::handleCtrlC(bool flag)
 {
@@ -335,6 +367,9 @@ int XPRSModel::intParam(IntParam which) const
 	case IntParam::IterLimit:
 		XPRS_CALL(XPRSgetintcontrol, prob, XPRS_LPITERLIMIT, &value);
 		break;
+	case IntParam::DualReductions:
+		XPRS_CALL(XPRSgetintcontrol, prob, XPRS_MIPDUALREDUCTIONS, &value);
+		break;
 	default:
 		throw std::runtime_error("Unknown integer parameter");
 	}
@@ -360,6 +395,9 @@ void XPRSModel::intParam(IntParam which, int value)
 	case IntParam::IterLimit:
 		XPRS_CALL(XPRSsetintcontrol, prob, XPRS_LPITERLIMIT, value);
 		break;
+	case IntParam::DualReductions:
+		XPRS_CALL(XPRSsetintcontrol, prob, XPRS_MIPDUALREDUCTIONS, value);
+		break;
 	default:
 		throw std::runtime_error("Unknown integer parameter");
 	}
@@ -768,6 +806,7 @@ void XPRSModel::rowNames(std::vector<std::string> &names, int first, int last) c
 void XPRSModel::addEmptyCol(const std::string &name, char ctype, double lb, double ub, double obj)
 {
 	DOMINIQS_ASSERT(prob);
+	matrixChanged();
 	int matbeg = 0;
 	XPRS_CALL(XPRSaddcols, prob, 1, 0, &obj, &matbeg, nullptr, nullptr, &lb, &ub);
 
@@ -785,6 +824,7 @@ void XPRSModel::addCol(const std::string &name, const int *idx, const double *va
 {
 	DOMINIQS_ASSERT(prob);
 	DOMINIQS_ASSERT(cnt && idx && val);
+	matrixChanged();
 
 	int matbeg = 0;
 	XPRS_CALL(XPRSaddcols, prob, 1, cnt, &obj, &matbeg, idx, val, &lb, &ub);
@@ -802,6 +842,7 @@ void XPRSModel::addCol(const std::string &name, const int *idx, const double *va
 void XPRSModel::addRow(const std::string &name, const int *idx, const double *val, int cnt, char sense, double rhs, double rngval)
 {
 	DOMINIQS_ASSERT(prob);
+	matrixChanged();
 
 	int matbeg = 0;
 	XPRS_CALL(XPRSaddrows, prob, 1, cnt, &sense, &rhs, &rngval, &matbeg, idx, val);
@@ -815,6 +856,7 @@ void XPRSModel::delRow(int ridx)
 {
 	DOMINIQS_ASSERT(prob);
 	DOMINIQS_ASSERT((ridx >= 0) && (ridx < nrows()));
+	matrixChanged();
 	XPRS_CALL(XPRSdelrows, prob, 1, &ridx);
 }
 
@@ -822,6 +864,7 @@ void XPRSModel::delCol(int cidx)
 {
 	DOMINIQS_ASSERT(prob);
 	DOMINIQS_ASSERT((cidx >= 0) && (cidx < ncols()));
+	matrixChanged();
 	XPRS_CALL(XPRSdelcols, prob, 1, &cidx);
 }
 
@@ -831,6 +874,7 @@ void XPRSModel::delRows(int first, int last)
 	DOMINIQS_ASSERT((first >= 0) && (first < nrows()));
 	DOMINIQS_ASSERT((last >= 0) && (last < nrows()));
 	DOMINIQS_ASSERT(first <= last);
+	matrixChanged();
 	int count = last - first + 1;
 	std::vector<int> idx(count);
 	std::iota(idx.begin(), idx.end(), first);
@@ -843,6 +887,7 @@ void XPRSModel::delCols(int first, int last)
 	DOMINIQS_ASSERT((first >= 0) && (first < ncols()));
 	DOMINIQS_ASSERT((last >= 0) && (last < ncols()));
 	DOMINIQS_ASSERT(first <= last);
+	matrixChanged();
 	int count = last - first + 1;
 	std::vector<int> idx(count);
 	std::iota(idx.begin(), idx.end(), first);
@@ -893,6 +938,13 @@ void XPRSModel::ubs(int cnt, const int *cols, const double *values)
 	XPRS_CALL(XPRSchgbounds, prob, cnt, cols, &lu[0], values);
 }
 
+void XPRSModel::rhs(int cnt, const int *rows, const double *values)
+{
+	DOMINIQS_ASSERT(prob);
+	matrixChanged();
+	XPRS_CALL(XPRSchgrhs, prob, cnt, rows, values);
+}
+
 void XPRSModel::fixCol(int cidx, double val)
 {
 	DOMINIQS_ASSERT(prob);
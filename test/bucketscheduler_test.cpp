@@ -0,0 +1,107 @@
+/**
+ * @file bucketscheduler_test.cpp
+ * @brief Unit tests of the adaptive time budget of the Kernel Pump buckets
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include "kernelpump/bucketscheduler.h"
+
+#include "testing.h"
+
+using namespace dominiqs;
+
+static BucketProgress progress(bool lpFeasible, double startDist, double endDist, double time, int iterations, int cycles)
+{
+	BucketProgress p;
+	p.lpFeasible = lpFeasible;
+	p.startDist = startDist;
+	p.endDist = endDist;
+	p.time = time;
+	p.iterations = iterations;
+	p.cycles = cycles;
+	return p;
+}
+
+static void testFairShare()
+{
+	BucketScheduler s;
+	s.setup(2.0, 10, 0.05);
+	// nothing observed yet: even split
+	CHECK_NEAR(s.budget(100.0, 4), 25.0);
+	// the last bucket gets all the time left
+	CHECK_NEAR(s.budget(100.0, 1), 100.0);
+	CHECK_NEAR(s.budget(-1.0, 4), 0.0);
+}
+
+static void testImproving()
+{
+	BucketScheduler s;
+	s.setup(2.0, 10, 0.05);
+	s.record(progress(true, 10.0, 5.0, 1.0, 10, 0));
+	CHECK(s.isImproving());
+	CHECK(!s.isCycling());
+	CHECK_NEAR(s.timePerIteration(), 0.1);
+	// fair * boost
+	CHECK_NEAR(s.budget(100.0, 4), 50.0);
+	CHECK_NEAR(s.budget(100.0, 10), 20.0);
+	// capped so that the other bucket keeps fair / boost
+	CHECK_NEAR(s.budget(100.0, 2), 75.0);
+	s.setup(4.0, 10, 0.05);
+	CHECK_NEAR(s.budget(100.0, 10), 40.0);
+	CHECK_NEAR(s.budget(100.0, 2), 87.5);
+}
+
+static void testCycling()
+{
+	BucketScheduler s;
+	s.setup(2.0, 10, 0.05);
+	// improvement below the threshold, half of the iterations cycled
+	s.record(progress(true, 10.0, 9.9, 1.0, 10, 5));
+	CHECK(!s.isImproving());
+	CHECK(s.isCycling());
+	CHECK_NEAR(s.budget(100.0, 4), 12.5);
+}
+
+static void testMinIterations()
+{
+	BucketScheduler s;
+	s.setup(2.0, 10, 0.05);
+	// 10s per iteration: 10 iterations need 100s, capped at 100 - 3 * 25 / 2
+	s.record(progress(true, 10.0, 10.0, 100.0, 10, 0));
+	CHECK(!s.isImproving());
+	CHECK(!s.isCycling());
+	CHECK_NEAR(s.budget(100.0, 4), 62.5);
+	// smoothed time per iteration
+	s.record(progress(true, 10.0, 10.0, 20.0, 10, 0));
+	CHECK_NEAR(s.timePerIteration(), 6.0);
+	CHECK_NEAR(s.budget(100.0, 4), 60.0);
+}
+
+static void testLpInfeasible()
+{
+	BucketScheduler s;
+	s.setup(2.0, 0, 0.05);
+	s.record(progress(true, 10.0, 1.0, 1.0, 10, 0));
+	CHECK(s.isImproving());
+	// a bucket failing at the first LP resets the trend
+	s.record(progress(false, 1.0, 1.0, 0.5, 0, 0));
+	CHECK(!s.isImproving());
+	CHECK(!s.isCycling());
+	CHECK_NEAR(s.timePerIteration(), 0.1);
+	CHECK_NEAR(s.budget(100.0, 4), 25.0);
+	s.reset();
+	CHECK(s.timePerIteration() < 0.0);
+}
+
+int main()
+{
+	testFairShare();
+	testImproving();
+	testCycling();
+	testMinIterations();
+	testLpInfeasible();
+	return kptest::report();
+}
@@ -0,0 +1,157 @@
+/**
+ * @file intcache_test.cpp
+ * @brief Unit tests of the cache of integer points used for cycle detection
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <vector>
+#include <memory>
+
+#include <utils/floats.h>
+#include <utils/randgen.h>
+
+#include "kernelpump/intcache.h"
+
+#include "testing.h"
+
+using namespace dominiqs;
+
+/** x0, x2, x3 binary, x1 continuous, x4 general integer in [-5,5], x5 free general integer */
+static PointLayoutPtr makeLayout()
+{
+	std::vector<double> lb = {0, 0, 0, 0, -5, -INFBOUND};
+	std::vector<double> ub = {1, 10, 1, 1, 5, INFBOUND};
+	return std::make_shared<PointLayout>(6, std::vector<int>{0, 2, 3}, std::vector<int>{4, 5}, lb, ub);
+}
+
+static void testPoints()
+{
+	PointLayoutPtr layout = makeLayout();
+	std::vector<double> x = {1, 3.5, 0, 1, 2, -7};
+	IntegerPoint p(layout, x);
+	CHECK_NEAR(p[0], 1.0);
+	CHECK_NEAR(p[2], 0.0);
+	CHECK_NEAR(p[4], 2.0);
+	CHECK_NEAR(p[5], -7.0);
+	std::vector<double> y(6, 0.0);
+	p.unpack(y);
+	CHECK_NEAR(y[3], 1.0);
+	CHECK_NEAR(y[5], -7.0);
+	// points differing only in a general integer
+	std::vector<double> z = x;
+	z[4] = 3;
+	IntegerPoint q(layout, z);
+	CHECK(p.equals(q, true));
+	CHECK(!p.equals(q, false));
+}
+
+static void testLookup()
+{
+	PointLayoutPtr layout = makeLayout();
+	IntegerPointCache cache;
+	cache.setup(layout, false, 0.01, 0);
+	std::vector<double> x = {1, 0.3, 0, 1, 2, 0};
+	std::vector<double> y = {1, 0.7, 1, 1, 2, 0};
+	CHECK(!cache.sameAsLast(x));
+	cache.push_front(0.9, x);
+	CHECK(cache.sameAsLast(x));
+	CHECK(!cache.sameAsLast(y));
+	// continuous variables do not matter
+	std::vector<double> x2 = x;
+	x2[1] = 9.0;
+	CHECK(cache.sameAsLast(x2));
+	// alphas compared within alphaDist
+	CHECK(cache.contains(0.9, x));
+	CHECK(cache.contains(0.895, x));
+	CHECK(!cache.contains(0.85, x));
+	CHECK(!cache.contains(0.9, y));
+	cache.push_front(0.8, y);
+	CHECK(cache.size() == 2);
+	CHECK(cache.contains(0.9, x));
+	CHECK(!cache.sameAsLast(x));
+	// general integers are ignored in stage 1 only
+	std::vector<double> w = x;
+	w[4] = -3;
+	CHECK(!cache.contains(0.9, w));
+	cache.setup(layout, true, 0.01, 0);
+	cache.push_front(0.9, x);
+	CHECK(cache.contains(0.9, w));
+}
+
+static void testIncrementalHash()
+{
+	PointLayoutPtr layout = makeLayout();
+	for (bool ignoreGenerals : {true, false})
+	{
+		IntegerPointCache incremental;
+		IntegerPointCache full;
+		incremental.setup(layout, ignoreGenerals, 0.01, 0);
+		full.setup(layout, ignoreGenerals, 0.01, 0);
+		STLRandGen rnd;
+		rnd.setSeed(7);
+		std::vector<double> x(6, 0.0);
+		std::vector<int> changed;
+		for (int itr = 0; itr < 200; itr++)
+		{
+			changed.clear();
+			int n = 1 + rnd(3);
+			for (int k = 0; k < n; k++)
+			{
+				int j = rnd(6);
+				if ((j == 4) || (j == 5))
+					x[j] = (double)rnd(11) - 5.0;
+				else if (j == 1)
+					x[j] = rnd(100) / 10.0;
+				else
+					x[j] = (double)rnd(2);
+				changed.push_back(j);
+			}
+			CHECK(incremental.hash(x, changed) == full.hash(x));
+		}
+	}
+}
+
+static void testEviction()
+{
+	PointLayoutPtr layout = makeLayout();
+	IntegerPointCache cache;
+	int capacity = 2;
+	cache.setup(layout, false, 0.01, capacity);
+	std::vector<double> x(6, 0.0);
+	// more distinct points than the cache and its history can hold
+	int total = capacity * (IntegerPointCache::HISTORY_PER_POINT + 1) + 5;
+	for (int k = 0; k < total; k++)
+	{
+		x[5] = k;
+		cache.push_front(0.5, x);
+	}
+	CHECK(cache.size() == (std::size_t)capacity);
+	CHECK(cache.historySize() == (std::size_t)capacity * IntegerPointCache::HISTORY_PER_POINT);
+	// recent evicted point: found in the history
+	x[5] = total - capacity - 1;
+	CHECK(cache.contains(0.5, x));
+	CHECK(cache.historyHits() == 1);
+	CHECK(!cache.contains(0.7, x));
+	// oldest points: forgotten
+	x[5] = 0;
+	CHECK(!cache.contains(0.5, x));
+	// cached points
+	x[5] = total - 1;
+	CHECK(cache.contains(0.5, x));
+	CHECK(cache.historyHits() == 1);
+	cache.clear();
+	CHECK(cache.empty());
+	CHECK(cache.historySize() == 0);
+}
+
+int main()
+{
+	testPoints();
+	testLookup();
+	testIncrementalHash();
+	testEviction();
+	return kptest::report();
+}
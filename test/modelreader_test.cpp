@@ -0,0 +1,163 @@
+/**
+ * @file modelreader_test.cpp
+ * @brief Unit tests of the native MPS/LP reader
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <utils/floats.h>
+
+#include "kernelpump/modelreader.h"
+
+#include "testing.h"
+
+using namespace dominiqs;
+
+static const char *MPS_MODEL =
+	"NAME          small\n"
+	"OBJSENSE\n"
+	"    MAX\n"
+	"ROWS\n"
+	" N  obj\n"
+	" L  c1\n"
+	" G  c2\n"
+	" E  c3\n"
+	"COLUMNS\n"
+	"    MARKER                 'MARKER'                 'INTORG'\n"
+	"    x         obj       1.0          c1        1.0\n"
+	"    x         c3        1.0\n"
+	"    y         obj       2.0          c2        1.0\n"
+	"    MARKER                 'MARKER'                 'INTEND'\n"
+	"    z         obj       -1.0         c1        2.0\n"
+	"    z         c2        3.0          c3        -1.0\n"
+	"RHS\n"
+	"    rhs       obj       -5.0\n"
+	"    rhs       c1        4.0          c2        1.0\n"
+	"    rhs       c3        2.0\n"
+	"RANGES\n"
+	"    rng       c1        3.0          c3        -1.5\n"
+	"BOUNDS\n"
+	" UP bnd       x         1\n"
+	" UP bnd       y         7\n"
+	" MI bnd       z\n"
+	"ENDATA\n";
+
+/** coefficient of column j in row i (from the row-major copy) */
+static double coef(const ModelData &data, int i, int j)
+{
+	double v = 0.0;
+	for (int k = data.rowBeg[i]; k < data.rowBeg[i + 1]; k++)
+		if (data.rowIdx[k] == j)
+			v += data.rowVal[k];
+	return v;
+}
+
+static void checkTranspose(const ModelData &data)
+{
+	CHECK((int)data.colBeg.size() == data.ncols() + 1);
+	CHECK((int)data.colIdx.size() == data.nnz());
+	for (int j = 0; j < data.ncols(); j++)
+		for (int k = data.colBeg[j]; k < data.colBeg[j + 1]; k++)
+			CHECK_NEAR(data.colVal[k], coef(data, data.colIdx[k], j));
+}
+
+static void testMPS()
+{
+	std::string filename = kptest::tempFile("small.mps");
+	kptest::writeFile(filename, MPS_MODEL);
+	ModelData data;
+	readModelFile(filename, data);
+	CHECK(data.name == "small");
+	CHECK(data.objSense == -1);
+	CHECK_NEAR(data.objOffset, 5.0);
+	CHECK(data.nrows() == 3);
+	CHECK(data.ncols() == 3);
+	CHECK(data.nnz() == 6);
+	CHECK(data.colNames[0] == "x");
+	CHECK(data.rowNames[2] == "c3");
+	// integer with bounds [0,1] is binary
+	CHECK(data.ctype[0] == 'B');
+	CHECK(data.ctype[1] == 'I');
+	CHECK(data.ctype[2] == 'C');
+	CHECK_NEAR(data.ub[1], 7.0);
+	CHECK(data.lb[2] <= -INFBOUND);
+	CHECK_NEAR(data.obj[2], -1.0);
+	CHECK_NEAR(coef(data, 1, 2), 3.0);
+	// ranged rows in solver convention [rhs,rhs+range]
+	CHECK(data.sense[0] == 'R');
+	CHECK_NEAR(data.rhs[0], 1.0);
+	CHECK_NEAR(data.range[0], 3.0);
+	CHECK(data.sense[1] == 'G');
+	CHECK(data.sense[2] == 'R');
+	CHECK_NEAR(data.rhs[2], 0.5);
+	CHECK_NEAR(data.range[2], 1.5);
+	checkTranspose(data);
+}
+
+static const char *LP_MODEL =
+	"\\ a comment\n"
+	"Minimize\n"
+	" obj: 3 x + 2 y - z + 4\n"
+	"Subject To\n"
+	" c1: x + y + z <= 10\n"
+	" c2: - x + 2 z >= -2\n"
+	" c3: -3 <= y - z <= 5\n"
+	"Bounds\n"
+	" y <= 8\n"
+	" z free\n"
+	"Generals\n"
+	" y\n"
+	"Binaries\n"
+	" x\n"
+	"End\n";
+
+static void testLP()
+{
+	std::string filename = kptest::tempFile("small.lp");
+	kptest::writeFile(filename, LP_MODEL);
+	ModelData data;
+	readModelFile(filename, data);
+	CHECK(data.objSense == 1);
+	CHECK_NEAR(data.objOffset, 4.0);
+	CHECK(data.nrows() == 3);
+	CHECK(data.ncols() == 3);
+	CHECK(data.nnz() == 7);
+	CHECK(data.ctype[0] == 'B');
+	CHECK(data.ctype[1] == 'I');
+	CHECK(data.ctype[2] == 'C');
+	CHECK_NEAR(data.ub[0], 1.0);
+	CHECK_NEAR(data.ub[1], 8.0);
+	CHECK(data.lb[2] <= -INFBOUND);
+	CHECK(data.sense[0] == 'L');
+	CHECK_NEAR(data.rhs[0], 10.0);
+	CHECK(data.sense[1] == 'G');
+	CHECK_NEAR(coef(data, 1, 0), -1.0);
+	CHECK(data.sense[2] == 'R');
+	CHECK_NEAR(data.rhs[2], -3.0);
+	CHECK_NEAR(data.range[2], 8.0);
+	checkTranspose(data);
+}
+
+static void testErrors()
+{
+	ModelData data;
+	CHECK(!canReadModelFile("model.txt"));
+	CHECK(canReadModelFile("model.mps.gz"));
+	CHECK_THROWS(readModelFile(kptest::tempFile("missing.mps"), data));
+	std::string filename = kptest::tempFile("broken.mps");
+	kptest::writeFile(filename, "NAME broken\nROWS\n N obj\n L c1\nCOLUMNS\n    x c9 1.0\nENDATA\n");
+	CHECK_THROWS(readModelFile(filename, data));
+	filename = kptest::tempFile("broken.lp");
+	kptest::writeFile(filename, "Minimize\n x\nSubject To\n c1: x + <= 3\nEnd\n");
+	CHECK_THROWS(readModelFile(filename, data));
+}
+
+int main()
+{
+	testMPS();
+	testLP();
+	testErrors();
+	return kptest::report();
+}
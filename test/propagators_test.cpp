@@ -0,0 +1,240 @@
+/**
+ * @file propagators_test.cpp
+ * @brief Unit tests of the clique table and implication graph propagators
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <map>
+#include <vector>
+#include <memory>
+
+#include <propagator/prop_engine.h>
+#include <propagator/clique_propagator.h>
+#include <propagator/implication_propagator.h>
+#include <propagator/linear_propagator.h>
+
+#include "testing.h"
+
+using namespace dominiqs;
+
+static Constraint makeRow(const std::vector<int> &idx, const std::vector<double> &coef, char sense, double rhs)
+{
+	Constraint c;
+	for (unsigned int k = 0; k < idx.size(); k++)
+		c.row.push(idx[k], coef[k]);
+	c.sense = sense;
+	c.rhs = rhs;
+	return c;
+}
+
+/**
+ * x0..x5 binary, x6 integer in [0,10]
+ * x0 + x1 + x2 <= 1 (clique)
+ * x3 + x4 + x5 = 1 (partitioning clique)
+ * x0 <= x3, x1 <= x5 (implications)
+ * x6 + 5 x2 + 3 x4 <= 10 (linear)
+ */
+struct TestModel
+{
+	DomainPtr domain;
+	PropagationEngine prop;
+	std::vector<PropagatorFactoryPtr> used; //< factory that analyzed each row
+	StatePtr state;
+
+	static const std::vector<double> &baseLb()
+	{
+		static const std::vector<double> lb(7, 0.0);
+		return lb;
+	}
+	static const std::vector<double> &baseUb()
+	{
+		static const std::vector<double> ub = {1, 1, 1, 1, 1, 1, 10};
+		return ub;
+	}
+
+	TestModel(const std::vector<double> &lb = baseLb(), const std::vector<double> &ub = baseUb())
+	{
+		domain = std::make_shared<Domain>();
+		for (int j = 0; j < 6; j++)
+			domain->pushVar("x" + std::to_string(j), 'B', lb[j], ub[j]);
+		domain->pushVar("x6", 'I', lb[6], ub[6]);
+		prop.setDomain(domain);
+		// same factory order as PropagatorRounding: lowest priority value first
+		std::map<int, PropagatorFactoryPtr> factories;
+		for (PropagatorFactoryPtr fact : std::vector<PropagatorFactoryPtr>{std::make_shared<CliqueFactory>(),
+																		   std::make_shared<ImplicationFactory>(),
+																		   std::make_shared<LinearFactory>()})
+			factories[fact->getPriority()] = fact;
+		std::vector<Constraint> rows = {
+			makeRow({0, 1, 2}, {1, 1, 1}, 'L', 1),
+			makeRow({3, 4, 5}, {1, 1, 1}, 'E', 1),
+			makeRow({0, 3}, {1, -1}, 'L', 0),
+			makeRow({1, 5}, {1, -1}, 'L', 0),
+			makeRow({6, 2, 4}, {1, 5, 3}, 'L', 10),
+		};
+		for (const Constraint &c : rows)
+		{
+			PropagatorFactoryPtr by;
+			for (auto &kv : factories)
+			{
+				PropagatorPtr p = kv.second->analyze(*domain, &c);
+				if (p)
+				{
+					prop.pushPropagator(p);
+					by = kv.second;
+					break;
+				}
+			}
+			used.push_back(by);
+		}
+		state = prop.getStateMgr();
+		state->dump();
+		prop.dumpBase();
+	}
+
+	/** same steps as PropagatorRounding::updateBounds */
+	bool rebase(const std::vector<double> &lb, const std::vector<double> &ub)
+	{
+		state->restore();
+		if (!prop.rebase(lb, ub))
+			return false;
+		state->dump();
+		return true;
+	}
+
+	bool sameDomain(const TestModel &other) const
+	{
+		for (unsigned int j = 0; j < domain->size(); j++)
+		{
+			if ((domain->varLb(j) != other.domain->varLb(j)) || (domain->varUb(j) != other.domain->varUb(j)) ||
+				(domain->isVarFixed(j) != other.domain->isVarFixed(j)))
+				return false;
+		}
+		return true;
+	}
+
+	bool fixedTo(int j, double value) const { return domain->isVarFixed(j) && (domain->varLb(j) == value) && (domain->varUb(j) == value); }
+};
+
+static void testAnalyze()
+{
+	TestModel m;
+	CHECK(m.used[0] && (std::string(m.used[0]->getName()) == std::string(CliqueFactory().getName())));
+	CHECK(m.used[1] && (std::string(m.used[1]->getName()) == std::string(CliqueFactory().getName())));
+	CHECK(m.used[2] && (std::string(m.used[2]->getName()) == std::string(ImplicationFactory().getName())));
+	CHECK(m.used[3] && (std::string(m.used[3]->getName()) == std::string(ImplicationFactory().getName())));
+	CHECK(m.used[4] && (std::string(m.used[4]->getName()) == std::string(LinearFactory().getName())));
+}
+
+static void testClique()
+{
+	TestModel m;
+	// x0 = 1: clique neighbours to 0, x3 implied to 1, which closes the partitioning clique
+	CHECK(m.prop.propagate(0, 1.0));
+	CHECK(m.fixedTo(1, 0.0));
+	CHECK(m.fixedTo(2, 0.0));
+	CHECK(m.fixedTo(3, 1.0));
+	CHECK(m.fixedTo(4, 0.0));
+	CHECK(m.fixedTo(5, 0.0));
+	CHECK(!m.domain->isVarFixed(6));
+	CHECK(m.prop.getLastFixed().size() == 6);
+	m.state->restore();
+	CHECK(!m.domain->isVarFixed(1));
+	// last free variable of a partitioning clique
+	CHECK(m.prop.propagate(std::vector<int>{3, 4}, std::vector<double>{0.0, 0.0}));
+	CHECK(m.fixedTo(5, 1.0));
+	m.state->restore();
+	// x2 = 1 also tightens the linear row
+	CHECK(m.prop.propagate(2, 1.0));
+	CHECK(m.fixedTo(0, 0.0));
+	CHECK(m.fixedTo(1, 0.0));
+	CHECK(m.domain->varUb(6) == 5.0);
+}
+
+static void testImplications()
+{
+	TestModel m;
+	// x1 = 1 implies x5 = 1, then the partitioning clique fixes x3 and x4
+	CHECK(m.prop.propagate(1, 1.0));
+	CHECK(m.fixedTo(5, 1.0));
+	CHECK(m.fixedTo(3, 0.0));
+	CHECK(m.fixedTo(4, 0.0));
+	CHECK(m.fixedTo(0, 0.0));
+	m.state->restore();
+	// contrapositive: x5 = 0 implies x1 = 0
+	CHECK(m.prop.propagate(5, 0.0));
+	CHECK(m.fixedTo(1, 0.0));
+	CHECK(!m.domain->isVarFixed(0));
+	m.state->restore();
+	// x1 = 1 and x3 = 1 is infeasible (x5 = 1 and x3 = 1 in a partitioning clique)
+	CHECK(!m.prop.propagate(std::vector<int>{1, 3}, std::vector<double>{1.0, 1.0}));
+	CHECK(m.prop.failed());
+	m.state->restore();
+	CHECK(!m.prop.failed());
+	CHECK(m.prop.propagate(3, 1.0));
+	CHECK(m.fixedTo(1, 0.0));
+}
+
+/** rebasing and propagating gives the same fixings as building the propagators on the new bounds */
+static void testRebase()
+{
+	TestModel rebased;
+	std::vector<std::pair<std::vector<double>, std::vector<double>>> bounds = {
+		{{0, 0, 0, 0, 0, 0, 0}, {1, 1, 1, 1, 1, 1, 10}},
+		{{0, 0, 0, 0, 0, 0, 0}, {1, 1, 1, 0, 1, 1, 10}},  //< x3 = 0: x0 = 0
+		{{0, 0, 1, 0, 0, 0, 0}, {1, 1, 1, 1, 1, 1, 10}},  //< x2 = 1: x0 = x1 = 0, x6 <= 5
+		{{0, 1, 0, 0, 0, 0, 2}, {1, 1, 1, 1, 1, 1, 10}},  //< x1 = 1: x5 = 1 and the rest of the cliques to 0
+		{{0, 0, 0, 0, 0, 0, 0}, {1, 1, 1, 1, 0, 0, 10}},  //< x4 = x5 = 0: x3 = 1, then x1 = 0
+		{{0, 0, 0, 0, 0, 0, 3}, {1, 1, 1, 1, 1, 1, 7}},
+	};
+	for (const auto &b : bounds)
+	{
+		CHECK(rebased.rebase(b.first, b.second));
+		CHECK(rebased.prop.propagate());
+		TestModel rebuilt(b.first, b.second);
+		CHECK(rebuilt.prop.propagate());
+		CHECK(rebased.sameDomain(rebuilt));
+		// and so do the fixings from there on
+		for (int j = 0; j < 6; j++)
+		{
+			for (double value : {0.0, 1.0})
+			{
+				rebased.state->restore();
+				rebuilt.state->restore();
+				rebased.prop.propagate();
+				rebuilt.prop.propagate();
+				bool ok = rebased.prop.propagate(j, value);
+				CHECK(ok == rebuilt.prop.propagate(j, value));
+				if (ok)
+					CHECK(rebased.sameDomain(rebuilt));
+			}
+		}
+	}
+	// infeasible bounds (x1 = 1 and x3 = 1): detected by the propagation, as after a rebuild
+	std::vector<double> lb = {0, 1, 0, 1, 0, 0, 0};
+	std::vector<double> ub = {1, 1, 1, 1, 1, 1, 10};
+	CHECK(rebased.rebase(lb, ub));
+	CHECK(!rebased.prop.propagate());
+	TestModel rebuilt(lb, ub);
+	CHECK(!rebuilt.prop.propagate());
+	// and the next rebase starts over
+	CHECK(rebased.rebase(TestModel::baseLb(), TestModel::baseUb()));
+	CHECK(rebased.prop.propagate());
+	CHECK(rebased.sameDomain(TestModel()));
+	// not a tightening of the base bounds
+	ub[6] = 20;
+	lb[1] = 0;
+	CHECK(!rebased.rebase(lb, ub));
+}
+
+int main()
+{
+	testAnalyze();
+	testClique();
+	testImplications();
+	testRebase();
+	return kptest::report();
+}
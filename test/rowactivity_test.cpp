@@ -0,0 +1,153 @@
+/**
+ * @file rowactivity_test.cpp
+ * @brief Unit tests of the incremental row activities and of the jump repair
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include <utils/randgen.h>
+
+#include "kernelpump/rowactivity.h"
+#include "kernelpump/jumprepair.h"
+
+#include "testing.h"
+
+using namespace dominiqs;
+
+/**
+ * x0..x3 binary, x4 continuous in [0,5]
+ * r0: x0 + x1 + x2 <= 1
+ * r1: x0 + x3 >= 1
+ * r2: x1 - x3 = 0
+ * r3: 1 <= 2 x2 + x4 <= 3
+ */
+static ConstraintStorePtr makeStore()
+{
+	std::vector<int> rowStart = {0, 3, 5, 7, 9};
+	std::vector<int> colIdx = {0, 1, 2, 0, 3, 1, 3, 2, 4};
+	std::vector<double> coefs = {1, 1, 1, 1, 1, 1, -1, 2, 1};
+	// solver convention: ranged rows are [rhs,rhs+range]
+	return std::make_shared<ConstraintStore>(5, std::move(rowStart), std::move(colIdx), std::move(coefs),
+											 std::vector<char>{'L', 'G', 'E', 'R'}, std::vector<double>{1, 1, 0, 1},
+											 std::vector<double>{0, 0, 0, 2});
+}
+
+static const std::vector<double> LB = {0, 0, 0, 0, 0};
+static const std::vector<double> UB = {1, 1, 1, 1, 5};
+static const std::vector<char> XTYPE = {'B', 'B', 'B', 'B', 'C'};
+
+static void checkSame(const RowActivity &a, const RowActivity &b)
+{
+	CHECK(a.numViolated() == b.numViolated());
+	CHECK_NEAR(a.maxViolation(), b.maxViolation());
+	for (int i = 0; i < 4; i++)
+		CHECK_NEAR(a.activity(i), b.activity(i));
+	std::vector<int> va = a.violatedRows();
+	std::vector<int> vb = b.violatedRows();
+	std::sort(va.begin(), va.end());
+	std::sort(vb.begin(), vb.end());
+	CHECK(va == vb);
+}
+
+static void testBounds()
+{
+	RowActivity activity;
+	activity.init(makeStore());
+	CHECK(activity.upper(0) == 1.0);
+	CHECK(activity.lower(1) == 1.0);
+	CHECK((activity.lower(2) == 0.0) && (activity.upper(2) == 0.0));
+	CHECK((activity.lower(3) == 1.0) && (activity.upper(3) == 3.0));
+	// the origin violates r1 and r3
+	CHECK(!activity.isFeasible());
+	CHECK(activity.numViolated() == 2);
+	CHECK_NEAR(activity.maxViolation(), 1.0);
+	activity.set({1, 0, 0, 0, 2.5});
+	CHECK(activity.isFeasible());
+	CHECK_NEAR(activity.violation(3), -0.5);
+	activity.update(4, 4.0);
+	CHECK(!activity.isFeasible());
+	CHECK_NEAR(activity.violation(3), 1.0);
+}
+
+static void testIncremental()
+{
+	ConstraintStorePtr store = makeStore();
+	RowActivity incremental;
+	RowActivity full;
+	incremental.init(store);
+	full.init(store);
+	STLRandGen rnd;
+	rnd.setSeed(3);
+	std::vector<double> x(5, 0.0);
+	std::vector<int> changed;
+	for (int itr = 0; itr < 500; itr++)
+	{
+		changed.clear();
+		int n = 1 + rnd(3);
+		for (int k = 0; k < n; k++)
+		{
+			int j = rnd(5);
+			x[j] = (j == 4) ? rnd(50) / 10.0 : (double)rnd(2);
+			changed.push_back(j);
+		}
+		if (itr % 2)
+			incremental.update(x, changed);
+		else
+		{
+			for (int j : changed)
+				incremental.update(j, x[j]);
+		}
+		full.set(x);
+		checkSame(incremental, full);
+	}
+}
+
+static void testRepair()
+{
+	ConstraintStorePtr store = makeStore();
+	RowActivity activity;
+	activity.init(store);
+	JumpRepair repair;
+	repair.init(store, XTYPE, 1);
+	std::vector<double> x = {1, 1, 1, 1, 0};
+	activity.set(x);
+	CHECK(!activity.isFeasible());
+	bool feasible = repair.repair(x, activity, LB, UB, 100);
+	CHECK(feasible);
+	CHECK(repair.movesDone() > 0);
+	CHECK(repair.movesDone() <= 100);
+	// the activities moved along with x
+	RowActivity check;
+	check.init(store);
+	check.set(x);
+	CHECK(check.isFeasible());
+	checkSame(activity, check);
+	for (int j = 0; j < 5; j++)
+	{
+		CHECK((x[j] >= LB[j]) && (x[j] <= UB[j]));
+		if (XTYPE[j] != 'C')
+			CHECK(x[j] == 0.0 || x[j] == 1.0);
+	}
+	// a feasible point is left alone
+	int moves = repair.movesDone();
+	CHECK(repair.repair(x, activity, LB, UB, 100));
+	CHECK(repair.movesDone() == moves);
+	// no moves allowed
+	std::vector<double> y = {1, 1, 1, 1, 0};
+	activity.set(y);
+	CHECK(!repair.repair(y, activity, LB, UB, 0));
+}
+
+int main()
+{
+	testBounds();
+	testIncremental();
+	testRepair();
+	return kptest::report();
+}
@@ -0,0 +1,139 @@
+/**
+ * @file snapshot_test.cpp
+ * @brief Unit tests of the binary model snapshots (.kpbin)
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <iterator>
+#include <filesystem>
+
+#include "kernelpump/snapshot.h"
+
+#include "testing.h"
+
+using namespace dominiqs;
+
+static const char *LP_MODEL =
+	"Maximize\n"
+	" obj: x + 2 y + 3 z - 1.5\n"
+	"Subject To\n"
+	" c1: x + y + z <= 2\n"
+	" c2: 1 <= x - z <= 4\n"
+	" c3: y + 2 z = 1\n"
+	"Bounds\n"
+	" z <= 5\n"
+	"Generals\n"
+	" z\n"
+	"Binaries\n"
+	" x y\n"
+	"End\n";
+
+static bool sameModel(const ModelData &a, const ModelData &b)
+{
+	bool same = (a.name == b.name) && (a.objSense == b.objSense) && (a.objOffset == b.objOffset) && (a.objName == b.objName) &&
+				(a.obj == b.obj) && (a.lb == b.lb) && (a.ub == b.ub) && (a.ctype == b.ctype) &&
+				(a.sense == b.sense) && (a.rhs == b.rhs) && (a.range == b.range) &&
+				(a.rowBeg == b.rowBeg) && (a.rowIdx == b.rowIdx) && (a.rowVal == b.rowVal) &&
+				(a.colBeg == b.colBeg) && (a.colIdx == b.colIdx) && (a.colVal == b.colVal) &&
+				(a.colNames.size() == b.colNames.size()) && (a.rowNames.size() == b.rowNames.size());
+	for (int j = 0; same && (j < a.colNames.size()); j++)
+		same = (a.colNames[j] == b.colNames[j]);
+	for (int i = 0; same && (i < a.rowNames.size()); i++)
+		same = (a.rowNames[i] == b.rowNames[i]);
+	return same;
+}
+
+static std::string readAll(const std::string &filename)
+{
+	std::ifstream in(filename, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void testRoundTrip()
+{
+	std::string model = kptest::tempFile("snap.lp");
+	std::string snap = kptest::tempFile("snap.kpbin");
+	kptest::writeFile(model, LP_MODEL);
+	ModelData parsed;
+	readModelFile(model, parsed);
+	uint64_t hash = fileContentHash(model);
+	writeSnapshot(snap, parsed, hash);
+	ModelData loaded;
+	CHECK(readSnapshot(snap, loaded, hash));
+	CHECK(sameModel(parsed, loaded));
+	// a snapshot of another version of the model is stale
+	CHECK(!readSnapshot(snap, loaded, hash + 1));
+	CHECK(loaded.ncols() == 0);
+	CHECK(!readSnapshot(kptest::tempFile("missing.kpbin"), loaded, hash));
+}
+
+static void testCorrupt()
+{
+	std::string model = kptest::tempFile("corrupt.lp");
+	std::string snap = kptest::tempFile("corrupt.kpbin");
+	kptest::writeFile(model, LP_MODEL);
+	ModelData parsed;
+	readModelFile(model, parsed);
+	uint64_t hash = fileContentHash(model);
+	writeSnapshot(snap, parsed, hash);
+	std::string good = readAll(snap);
+	ModelData loaded;
+	// truncated
+	kptest::writeFile(snap, good.substr(0, good.size() - 8));
+	CHECK(!readSnapshot(snap, loaded, hash));
+	CHECK(loaded.ncols() == 0);
+	// wrong magic
+	std::string bad = good;
+	bad[0] = 'X';
+	kptest::writeFile(snap, bad);
+	CHECK(!readSnapshot(snap, loaded, hash));
+	// garbage after a valid header
+	bad = good;
+	for (std::size_t k = 64; k < bad.size(); k++)
+		bad[k] = (char)0xff;
+	kptest::writeFile(snap, bad);
+	CHECK(!readSnapshot(snap, loaded, hash));
+	CHECK(loaded.nrows() == 0);
+	// column indexes out of range
+	bad = good;
+	std::size_t rowIdxBytes = parsed.rowIdx.size() * sizeof(int);
+	std::size_t pos = bad.find(std::string((const char *)parsed.rowIdx.data(), rowIdxBytes));
+	CHECK(pos != std::string::npos);
+	if (pos != std::string::npos)
+	{
+		int outOfRange = parsed.ncols() + 10;
+		bad.replace(pos, sizeof(int), (const char *)&outOfRange, sizeof(int));
+		kptest::writeFile(snap, bad);
+		CHECK(!readSnapshot(snap, loaded, hash));
+	}
+}
+
+static void testCached()
+{
+	std::string model = kptest::tempFile("cached.lp");
+	std::string snap = kptest::tempFile("cached.kpbin");
+	std::filesystem::remove(snap);
+	kptest::writeFile(model, LP_MODEL);
+	ModelData first;
+	CHECK(!readModelCached(model, snap, first));
+	CHECK(std::filesystem::exists(snap));
+	ModelData second;
+	CHECK(readModelCached(model, snap, second));
+	CHECK(sameModel(first, second));
+	// editing the model invalidates the snapshot
+	kptest::writeFile(model, "\\ edited\n" + std::string(LP_MODEL));
+	ModelData third;
+	CHECK(!readModelCached(model, snap, third));
+	CHECK(sameModel(first, third));
+}
+
+int main()
+{
+	testRoundTrip();
+	testCorrupt();
+	testCached();
+	return kptest::report();
+}
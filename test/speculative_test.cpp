@@ -0,0 +1,178 @@
+/**
+ * @file speculative_test.cpp
+ * @brief Unit tests of what lets a speculative pump stand in for the serial one:
+ * the iteration budget check and the reseeding of the random choices
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#include <vector>
+#include <memory>
+
+#include <utils/fileconfig.h>
+#include <utils/randgen.h>
+
+#include "kernelpump/feaspump.h"
+#include "kernelpump/ranking.h"
+
+#include "testing.h"
+
+using namespace dominiqs;
+
+struct PumpRun
+{
+	int stage1 = 0;
+	int stage2 = 0;
+	bool solved = false;
+	bool operator==(const PumpRun &other) const { return (stage1 == other.stage1) && (stage2 == other.stage2) && (solved == other.solved); }
+};
+
+static bool sameBudget(const IterBudget &a, const IterBudget &b)
+{
+	return (a.stage1 == b.stage1) && (a.stage2 == b.stage2) && (a.total == b.total);
+}
+
+/**
+ * Iterations of a pump() call as FeasibilityPump::pumpLoop counts them: stage 1 stops after stop1 iterations
+ * (with a solution if solved1), stage 2 after stop2, unless a limit comes first. Charges the budget.
+ */
+static PumpRun pump(IterBudget &budget, int stop1, bool solved1, int stop2)
+{
+	PumpRun run;
+	while ((run.stage1 < stop1) && (run.stage1 < budget.stage1) && (run.stage1 < budget.total))
+		run.stage1++;
+	budget.stage1 = std::max(0, budget.stage1 - run.stage1);
+	budget.total = std::max(0, budget.total - run.stage1);
+	if ((run.stage1 == stop1) && solved1)
+	{
+		run.solved = true;
+		return run;
+	}
+	while ((run.stage2 < stop2) && (run.stage2 < budget.stage2) && (run.stage2 < budget.total))
+		run.stage2++;
+	budget.stage2 = std::max(0, budget.stage2 - run.stage2);
+	budget.total = std::max(0, budget.total - run.stage2);
+	return run;
+}
+
+/** a run given a larger budget is accepted only if it is the run of the actual budget, which is then charged as by the pump */
+static void testBudget()
+{
+	STLRandGen rnd;
+	rnd.setSeed(11);
+	int accepted = 0;
+	int acceptedLarger = 0;
+	for (int itr = 0; itr < 20000; itr++)
+	{
+		// budget of the bucket once its turn comes, and the (larger) one at launch time
+		IterBudget actual{(int)rnd(30), (int)rnd(30), (int)rnd(50)};
+		IterBudget given = actual;
+		if (rnd(4))
+		{
+			given.stage1 += rnd(3) ? 0 : rnd(10);
+			given.stage2 += rnd(3) ? 0 : rnd(10);
+			given.total += rnd(2) ? 0 : rnd(20);
+		}
+		int stop1 = 1 + rnd(40);
+		bool solved1 = (rnd(3) == 0);
+		int stop2 = 1 + rnd(40);
+		IterBudget speculative = given;
+		PumpRun run = pump(speculative, stop1, solved1, stop2);
+		IterBudget used = given.used(speculative);
+		CHECK(used.total == used.stage1 + used.stage2);
+		// the budget the pump started from is always the one of the run
+		CHECK(given.sameRun(used, given));
+		if (!given.sameRun(used, actual))
+			continue;
+		accepted++;
+		if (!sameBudget(given, actual))
+			acceptedLarger++;
+		IterBudget serial = actual;
+		CHECK(pump(serial, stop1, solved1, stop2) == run);
+		CHECK(sameBudget(actual.charged(used), serial));
+	}
+	CHECK(accepted > 0);
+	CHECK(acceptedLarger > 0);
+	// a run that stopped on a limit of the larger budget
+	IterBudget given{10, 10, 15};
+	IterBudget actual{10, 10, 12};
+	IterBudget speculative = given;
+	pump(speculative, 5, false, 20);
+	IterBudget used = given.used(speculative);
+	CHECK((used.stage1 == 5) && (used.stage2 == 10) && (used.total == 15));
+	CHECK(!given.sameRun(used, actual));
+	// the same limit in both budgets
+	CHECK(given.sameRun(used, IterBudget{10, 10, 15}));
+	// limits not reached: the run does not depend on them
+	speculative = given;
+	pump(speculative, 3, false, 4);
+	used = given.used(speculative);
+	CHECK(given.sameRun(used, actual));
+	CHECK(sameBudget(actual.charged(used), IterBudget{7, 6, 5}));
+	// all used up
+	CHECK(!given.sameRun(IterBudget{0, 0, 0}, IterBudget{0, 0, 0}));
+	CHECK(sameBudget(actual.charged(IterBudget{20, 20, 20}), IterBudget{0, 0, 0}));
+}
+
+/** x0..x5 binary, x6..x7 integer in [0,10] */
+static DomainPtr makeDomain()
+{
+	DomainPtr domain = std::make_shared<Domain>();
+	for (int j = 0; j < 6; j++)
+		domain->pushVar("x" + std::to_string(j), 'B', 0.0, 1.0);
+	for (int j = 6; j < 8; j++)
+		domain->pushVar("x" + std::to_string(j), 'I', 0.0, 10.0);
+	return domain;
+}
+
+/** order of the variables as a rounder fixes them (next() returns the first variable not fixed yet) */
+static std::vector<int> order(Ranker &ranker, Domain &domain, const std::vector<double> &x)
+{
+	std::vector<int> ranked;
+	domain.mark();
+	ranker.setCurrentState(x);
+	for (int j = ranker.next(); j >= 0; j = ranker.next())
+	{
+		ranked.push_back(j);
+		domain.resetBounds(j, domain.varLb(j), domain.varLb(j));
+	}
+	domain.undoToMark();
+	return ranked;
+}
+
+/** a ranker used on earlier buckets and reseeded ranks as a fresh one with that seed */
+template <typename RankerT>
+static void testRankerReseed(bool diversified)
+{
+	DomainPtr domain = makeDomain();
+	std::vector<double> x = {0.5, 0.2, 1.0, 0.7, 0.0, 0.4, 3.5, 7.0};
+	uint64_t bucketSeed = 42;
+	gConfig().set<uint64_t>("seed", 1);
+	RankerT serial;
+	serial.readConfig();
+	if (diversified)
+		serial.diversify(false, 1);
+	serial.init(domain, false);
+	for (int k = 0; k < 5; k++)
+		order(serial, *domain, x);
+	serial.init(domain, false);
+	serial.reseed(bucketSeed);
+	gConfig().set<uint64_t>("seed", bucketSeed);
+	RankerT fresh;
+	fresh.readConfig();
+	if (diversified)
+		fresh.diversify(false, bucketSeed);
+	fresh.init(domain, false);
+	for (int k = 0; k < 5; k++)
+		CHECK(order(serial, *domain, x) == order(fresh, *domain, x));
+}
+
+int main()
+{
+	testBudget();
+	testRankerReseed<RandomRanker>(false);
+	testRankerReseed<FractionalityRanker>(true);
+	return kptest::report();
+}
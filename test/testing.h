@@ -0,0 +1,97 @@
+/**
+ * @file testing.h
+ * @brief Check macros and helpers shared by the unit tests
+ *
+ * A failed check reports its location and is counted, the test goes on:
+ * main() returns kptest::report(), which is nonzero if any check failed.
+ *
+ * @author Domenico Salvagnin <dominiqs at gmail dot com>
+ * @author Gioni Mexi <gionimexi at gmail dot com>
+ * 2023
+ */
+
+#ifndef KP_TESTING_H
+#define KP_TESTING_H
+
+#include <cmath>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+namespace kptest
+{
+
+	inline int &failures()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	inline void fail(const char *file, int line, const std::string &what)
+	{
+		std::cerr << file << ":" << line << ": " << what << std::endl;
+		failures()++;
+	}
+
+	/** outcome of the test program, to be returned by main() */
+	inline int report()
+	{
+		if (failures())
+		{
+			std::cerr << failures() << " check(s) failed" << std::endl;
+			return 1;
+		}
+		std::cout << "all checks passed" << std::endl;
+		return 0;
+	}
+
+	/** path of a scratch file in the temporary directory (tests must use distinct names) */
+	inline std::string tempFile(const std::string &name)
+	{
+		std::filesystem::path dir = std::filesystem::temp_directory_path() / "kptest";
+		std::filesystem::create_directories(dir);
+		return (dir / name).string();
+	}
+
+	inline void writeFile(const std::string &filename, const std::string &contents)
+	{
+		std::ofstream out(filename, std::ios::binary);
+		out << contents;
+	}
+
+} // namespace kptest
+
+#define CHECK(condition)                                                \
+	do                                                                  \
+	{                                                                   \
+		if (!(condition))                                               \
+			kptest::fail(__FILE__, __LINE__, #condition " failed");     \
+	} while (false)
+
+#define CHECK_NEAR(actual, expected)                                                                                    \
+	do                                                                                                                  \
+	{                                                                                                                   \
+		double kpActual = (actual);                                                                                     \
+		double kpExpected = (expected);                                                                                 \
+		if (!(std::fabs(kpActual - kpExpected) <= 1e-9))                                                                \
+			kptest::fail(__FILE__, __LINE__, #actual " = " + std::to_string(kpActual) + ", expected " + std::to_string(kpExpected)); \
+	} while (false)
+
+#define CHECK_THROWS(statement)                                                    \
+	do                                                                             \
+	{                                                                              \
+		bool kpThrown = false;                                                     \
+		try                                                                        \
+		{                                                                          \
+			statement;                                                             \
+		}                                                                          \
+		catch (const std::exception &)                                             \
+		{                                                                          \
+			kpThrown = true;                                                       \
+		}                                                                          \
+		if (!kpThrown)                                                             \
+			kptest::fail(__FILE__, __LINE__, #statement " did not throw");         \
+	} while (false)
+
+#endif /* KP_TESTING_H */